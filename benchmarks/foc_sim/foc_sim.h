@@ -0,0 +1,120 @@
+/****************************************************************************
+ * apps/benchmarks/foc_sim/foc_sim.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_BENCHMARKS_FOC_SIM_FOC_SIM_H
+#define __APPS_BENCHMARKS_FOC_SIM_FOC_SIM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Simulated motor */
+
+#define FOC_SIM_POLES        (7)
+#define FOC_SIM_RES          (0.11f)     /* [ohm] */
+#define FOC_SIM_IND          (0.0002f)   /* [H] */
+#define FOC_SIM_INER         (0.0001f)   /* [kg*m^2] */
+#define FOC_SIM_FLUX         (0.001f)    /* [Wb] */
+#define FOC_SIM_LOAD         (0.0f)      /* [Nm] */
+#define FOC_SIM_VBUS         (12.0f)     /* [V] */
+#define FOC_SIM_IPHASE_ADC   (0.001f)    /* [A/LSB] */
+
+/* Controller */
+
+#define FOC_SIM_PER          (1.0f / CONFIG_BENCHMARK_FOC_SIM_FREQ)
+#define FOC_SIM_PWM_DUTY_MAX (0.95f)
+#define FOC_SIM_CURR_BW      (2000.0f)   /* Current loop bandwidth [rad/s] */
+#define FOC_SIM_VEL_BW       (50.0f)     /* Velocity loop bandwidth [rad/s] */
+#define FOC_SIM_VEL_PRESCALER (10)       /* Velocity loop prescaler */
+#define FOC_SIM_VEL_ACC      (1000.0f)   /* Velocity ramp [rad/s^2] */
+#define FOC_SIM_VEL_THR      (1.0f)      /* Velocity ramp threshold */
+#define FOC_SIM_IQ_MAX       (2.0f)      /* Torque current limit [A] */
+
+/* Current PI controller gains */
+
+#define FOC_SIM_CURR_KP      (FOC_SIM_IND * FOC_SIM_CURR_BW)
+#define FOC_SIM_CURR_KI      (FOC_SIM_RES * FOC_SIM_CURR_BW * FOC_SIM_PER)
+
+/* Velocity PI controller gains. The plant gain from Iq to the electrical
+ * acceleration is 1.5 * p^2 * flux / J.
+ */
+
+#define FOC_SIM_VEL_KP       (FOC_SIM_VEL_BW * FOC_SIM_INER /       \
+                              (1.5f * FOC_SIM_POLES * FOC_SIM_POLES * \
+                               FOC_SIM_FLUX))
+#define FOC_SIM_VEL_KI       (FOC_SIM_VEL_KP * FOC_SIM_VEL_BW / 2.0f * \
+                              FOC_SIM_PER * FOC_SIM_VEL_PRESCALER)
+
+/****************************************************************************
+ * Public Type Definition
+ ****************************************************************************/
+
+/* Simulation configuration */
+
+struct foc_sim_cfg_s
+{
+  float time;                   /* Simulated time [s] */
+  float vel;                    /* Velocity setpoint [rad/s] */
+};
+
+/* Simulation results */
+
+struct foc_sim_res_s
+{
+  uint32_t steps;               /* Simulated steps */
+  uint64_t ticks;               /* Controller perf ticks in total */
+  uint32_t ticks_max;           /* Controller perf ticks max */
+  float    vel;                 /* Final velocity [rad/s] */
+  float    vel_err;             /* Max velocity error in the second half */
+  float    ang_err;             /* Max observer angle error in the second
+                                 * half [rad] */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_INDUSTRY_FOC_FLOAT
+/****************************************************************************
+ * Name: foc_sim_f32
+ ****************************************************************************/
+
+int foc_sim_f32(FAR struct foc_sim_cfg_s *cfg, FAR struct foc_sim_res_s *res);
+#endif
+
+#ifdef CONFIG_INDUSTRY_FOC_FIXED16
+/****************************************************************************
+ * Name: foc_sim_b16
+ ****************************************************************************/
+
+int foc_sim_b16(FAR struct foc_sim_cfg_s *cfg, FAR struct foc_sim_res_s *res);
+#endif
+
+#endif /* __APPS_BENCHMARKS_FOC_SIM_FOC_SIM_H */
@@ -0,0 +1,505 @@
+/****************************************************************************
+ * apps/benchmarks/foc_sim/foc_sim_b16.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <dspb16.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "industry/foc/foc_common.h"
+#include "industry/foc/fixed16/foc_angle.h"
+#include "industry/foc/fixed16/foc_handler.h"
+#include "industry/foc/fixed16/foc_model.h"
+#include "industry/foc/fixed16/foc_ramp.h"
+#include "industry/foc/fixed16/foc_velocity.h"
+
+#include "foc_sim.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The motor and the controller period are quantized to 1/65536 in
+ * fixed16, which is coarse for the small constants of this motor:
+ *
+ *   - FOC_SIM_PER  (1e-4 s at 10 kHz) is 6.55 LSB, off by up to 8.5%
+ *   - FOC_SIM_INER (1e-4 kg*m^2)      is 6.55 LSB, off by up to 8.5%
+ *   - FOC_SIM_IND  (2e-4 H)           is 13.1 LSB, off by up to 0.8%
+ *   - FOC_SIM_FLUX (1e-3 Wb)          is 65.5 LSB, off by up to 0.8%
+ *
+ * The same rounded values are used by the model and the controller, so the
+ * loop stays consistent, but it simulates a slightly different motor at a
+ * slightly different rate than the float variant. Compare the fixed16
+ * results with the float ones for timing and convergence only, not for
+ * exact trajectories.
+ */
+
+#define FOC_SIM_PER_B16 ftob16(FOC_SIM_PER)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Simulated motor controller */
+
+struct foc_sim_b16_s
+{
+  foc_handler_b16_t             handler;
+  foc_model_b16_t               model;
+  struct foc_model_state_b16_s  model_state;
+  struct foc_state_b16_s        foc_state;
+  struct motor_phy_params_b16_s phy;
+  struct foc_ramp_b16_s         ramp;
+  pid_controller_b16_t          vel_pi;
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  foc_angle_b16_t               smo;
+#endif
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  foc_velocity_b16_t            veldiv;
+#endif
+  b16_t                         current[CONFIG_MOTOR_FOC_PHASES];
+  dq_frame_b16_t                dq_ref;
+  dq_frame_b16_t                vdq_comp;
+  b16_t                         angle;     /* Model electrical angle */
+  b16_t                         vel;       /* Velocity feedback */
+  b16_t                         vel_set;   /* Velocity ramp output */
+  b16_t                         angle_obs; /* Observer angle */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+/****************************************************************************
+ * Name: foc_sim_angle_diff_f32
+ ****************************************************************************/
+
+static b16_t foc_sim_angle_diff_b16(b16_t a, b16_t b)
+{
+  b16_t diff = a - b;
+
+  if (diff > b16PI)
+    {
+      diff -= b16TWOPI;
+    }
+  else if (diff < -b16PI)
+    {
+      diff += b16TWOPI;
+    }
+
+  return diff;
+}
+#endif
+
+/****************************************************************************
+ * Name: foc_sim_init_f32
+ ****************************************************************************/
+
+static int foc_sim_init_b16(FAR struct foc_sim_b16_s *s)
+{
+  struct foc_initdata_b16_s       ctrl_cfg;
+  struct foc_mod_cfg_b16_s        mod_cfg;
+  struct foc_model_pmsm_cfg_b16_s pmsm_cfg;
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  struct foc_angle_osmo_cfg_b16_s smo_cfg;
+#endif
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  struct foc_vel_div_b16_cfg_s    div_cfg;
+#endif
+  int                             ret = OK;
+
+  memset(s, 0, sizeof(struct foc_sim_b16_s));
+
+  /* FOC handler */
+
+  ret = foc_handler_init_b16(&s->handler,
+                             &g_foc_control_pi_b16,
+                             &g_foc_mod_svm3_b16);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_handler_init failed %d\n", ret);
+      goto errout;
+    }
+
+  ctrl_cfg.id_kp = ftob16(FOC_SIM_CURR_KP);
+  ctrl_cfg.id_ki = ftob16(FOC_SIM_CURR_KI);
+  ctrl_cfg.iq_kp = ftob16(FOC_SIM_CURR_KP);
+  ctrl_cfg.iq_ki = ftob16(FOC_SIM_CURR_KI);
+
+  mod_cfg.pwm_duty_max = ftob16(FOC_SIM_PWM_DUTY_MAX);
+
+  foc_handler_cfg_b16(&s->handler, &ctrl_cfg, &mod_cfg);
+
+  /* PMSM model */
+
+  ret = foc_model_init_b16(&s->model, &g_foc_model_pmsm_ops_b16);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_model_init failed %d\n", ret);
+      goto errout;
+    }
+
+  pmsm_cfg.poles      = FOC_SIM_POLES;
+  pmsm_cfg.res        = ftob16(FOC_SIM_RES);
+  pmsm_cfg.ind        = ftob16(FOC_SIM_IND);
+  pmsm_cfg.iner       = ftob16(FOC_SIM_INER);
+  pmsm_cfg.flux_link  = ftob16(FOC_SIM_FLUX);
+  pmsm_cfg.ind_d      = ftob16(FOC_SIM_IND);
+  pmsm_cfg.ind_q      = ftob16(FOC_SIM_IND);
+  pmsm_cfg.per        = FOC_SIM_PER_B16;
+  pmsm_cfg.iphase_adc = ftob16(FOC_SIM_IPHASE_ADC);
+
+  ret = foc_model_cfg_b16(&s->model, &pmsm_cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_model_cfg failed %d\n", ret);
+      goto errout;
+    }
+
+  motor_phy_params_init_b16(&s->phy, FOC_SIM_POLES, ftob16(FOC_SIM_RES),
+                            ftob16(FOC_SIM_IND), ftob16(FOC_SIM_FLUX));
+
+  /* Velocity ramp and velocity controller */
+
+  ret = foc_ramp_init_b16(&s->ramp,
+                          FOC_SIM_PER_B16 * FOC_SIM_VEL_PRESCALER,
+                          ftob16(FOC_SIM_VEL_THR),
+                          ftob16(FOC_SIM_VEL_ACC),
+                          ftob16(FOC_SIM_VEL_ACC));
+  if (ret < 0)
+    {
+      printf("ERROR: foc_ramp_init failed %d\n", ret);
+      goto errout;
+    }
+
+  pi_controller_init_b16(&s->vel_pi, ftob16(FOC_SIM_VEL_KP),
+                         ftob16(FOC_SIM_VEL_KI));
+  pi_saturation_set_b16(&s->vel_pi, ftob16(-FOC_SIM_IQ_MAX),
+                        ftob16(FOC_SIM_IQ_MAX));
+  pi_antiwindup_enable_b16(&s->vel_pi, ftob16(0.99f), true);
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  /* SMO angle observer */
+
+  ret = foc_angle_init_b16(&s->smo, &g_foc_angle_osmo_b16);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_angle_init failed %d\n", ret);
+      goto errout;
+    }
+
+  smo_cfg.per     = FOC_SIM_PER_B16;
+  smo_cfg.k_slide = ftob16(CONFIG_BENCHMARK_FOC_SIM_SMO_KSLIDE / 1000.0f);
+  smo_cfg.err_max = ftob16(CONFIG_BENCHMARK_FOC_SIM_SMO_ERRMAX / 1000.0f);
+  memcpy(&smo_cfg.phy, &s->phy, sizeof(struct motor_phy_params_b16_s));
+
+  ret = foc_angle_cfg_b16(&s->smo, &smo_cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_angle_cfg failed %d\n", ret);
+      goto errout;
+    }
+#endif
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  /* DIV velocity observer */
+
+  ret = foc_velocity_init_b16(&s->veldiv, &g_foc_velocity_odiv_b16);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_velocity_init failed %d\n", ret);
+      goto errout;
+    }
+
+  div_cfg.samples = 10;
+  div_cfg.filter  = ftob16(0.99f);
+  div_cfg.per     = FOC_SIM_PER_B16;
+
+  ret = foc_velocity_cfg_b16(&s->veldiv, &div_cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_velocity_cfg failed %d\n", ret);
+      goto errout;
+    }
+#endif
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: foc_sim_deinit_f32
+ ****************************************************************************/
+
+static void foc_sim_deinit_b16(FAR struct foc_sim_b16_s *s)
+{
+  /* Only handlers that have been initialized */
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  if (s->veldiv.ops != NULL)
+    {
+      foc_velocity_deinit_b16(&s->veldiv);
+    }
+#endif
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  if (s->smo.ops != NULL)
+    {
+      foc_angle_deinit_b16(&s->smo);
+    }
+#endif
+
+  if (s->model.ops != NULL)
+    {
+      foc_model_deinit_b16(&s->model);
+    }
+
+  if (s->handler.ops.ctrl != NULL)
+    {
+      foc_handler_deinit_b16(&s->handler);
+    }
+}
+
+/****************************************************************************
+ * Name: foc_sim_ctrl_f32
+ *
+ * Description:
+ *   One step of the control stack. Everything measured as controller
+ *   cost is called from here.
+ *
+ ****************************************************************************/
+
+static int foc_sim_ctrl_b16(FAR struct foc_sim_b16_s *s, uint32_t step,
+                            b16_t vel_des)
+{
+  struct foc_handler_input_b16_s  in;
+  struct foc_handler_output_b16_s out;
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  struct foc_angle_in_b16_s       ain;
+  struct foc_angle_out_b16_s      aout;
+#endif
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  struct foc_velocity_in_b16_s    vin;
+  struct foc_velocity_out_b16_s   vout;
+#endif
+  int                             ret = OK;
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  /* Angle observer, fed with the last controller state */
+
+  ain.state = &s->foc_state;
+  ain.angle = s->angle;
+  ain.vel   = s->vel;
+  ain.dir   = DIR_CW_B16;
+
+  ret = foc_angle_run_b16(&s->smo, &ain, &aout);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  s->angle_obs = aout.angle;
+#endif
+
+  /* Velocity feedback */
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  vin.state = &s->foc_state;
+  vin.angle = s->angle;
+  vin.vel   = s->vel;
+  vin.dir   = DIR_CW_B16;
+
+  ret = foc_velocity_run_b16(&s->veldiv, &vin, &vout);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  s->vel = vout.velocity;
+#else
+  s->vel = s->model_state.omega_e;
+#endif
+
+  /* Velocity ramp and velocity controller */
+
+  if (step % FOC_SIM_VEL_PRESCALER == 0)
+    {
+      ret = foc_ramp_run_b16(&s->ramp, vel_des, s->vel, &s->vel_set);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      s->dq_ref.q = pi_controller_b16(&s->vel_pi, s->vel_set - s->vel);
+      s->dq_ref.d = 0;
+    }
+
+  /* FOC current controller */
+
+  memcpy(s->current, s->model_state.curr, sizeof(s->current));
+
+  in.current  = s->current;
+  in.dq_ref   = &s->dq_ref;
+  in.vdq_comp = &s->vdq_comp;
+  in.angle    = s->angle;
+  in.vbus     = ftob16(FOC_SIM_VBUS);
+  in.mode     = FOC_HANDLER_MODE_CURRENT;
+
+  ret = foc_handler_run_b16(&s->handler, &in, &out);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  foc_handler_state_b16(&s->handler, &s->foc_state, NULL);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_sim_f32
+ *
+ * Description:
+ *   Run the fixed16 control stack closed-loop against the PMSM model
+ *
+ * Input Parameter:
+ *   cfg - simulation configuration
+ *   res - simulation results
+ *
+ ****************************************************************************/
+
+int foc_sim_b16(FAR struct foc_sim_cfg_s *cfg, FAR struct foc_sim_res_s *res)
+{
+  FAR struct foc_sim_b16_s *s     = NULL;
+  uint32_t                  steps = 0;
+  uint32_t                  step  = 0;
+  uint32_t                  ticks = 0;
+  b16_t                     vel   = ftob16(cfg->vel);
+  b16_t                     err   = 0;
+  int                       ret   = OK;
+
+  DEBUGASSERT(cfg);
+  DEBUGASSERT(res);
+
+  memset(res, 0, sizeof(struct foc_sim_res_s));
+
+  /* Too big for the stack of small targets */
+
+  s = malloc(sizeof(struct foc_sim_b16_s));
+  if (s == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = foc_sim_init_b16(s);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  steps = (uint32_t)(cfg->time * CONFIG_BENCHMARK_FOC_SIM_FREQ);
+
+  for (step = 0; step < steps; step++)
+    {
+      /* Sample the plant */
+
+      foc_model_state_b16(&s->model, &s->model_state);
+
+      /* Run the controller */
+
+      ticks = perf_gettime();
+      ret = foc_sim_ctrl_b16(s, step, vel);
+      ticks = perf_gettime() - ticks;
+
+      if (ret < 0)
+        {
+          printf("ERROR: controller failed %d at step %" PRIu32 "\n",
+                 ret, step);
+          goto errout;
+        }
+
+      res->ticks += ticks;
+      if (ticks > res->ticks_max)
+        {
+          res->ticks_max = ticks;
+        }
+
+      /* Tracking errors in the second half of the simulation */
+
+      if (step >= steps / 2)
+        {
+          err = b16abs(vel - s->model_state.omega_e);
+          if (b16tof(err) > res->vel_err)
+            {
+              res->vel_err = b16tof(err);
+            }
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+          err = b16abs(foc_sim_angle_diff_b16(s->angle_obs, s->angle));
+          if (b16tof(err) > res->ang_err)
+            {
+              res->ang_err = b16tof(err);
+            }
+#endif
+        }
+
+      /* Apply the controller voltage to the plant */
+
+      foc_model_run_b16(&s->model, ftob16(FOC_SIM_LOAD), &s->foc_state.vab);
+
+      /* Ideal angle sensor */
+
+      s->angle += b16mulb16(s->model_state.omega_e, FOC_SIM_PER_B16);
+      if (s->angle >= b16TWOPI)
+        {
+          s->angle -= b16TWOPI;
+        }
+      else if (s->angle < 0)
+        {
+          s->angle += b16TWOPI;
+        }
+    }
+
+  res->steps = steps;
+  res->vel   = b16tof(s->model_state.omega_e);
+
+errout:
+  foc_sim_deinit_b16(s);
+  free(s);
+  return ret;
+}
@@ -0,0 +1,479 @@
+/****************************************************************************
+ * apps/benchmarks/foc_sim/foc_sim_f32.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <dsp.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "industry/foc/foc_common.h"
+#include "industry/foc/float/foc_angle.h"
+#include "industry/foc/float/foc_handler.h"
+#include "industry/foc/float/foc_model.h"
+#include "industry/foc/float/foc_ramp.h"
+#include "industry/foc/float/foc_velocity.h"
+
+#include "foc_sim.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Simulated motor controller */
+
+struct foc_sim_f32_s
+{
+  foc_handler_f32_t             handler;
+  foc_model_f32_t               model;
+  struct foc_model_state_f32_s  model_state;
+  struct foc_state_f32_s        foc_state;
+  struct motor_phy_params_f32_s phy;
+  struct foc_ramp_f32_s         ramp;
+  pid_controller_f32_t          vel_pi;
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  foc_angle_f32_t               smo;
+#endif
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  foc_velocity_f32_t            veldiv;
+#endif
+  float                         current[CONFIG_MOTOR_FOC_PHASES];
+  dq_frame_f32_t                dq_ref;
+  dq_frame_f32_t                vdq_comp;
+  float                         angle;     /* Model electrical angle */
+  float                         vel;       /* Velocity feedback */
+  float                         vel_set;   /* Velocity ramp output */
+  float                         angle_obs; /* Observer angle */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+/****************************************************************************
+ * Name: foc_sim_angle_diff_f32
+ ****************************************************************************/
+
+static float foc_sim_angle_diff_f32(float a, float b)
+{
+  float diff = a - b;
+
+  if (diff > M_PI_F)
+    {
+      diff -= 2.0f * M_PI_F;
+    }
+  else if (diff < -M_PI_F)
+    {
+      diff += 2.0f * M_PI_F;
+    }
+
+  return diff;
+}
+#endif
+
+/****************************************************************************
+ * Name: foc_sim_init_f32
+ ****************************************************************************/
+
+static int foc_sim_init_f32(FAR struct foc_sim_f32_s *s)
+{
+  struct foc_initdata_f32_s       ctrl_cfg;
+  struct foc_mod_cfg_f32_s        mod_cfg;
+  struct foc_model_pmsm_cfg_f32_s pmsm_cfg;
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  struct foc_angle_osmo_cfg_f32_s smo_cfg;
+#endif
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  struct foc_vel_div_f32_cfg_s    div_cfg;
+#endif
+  int                             ret = OK;
+
+  memset(s, 0, sizeof(struct foc_sim_f32_s));
+
+  /* FOC handler */
+
+  ret = foc_handler_init_f32(&s->handler,
+                             &g_foc_control_pi_f32,
+                             &g_foc_mod_svm3_f32);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_handler_init failed %d\n", ret);
+      goto errout;
+    }
+
+  ctrl_cfg.id_kp = FOC_SIM_CURR_KP;
+  ctrl_cfg.id_ki = FOC_SIM_CURR_KI;
+  ctrl_cfg.iq_kp = FOC_SIM_CURR_KP;
+  ctrl_cfg.iq_ki = FOC_SIM_CURR_KI;
+
+  mod_cfg.pwm_duty_max = FOC_SIM_PWM_DUTY_MAX;
+
+  foc_handler_cfg_f32(&s->handler, &ctrl_cfg, &mod_cfg);
+
+  /* PMSM model */
+
+  ret = foc_model_init_f32(&s->model, &g_foc_model_pmsm_ops_f32);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_model_init failed %d\n", ret);
+      goto errout;
+    }
+
+  pmsm_cfg.poles      = FOC_SIM_POLES;
+  pmsm_cfg.res        = FOC_SIM_RES;
+  pmsm_cfg.ind        = FOC_SIM_IND;
+  pmsm_cfg.iner       = FOC_SIM_INER;
+  pmsm_cfg.flux_link  = FOC_SIM_FLUX;
+  pmsm_cfg.ind_d      = FOC_SIM_IND;
+  pmsm_cfg.ind_q      = FOC_SIM_IND;
+  pmsm_cfg.per        = FOC_SIM_PER;
+  pmsm_cfg.iphase_adc = FOC_SIM_IPHASE_ADC;
+
+  ret = foc_model_cfg_f32(&s->model, &pmsm_cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_model_cfg failed %d\n", ret);
+      goto errout;
+    }
+
+  motor_phy_params_init(&s->phy, FOC_SIM_POLES, FOC_SIM_RES,
+                        FOC_SIM_IND, FOC_SIM_FLUX);
+
+  /* Velocity ramp and velocity controller */
+
+  ret = foc_ramp_init_f32(&s->ramp,
+                          FOC_SIM_PER * FOC_SIM_VEL_PRESCALER,
+                          FOC_SIM_VEL_THR,
+                          FOC_SIM_VEL_ACC,
+                          FOC_SIM_VEL_ACC);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_ramp_init failed %d\n", ret);
+      goto errout;
+    }
+
+  pi_controller_init(&s->vel_pi, FOC_SIM_VEL_KP, FOC_SIM_VEL_KI);
+  pi_saturation_set(&s->vel_pi, -FOC_SIM_IQ_MAX, FOC_SIM_IQ_MAX);
+  pi_antiwindup_enable(&s->vel_pi, 0.99f, true);
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  /* SMO angle observer */
+
+  ret = foc_angle_init_f32(&s->smo, &g_foc_angle_osmo_f32);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_angle_init failed %d\n", ret);
+      goto errout;
+    }
+
+  smo_cfg.per     = FOC_SIM_PER;
+  smo_cfg.k_slide = (CONFIG_BENCHMARK_FOC_SIM_SMO_KSLIDE / 1000.0f);
+  smo_cfg.err_max = (CONFIG_BENCHMARK_FOC_SIM_SMO_ERRMAX / 1000.0f);
+  memcpy(&smo_cfg.phy, &s->phy, sizeof(struct motor_phy_params_f32_s));
+
+  ret = foc_angle_cfg_f32(&s->smo, &smo_cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_angle_cfg failed %d\n", ret);
+      goto errout;
+    }
+#endif
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  /* DIV velocity observer */
+
+  ret = foc_velocity_init_f32(&s->veldiv, &g_foc_velocity_odiv_f32);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_velocity_init failed %d\n", ret);
+      goto errout;
+    }
+
+  div_cfg.samples = 10;
+  div_cfg.filter  = 0.99f;
+  div_cfg.per     = FOC_SIM_PER;
+
+  ret = foc_velocity_cfg_f32(&s->veldiv, &div_cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: foc_velocity_cfg failed %d\n", ret);
+      goto errout;
+    }
+#endif
+
+errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: foc_sim_deinit_f32
+ ****************************************************************************/
+
+static void foc_sim_deinit_f32(FAR struct foc_sim_f32_s *s)
+{
+  /* Only handlers that have been initialized */
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  if (s->veldiv.ops != NULL)
+    {
+      foc_velocity_deinit_f32(&s->veldiv);
+    }
+#endif
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  if (s->smo.ops != NULL)
+    {
+      foc_angle_deinit_f32(&s->smo);
+    }
+#endif
+
+  if (s->model.ops != NULL)
+    {
+      foc_model_deinit_f32(&s->model);
+    }
+
+  if (s->handler.ops.ctrl != NULL)
+    {
+      foc_handler_deinit_f32(&s->handler);
+    }
+}
+
+/****************************************************************************
+ * Name: foc_sim_ctrl_f32
+ *
+ * Description:
+ *   One step of the control stack. Everything measured as controller
+ *   cost is called from here.
+ *
+ ****************************************************************************/
+
+static int foc_sim_ctrl_f32(FAR struct foc_sim_f32_s *s, uint32_t step,
+                            float vel_des)
+{
+  struct foc_handler_input_f32_s  in;
+  struct foc_handler_output_f32_s out;
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  struct foc_angle_in_f32_s       ain;
+  struct foc_angle_out_f32_s      aout;
+#endif
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  struct foc_velocity_in_f32_s    vin;
+  struct foc_velocity_out_f32_s   vout;
+#endif
+  int                             ret = OK;
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  /* Angle observer, fed with the last controller state */
+
+  ain.state = &s->foc_state;
+  ain.angle = s->angle;
+  ain.vel   = s->vel;
+  ain.dir   = DIR_CW;
+
+  ret = foc_angle_run_f32(&s->smo, &ain, &aout);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  s->angle_obs = aout.angle;
+#endif
+
+  /* Velocity feedback */
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_VELDIV
+  vin.state = &s->foc_state;
+  vin.angle = s->angle;
+  vin.vel   = s->vel;
+  vin.dir   = DIR_CW;
+
+  ret = foc_velocity_run_f32(&s->veldiv, &vin, &vout);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  s->vel = vout.velocity;
+#else
+  s->vel = s->model_state.omega_e;
+#endif
+
+  /* Velocity ramp and velocity controller */
+
+  if (step % FOC_SIM_VEL_PRESCALER == 0)
+    {
+      ret = foc_ramp_run_f32(&s->ramp, vel_des, s->vel, &s->vel_set);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      s->dq_ref.q = pi_controller(&s->vel_pi, s->vel_set - s->vel);
+      s->dq_ref.d = 0.0f;
+    }
+
+  /* FOC current controller */
+
+  memcpy(s->current, s->model_state.curr, sizeof(s->current));
+
+  in.current  = s->current;
+  in.dq_ref   = &s->dq_ref;
+  in.vdq_comp = &s->vdq_comp;
+  in.angle    = s->angle;
+  in.vbus     = FOC_SIM_VBUS;
+  in.mode     = FOC_HANDLER_MODE_CURRENT;
+
+  ret = foc_handler_run_f32(&s->handler, &in, &out);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  foc_handler_state_f32(&s->handler, &s->foc_state, NULL);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_sim_f32
+ *
+ * Description:
+ *   Run the float control stack closed-loop against the PMSM model
+ *
+ * Input Parameter:
+ *   cfg - simulation configuration
+ *   res - simulation results
+ *
+ ****************************************************************************/
+
+int foc_sim_f32(FAR struct foc_sim_cfg_s *cfg, FAR struct foc_sim_res_s *res)
+{
+  FAR struct foc_sim_f32_s *s     = NULL;
+  uint32_t                  steps = 0;
+  uint32_t                  step  = 0;
+  uint32_t                  ticks = 0;
+  float                     err   = 0.0f;
+  int                       ret   = OK;
+
+  DEBUGASSERT(cfg);
+  DEBUGASSERT(res);
+
+  memset(res, 0, sizeof(struct foc_sim_res_s));
+
+  /* Too big for the stack of small targets */
+
+  s = malloc(sizeof(struct foc_sim_f32_s));
+  if (s == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = foc_sim_init_f32(s);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  steps = (uint32_t)(cfg->time * CONFIG_BENCHMARK_FOC_SIM_FREQ);
+
+  for (step = 0; step < steps; step++)
+    {
+      /* Sample the plant */
+
+      foc_model_state_f32(&s->model, &s->model_state);
+
+      /* Run the controller */
+
+      ticks = perf_gettime();
+      ret = foc_sim_ctrl_f32(s, step, cfg->vel);
+      ticks = perf_gettime() - ticks;
+
+      if (ret < 0)
+        {
+          printf("ERROR: controller failed %d at step %" PRIu32 "\n",
+                 ret, step);
+          goto errout;
+        }
+
+      res->ticks += ticks;
+      if (ticks > res->ticks_max)
+        {
+          res->ticks_max = ticks;
+        }
+
+      /* Tracking errors in the second half of the simulation */
+
+      if (step >= steps / 2)
+        {
+          err = fabsf(cfg->vel - s->model_state.omega_e);
+          if (err > res->vel_err)
+            {
+              res->vel_err = err;
+            }
+
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+          err = fabsf(foc_sim_angle_diff_f32(s->angle_obs, s->angle));
+          if (err > res->ang_err)
+            {
+              res->ang_err = err;
+            }
+#endif
+        }
+
+      /* Apply the controller voltage to the plant */
+
+      foc_model_run_f32(&s->model, FOC_SIM_LOAD, &s->foc_state.vab);
+
+      /* Ideal angle sensor */
+
+      s->angle += s->model_state.omega_e * FOC_SIM_PER;
+      s->angle  = fmodf(s->angle, 2.0f * M_PI_F);
+      if (s->angle < 0.0f)
+        {
+          s->angle += 2.0f * M_PI_F;
+        }
+    }
+
+  res->steps = steps;
+  res->vel   = s->model_state.omega_e;
+
+errout:
+  foc_sim_deinit_f32(s);
+  free(s);
+  return ret;
+}
@@ -0,0 +1,201 @@
+/****************************************************************************
+ * apps/benchmarks/foc_sim/foc_sim_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/param.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/clock.h>
+
+#include "foc_sim.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Simulated controller type */
+
+struct foc_sim_type_s
+{
+  FAR const char *name;
+  CODE int      (*run)(FAR struct foc_sim_cfg_s *cfg,
+                       FAR struct foc_sim_res_s *res);
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct foc_sim_type_s g_foc_sim_types[] =
+{
+#ifdef CONFIG_INDUSTRY_FOC_FLOAT
+  { "float",   foc_sim_f32 },
+#endif
+#ifdef CONFIG_INDUSTRY_FOC_FIXED16
+  { "fixed16", foc_sim_b16 },
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_sim_usage
+ ****************************************************************************/
+
+static void foc_sim_usage(FAR const char *progname)
+{
+  printf("Usage: %s [-t time] [-v vel]\n", progname);
+  printf("  -t  simulated time [s] (default %d)\n",
+         CONFIG_BENCHMARK_FOC_SIM_TIME);
+  printf("  -v  velocity setpoint [electrical rad/s] (default %d)\n",
+         CONFIG_BENCHMARK_FOC_SIM_VEL);
+}
+
+/****************************************************************************
+ * Name: foc_sim_nsec
+ ****************************************************************************/
+
+static uint32_t foc_sim_nsec(uint32_t ticks)
+{
+  struct timespec ts;
+
+  perf_convert(ticks, &ts);
+
+  return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: foc_sim_report
+ ****************************************************************************/
+
+static void foc_sim_report(FAR const struct foc_sim_type_s *type,
+                           FAR struct foc_sim_cfg_s *cfg,
+                           FAR struct foc_sim_res_s *res,
+                           float wall)
+{
+  uint32_t avg = 0;
+
+  if (res->steps > 0)
+    {
+      avg = (uint32_t)(res->ticks / res->steps);
+    }
+
+  printf("%s:\n", type->name);
+  printf("  sim=%.1f s steps=%" PRIu32 " wall=%.3f s (%.1fx real time)\n",
+         cfg->time, res->steps, wall,
+         wall > 0.0f ? cfg->time / wall : 0.0f);
+  printf("  ctrl avg=%" PRIu32 " nsec max=%" PRIu32 " nsec\n",
+         foc_sim_nsec(avg), foc_sim_nsec(res->ticks_max));
+  printf("  vel set=%.2f now=%.2f err_max=%.2f rad/s\n",
+         cfg->vel, res->vel, res->vel_err);
+#ifdef CONFIG_BENCHMARK_FOC_SIM_SMO
+  printf("  smo angle err_max=%.4f rad\n", res->ang_err);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct foc_sim_cfg_s cfg;
+  struct foc_sim_res_s res;
+  struct timespec      start;
+  struct timespec      end;
+  float                wall = 0.0f;
+  int                  ret  = OK;
+  int                  opt  = 0;
+  size_t               i    = 0;
+
+  cfg.time = CONFIG_BENCHMARK_FOC_SIM_TIME;
+  cfg.vel  = CONFIG_BENCHMARK_FOC_SIM_VEL;
+
+  while ((opt = getopt(argc, argv, "t:v:h")) != -1)
+    {
+      switch (opt)
+        {
+          case 't':
+            {
+              cfg.time = atof(optarg);
+              break;
+            }
+
+          case 'v':
+            {
+              cfg.vel = atof(optarg);
+              break;
+            }
+
+          case 'h':
+          default:
+            {
+              foc_sim_usage(argv[0]);
+              return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+        }
+    }
+
+  if (cfg.time <= 0.0f)
+    {
+      foc_sim_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  printf("foc_sim: freq=%d Hz\n", CONFIG_BENCHMARK_FOC_SIM_FREQ);
+
+  for (i = 0; i < nitems(g_foc_sim_types); i++)
+    {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      ret = g_foc_sim_types[i].run(&cfg, &res);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+
+      if (ret < 0)
+        {
+          printf("ERROR: %s simulation failed %d\n",
+                 g_foc_sim_types[i].name, ret);
+          return EXIT_FAILURE;
+        }
+
+      wall = (end.tv_sec - start.tv_sec) +
+             (end.tv_nsec - start.tv_nsec) / 1000000000.0f;
+
+      foc_sim_report(&g_foc_sim_types[i], &cfg, &res, wall);
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,350 @@
+/****************************************************************************
+ * apps/benchmarks/foc_trig/foc_trig_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/param.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/clock.h>
+
+#include <dsp.h>
+
+#include "industry/foc/float/foc_trig.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Phase angles are swept over two periods in each direction, so the angle
+ * normalization is part of the measurement as in the controller.
+ */
+
+#define FOC_TRIG_SWEEP_MIN (-2.0f * FOC_TRIG_2PI)
+#define FOC_TRIG_SWEEP     (4.0f * FOC_TRIG_2PI)
+
+/* Angle wrap is also tested far away from the range, as an accumulated
+ * encoder or open-loop angle may be.
+ */
+
+#define FOC_TRIG_WRAP_MIN  (-50.0f * FOC_TRIG_2PI)
+#define FOC_TRIG_WRAP      (100.0f * FOC_TRIG_2PI)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Phase angle update method */
+
+struct foc_trig_type_s
+{
+  FAR const char *name;
+  CODE void     (*update)(FAR phase_angle_f32_t *angle, float a);
+};
+
+/* Angle wrap method */
+
+struct foc_trig_wrap_s
+{
+  FAR const char *name;
+  CODE void     (*wrap)(FAR float *angle, float bottom, float top);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void foc_trig_libm(FAR phase_angle_f32_t *angle, float a);
+static void foc_trig_wrap(FAR float *angle, float bottom, float top);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct foc_trig_type_s g_foc_trig_types[] =
+{
+  { "libdsp", phase_angle_update },
+  { "libm",   foc_trig_libm },
+  { "lut",    foc_trig_angle_f32 },
+};
+
+static const struct foc_trig_wrap_s g_foc_trig_wraps[] =
+{
+  { "angle_norm_2pi", angle_norm_2pi },
+  { "foc_wrap",       foc_trig_wrap },
+};
+
+/* Results are accumulated here so that the compiler keeps the calls */
+
+static volatile float g_foc_trig_sink;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_trig_libm
+ *
+ * Description:
+ *   Phase angle update with the sinf()/cosf() from libm
+ *
+ ****************************************************************************/
+
+static void foc_trig_libm(FAR phase_angle_f32_t *angle, float a)
+{
+  angle_norm_2pi(&a, 0.0f, FOC_TRIG_2PI);
+
+  angle->angle = a;
+  angle->sin   = sinf(a);
+  angle->cos   = cosf(a);
+}
+
+/****************************************************************************
+ * Name: foc_trig_wrap
+ *
+ * Description:
+ *   foc_angle_wrap_f32() is inline, so call it through a function like
+ *   angle_norm_2pi() to compare the same thing
+ *
+ ****************************************************************************/
+
+static void foc_trig_wrap(FAR float *angle, float bottom, float top)
+{
+  foc_angle_wrap_f32(angle, bottom, top);
+}
+
+/****************************************************************************
+ * Name: foc_trig_usage
+ ****************************************************************************/
+
+static void foc_trig_usage(FAR const char *progname)
+{
+  printf("Usage: %s [-n samples]\n", progname);
+  printf("  -n  number of samples (default %d)\n",
+         CONFIG_BENCHMARK_FOC_TRIG_SAMPLES);
+}
+
+/****************************************************************************
+ * Name: foc_trig_nsec
+ ****************************************************************************/
+
+static uint64_t foc_trig_nsec(uint32_t ticks)
+{
+  struct timespec ts;
+
+  perf_convert(ticks, &ts);
+
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: foc_trig_run
+ *
+ * Description:
+ *   Measure one phase angle update method: time per call and maximum
+ *   sine/cosine error against the double precision libm
+ *
+ ****************************************************************************/
+
+static void foc_trig_run(FAR const struct foc_trig_type_s *type,
+                         uint32_t samples)
+{
+  phase_angle_f32_t angle;
+  float             step    = FOC_TRIG_SWEEP / samples;
+  float             a       = 0.0f;
+  float             err     = 0.0f;
+  float             err_max = 0.0f;
+  float             sum     = 0.0f;
+  uint32_t          ticks   = 0;
+  uint32_t          i       = 0;
+
+  /* Speed */
+
+  ticks = perf_gettime();
+
+  for (i = 0; i < samples; i++)
+    {
+      type->update(&angle, FOC_TRIG_SWEEP_MIN + i * step);
+      sum += angle.sin + angle.cos;
+    }
+
+  ticks = perf_gettime() - ticks;
+
+  g_foc_trig_sink = sum;
+
+  /* Accuracy */
+
+  for (i = 0; i < samples; i++)
+    {
+      a = FOC_TRIG_SWEEP_MIN + i * step;
+      type->update(&angle, a);
+
+      err = fabs(angle.sin - sin(a));
+      if (err > err_max)
+        {
+          err_max = err;
+        }
+
+      err = fabs(angle.cos - cos(a));
+      if (err > err_max)
+        {
+          err_max = err;
+        }
+    }
+
+  printf("  %-16s %6" PRIu64 " nsec/call  err_max=%.3e\n",
+         type->name, foc_trig_nsec(ticks) / samples, err_max);
+}
+
+/****************************************************************************
+ * Name: foc_trig_wrap_run
+ *
+ * Description:
+ *   Measure one angle wrap method: time per call and maximum difference
+ *   from angle_norm_2pi()
+ *
+ ****************************************************************************/
+
+static void foc_trig_wrap_run(FAR const struct foc_trig_wrap_s *type,
+                              uint32_t samples)
+{
+  float    step    = FOC_TRIG_WRAP / samples;
+  float    a       = 0.0f;
+  float    ref     = 0.0f;
+  float    err     = 0.0f;
+  float    err_max = 0.0f;
+  float    sum     = 0.0f;
+  uint32_t ticks   = 0;
+  uint32_t i       = 0;
+
+  /* Speed */
+
+  ticks = perf_gettime();
+
+  for (i = 0; i < samples; i++)
+    {
+      a = FOC_TRIG_WRAP_MIN + i * step;
+      type->wrap(&a, -M_PI_F, M_PI_F);
+      sum += a;
+    }
+
+  ticks = perf_gettime() - ticks;
+
+  g_foc_trig_sink = sum;
+
+  /* Difference from the libdsp */
+
+  for (i = 0; i < samples; i++)
+    {
+      a   = FOC_TRIG_WRAP_MIN + i * step;
+      ref = a;
+
+      type->wrap(&a, -M_PI_F, M_PI_F);
+      angle_norm_2pi(&ref, -M_PI_F, M_PI_F);
+
+      /* The same angle may be on the other end of the range */
+
+      err = fabsf(a - ref);
+      if (err > M_PI_F)
+        {
+          err = fabsf(err - FOC_TRIG_2PI);
+        }
+
+      if (err > err_max)
+        {
+          err_max = err;
+        }
+    }
+
+  printf("  %-16s %6" PRIu64 " nsec/call  diff_max=%.3e\n",
+         type->name, foc_trig_nsec(ticks) / samples, err_max);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  uint32_t samples = CONFIG_BENCHMARK_FOC_TRIG_SAMPLES;
+  int      opt     = 0;
+  size_t   i       = 0;
+
+  while ((opt = getopt(argc, argv, "n:h")) != -1)
+    {
+      switch (opt)
+        {
+          case 'n':
+            {
+              samples = strtoul(optarg, NULL, 0);
+              break;
+            }
+
+          case 'h':
+          default:
+            {
+              foc_trig_usage(argv[0]);
+              return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+        }
+    }
+
+  if (samples == 0)
+    {
+      foc_trig_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  foc_trig_init_f32();
+
+  printf("foc_trig: samples=%" PRIu32 " lut=%d\n",
+         samples, FOC_TRIG_LUT_SIZE);
+
+  printf("phase angle update:\n");
+
+  for (i = 0; i < nitems(g_foc_trig_types); i++)
+    {
+      foc_trig_run(&g_foc_trig_types[i], samples);
+    }
+
+  printf("angle wrap:\n");
+
+  for (i = 0; i < nitems(g_foc_trig_wraps); i++)
+    {
+      foc_trig_wrap_run(&g_foc_trig_wraps[i], samples);
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,297 @@
+/****************************************************************************
+ * apps/benchmarks/mbcrc/mbcrc_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/param.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/clock.h>
+
+#include "industry/mbcrc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Largest Modbus RTU frame */
+
+#define MBCRC_BENCH_LEN_MAX 256
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Checksum method, the result is widened to 16 bits */
+
+struct mbcrc_bench_type_s
+{
+  FAR const char *name;
+  CODE uint16_t (*run)(FAR const uint8_t *buf, size_t len);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint16_t mbcrc_bench_ref_crc16(FAR const uint8_t *buf, size_t len);
+static uint16_t mbcrc_bench_crc16(FAR const uint8_t *buf, size_t len);
+static uint16_t mbcrc_bench_ref_lrc(FAR const uint8_t *buf, size_t len);
+static uint16_t mbcrc_bench_lrc(FAR const uint8_t *buf, size_t len);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Each library method follows its byte-wise reference */
+
+static const struct mbcrc_bench_type_s g_mbcrc_bench_types[] =
+{
+  { "crc16 byte",  mbcrc_bench_ref_crc16 },
+  { "crc16 mbcrc", mbcrc_bench_crc16 },
+  { "lrc byte",    mbcrc_bench_ref_lrc },
+  { "lrc mbcrc",   mbcrc_bench_lrc },
+};
+
+/* Frame sizes: a short request, a typical response and the largest frame */
+
+static const size_t g_mbcrc_bench_lens[] =
+{
+  8, 64, MBCRC_BENCH_LEN_MAX
+};
+
+static uint16_t g_mbcrc_bench_table[256];
+static uint8_t  g_mbcrc_bench_buf[MBCRC_BENCH_LEN_MAX];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mbcrc_bench_init
+ *
+ * Description:
+ *   Fill the byte-wise CRC16 table the Modbus stacks used before the
+ *   library, and the frame buffer
+ *
+ ****************************************************************************/
+
+static void mbcrc_bench_init(void)
+{
+  uint16_t crc = 0;
+  int      i   = 0;
+  int      j   = 0;
+
+  for (i = 0; i < 256; i++)
+    {
+      crc = i;
+      for (j = 0; j < 8; j++)
+        {
+          crc = (crc & 1) ? (crc >> 1) ^ 0xa001 : crc >> 1;
+        }
+
+      g_mbcrc_bench_table[i] = crc;
+    }
+
+  for (i = 0; i < MBCRC_BENCH_LEN_MAX; i++)
+    {
+      g_mbcrc_bench_buf[i] = (uint8_t)(i * 37 + 11);
+    }
+}
+
+/****************************************************************************
+ * Name: mbcrc_bench_ref_crc16
+ ****************************************************************************/
+
+static uint16_t mbcrc_bench_ref_crc16(FAR const uint8_t *buf, size_t len)
+{
+  uint16_t crc = MBCRC_CRC16_INIT;
+
+  while (len-- > 0)
+    {
+      crc = (crc >> 8) ^ g_mbcrc_bench_table[(crc ^ *buf++) & 0xff];
+    }
+
+  return crc;
+}
+
+/****************************************************************************
+ * Name: mbcrc_bench_crc16
+ ****************************************************************************/
+
+static uint16_t mbcrc_bench_crc16(FAR const uint8_t *buf, size_t len)
+{
+  return mbcrc_crc16(buf, len);
+}
+
+/****************************************************************************
+ * Name: mbcrc_bench_ref_lrc
+ ****************************************************************************/
+
+static uint16_t mbcrc_bench_ref_lrc(FAR const uint8_t *buf, size_t len)
+{
+  uint8_t lrc = 0;
+
+  while (len-- > 0)
+    {
+      lrc += *buf++;
+    }
+
+  return (uint8_t)(-((int8_t)lrc));
+}
+
+/****************************************************************************
+ * Name: mbcrc_bench_lrc
+ ****************************************************************************/
+
+static uint16_t mbcrc_bench_lrc(FAR const uint8_t *buf, size_t len)
+{
+  return mbcrc_lrc(buf, len);
+}
+
+/****************************************************************************
+ * Name: mbcrc_bench_usage
+ ****************************************************************************/
+
+static void mbcrc_bench_usage(FAR const char *progname)
+{
+  printf("Usage: %s [-n samples]\n", progname);
+  printf("  -n  number of samples (default %d)\n",
+         CONFIG_BENCHMARK_MBCRC_SAMPLES);
+}
+
+/****************************************************************************
+ * Name: mbcrc_bench_nsec
+ ****************************************************************************/
+
+static uint64_t mbcrc_bench_nsec(uint32_t ticks)
+{
+  struct timespec ts;
+
+  perf_convert(ticks, &ts);
+
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: mbcrc_bench_run
+ *
+ * Description:
+ *   Measure one checksum method over one frame size: time per frame and
+ *   throughput. The printed sum of all results must be the same for a
+ *   library method and its reference.
+ *
+ ****************************************************************************/
+
+static void mbcrc_bench_run(FAR const struct mbcrc_bench_type_s *type,
+                            size_t len, uint32_t samples)
+{
+  uint64_t nsec  = 0;
+  uint64_t rate  = 0;
+  uint32_t ticks = 0;
+  uint32_t i     = 0;
+  uint16_t sum   = 0;
+
+  ticks = perf_gettime();
+
+  for (i = 0; i < samples; i++)
+    {
+      sum += type->run(g_mbcrc_bench_buf, len);
+    }
+
+  ticks = perf_gettime() - ticks;
+
+  nsec = mbcrc_bench_nsec(ticks);
+  if (nsec > 0)
+    {
+      rate = (uint64_t)len * samples * 1000 / nsec;
+    }
+
+  printf("  %-12s %4zu bytes %7" PRIu64 " nsec/frame %5" PRIu64
+         " bytes/usec  sum=0x%04x\n",
+         type->name, len, nsec / samples, rate, sum);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  uint32_t samples = CONFIG_BENCHMARK_MBCRC_SAMPLES;
+  int      opt     = 0;
+  size_t   i       = 0;
+  size_t   j       = 0;
+
+  while ((opt = getopt(argc, argv, "n:h")) != -1)
+    {
+      switch (opt)
+        {
+          case 'n':
+            {
+              samples = strtoul(optarg, NULL, 0);
+              break;
+            }
+
+          case 'h':
+          default:
+            {
+              mbcrc_bench_usage(argv[0]);
+              return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+        }
+    }
+
+  if (samples == 0)
+    {
+      mbcrc_bench_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  mbcrc_bench_init();
+
+  printf("mbcrc: samples=%" PRIu32 "\n", samples);
+
+  for (i = 0; i < nitems(g_mbcrc_bench_lens); i++)
+    {
+      for (j = 0; j < nitems(g_mbcrc_bench_types); j++)
+        {
+          mbcrc_bench_run(&g_mbcrc_bench_types[j], g_mbcrc_bench_lens[i],
+                          samples);
+        }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,633 @@
+/****************************************************************************
+ * apps/benchmarks/nxscope_bench/nxscope_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_UDP
+#  include <arpa/inet.h>
+#  include <netinet/in.h>
+#  include <sys/socket.h>
+#endif
+
+#include <nuttx/clock.h>
+
+#include <logging/nxscope/nxscope.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NXSBENCH_CHANNELS  CONFIG_BENCHMARK_NXSCOPE_CHANNELS
+#define NXSBENCH_VDIM      CONFIG_BENCHMARK_NXSCOPE_VDIM
+#define NXSBENCH_SAMPLES   CONFIG_BENCHMARK_NXSCOPE_SAMPLES
+#define NXSBENCH_INTERVAL  CONFIG_BENCHMARK_NXSCOPE_STREAM_INTERVAL
+#define NXSBENCH_PUTS      (NXSBENCH_SAMPLES * NXSBENCH_CHANNELS)
+
+#define NXSBENCH_STREAMBUF_LEN CONFIG_BENCHMARK_NXSCOPE_STREAMBUF_LEN
+
+#define NXSBENCH_RXBUF_LEN (32)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Tested data type */
+
+struct nxsbench_type_s
+{
+  uint8_t          type;
+  FAR const char  *name;
+};
+
+/* Sample data */
+
+union nxsbench_data_u
+{
+  uint8_t  u8[NXSBENCH_VDIM];
+  int16_t  i16[NXSBENCH_VDIM];
+  int32_t  i32[NXSBENCH_VDIM];
+  int64_t  i64[NXSBENCH_VDIM];
+  float    f[NXSBENCH_VDIM];
+  double   d[NXSBENCH_VDIM];
+  b16_t    b16[NXSBENCH_VDIM];
+};
+
+/* Benchmark data */
+
+struct nxsbench_s
+{
+  struct nxscope_s               nxs;
+  struct nxscope_intf_s          intf;
+  struct nxscope_proto_s         proto;
+
+  /* Interface ops wrapper, counts the sent bytes */
+
+  FAR struct nxscope_intf_ops_s *ops;
+  struct nxscope_intf_ops_s      ops_cnt;
+  uint64_t                       txbytes;
+
+  /* UDP loopback peer */
+
+  int                            fd;
+  uint64_t                       rxbytes;
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_UDP
+  uint8_t                        rxbuf[NXSBENCH_STREAMBUF_LEN];
+#endif
+
+  /* Put calls latency in perf ticks */
+
+  FAR uint32_t                  *lat;
+  char                           names[NXSBENCH_CHANNELS][8];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct nxsbench_type_s g_nxsbench_types[] =
+{
+  {NXSCOPE_TYPE_UINT8,  "uint8"},
+  {NXSCOPE_TYPE_INT16,  "int16"},
+  {NXSCOPE_TYPE_INT32,  "int32"},
+#ifdef CONFIG_HAVE_LONG_LONG
+  {NXSCOPE_TYPE_INT64,  "int64"},
+#endif
+  {NXSCOPE_TYPE_FLOAT,  "float"},
+#ifdef CONFIG_HAVE_LONG_LONG
+  {NXSCOPE_TYPE_DOUBLE, "double"},
+#endif
+  {NXSCOPE_TYPE_B16,    "b16"},
+};
+
+static FAR struct nxsbench_s *g_nxsbench;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsbench_send
+ ****************************************************************************/
+
+static int nxsbench_send(FAR struct nxscope_intf_s *intf,
+                         FAR uint8_t *buff, int len)
+{
+  FAR struct nxsbench_s *b   = g_nxsbench;
+  int                    ret = OK;
+
+  ret = b->ops->send(intf, buff, len);
+  if (ret >= 0)
+    {
+      b->txbytes += len;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsbench_recv
+ ****************************************************************************/
+
+static int nxsbench_recv(FAR struct nxscope_intf_s *intf,
+                         FAR uint8_t *buff, int len)
+{
+  return g_nxsbench->ops->recv(intf, buff, len);
+}
+
+/****************************************************************************
+ * Name: nxsbench_drain
+ *
+ * Description:
+ *   Receive the frames sent over the UDP loopback
+ *
+ ****************************************************************************/
+
+static void nxsbench_drain(FAR struct nxsbench_s *b)
+{
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_UDP
+  ssize_t n;
+
+  if (b->fd < 0)
+    {
+      return;
+    }
+
+  while ((n = recv(b->fd, b->rxbuf, sizeof(b->rxbuf), MSG_DONTWAIT)) > 0)
+    {
+      b->rxbytes += n;
+    }
+#else
+  UNUSED(b);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsbench_put
+ ****************************************************************************/
+
+static int nxsbench_put(FAR struct nxscope_s *s, uint8_t type, uint8_t ch,
+                        FAR union nxsbench_data_u *v, uint32_t i)
+{
+  int j = 0;
+
+  for (j = 0; j < NXSBENCH_VDIM; j++)
+    {
+      switch (type)
+        {
+          case NXSCOPE_TYPE_UINT8:
+            v->u8[j] = i + j;
+            break;
+
+          case NXSCOPE_TYPE_INT16:
+            v->i16[j] = i - j;
+            break;
+
+          case NXSCOPE_TYPE_INT32:
+            v->i32[j] = i * 1000 + j;
+            break;
+
+          case NXSCOPE_TYPE_INT64:
+            v->i64[j] = (int64_t)i << 20 | j;
+            break;
+
+          case NXSCOPE_TYPE_FLOAT:
+            v->f[j] = i * 0.1f + j;
+            break;
+
+          case NXSCOPE_TYPE_DOUBLE:
+            v->d[j] = i * 0.1 + j;
+            break;
+
+          case NXSCOPE_TYPE_B16:
+            v->b16[j] = itob16(i) + j;
+            break;
+        }
+    }
+
+  switch (type)
+    {
+      case NXSCOPE_TYPE_UINT8:
+        return nxscope_put_vuint8(s, ch, v->u8, NXSBENCH_VDIM);
+
+      case NXSCOPE_TYPE_INT16:
+        return nxscope_put_vint16(s, ch, v->i16, NXSBENCH_VDIM);
+
+      case NXSCOPE_TYPE_INT32:
+        return nxscope_put_vint32(s, ch, v->i32, NXSBENCH_VDIM);
+
+      case NXSCOPE_TYPE_INT64:
+        return nxscope_put_vint64(s, ch, v->i64, NXSBENCH_VDIM);
+
+      case NXSCOPE_TYPE_FLOAT:
+        return nxscope_put_vfloat(s, ch, v->f, NXSBENCH_VDIM);
+
+      case NXSCOPE_TYPE_DOUBLE:
+        return nxscope_put_vdouble(s, ch, v->d, NXSBENCH_VDIM);
+
+      case NXSCOPE_TYPE_B16:
+        return nxscope_put_vb16(s, ch, v->b16, NXSBENCH_VDIM);
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsbench_cmp
+ ****************************************************************************/
+
+static int nxsbench_cmp(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/****************************************************************************
+ * Name: nxsbench_nsec
+ ****************************************************************************/
+
+static uint32_t nxsbench_nsec(uint32_t ticks)
+{
+  struct timespec ts;
+
+  perf_convert(ticks, &ts);
+
+  return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: nxsbench_type
+ *
+ * Description:
+ *   Run the benchmark for one data type
+ *
+ ****************************************************************************/
+
+static int nxsbench_type(FAR struct nxsbench_s *b,
+                         FAR const struct nxsbench_type_s *t)
+{
+  FAR struct nxscope_s        *s = &b->nxs;
+  union nxscope_chinfo_type_u  u;
+  union nxsbench_data_u        v;
+  struct timespec              start;
+  struct timespec              end;
+  uint64_t                     elapsed = 0;
+  uint32_t                     ovf     = 0;
+  uint32_t                     err     = 0;
+  clock_t                      t0      = 0;
+  size_t                       k       = 0;
+  uint32_t                     i       = 0;
+  int                          ch      = 0;
+  int                          ret     = OK;
+
+  /* Configure channels */
+
+  nxscope_stream_start(s, false);
+
+  u.s.dtype = t->type;
+  u.s._res  = 0;
+  u.s.cri   = 0;
+
+  for (ch = 0; ch < NXSBENCH_CHANNELS; ch++)
+    {
+      ret = nxscope_chan_init(s, ch, b->names[ch], u.u8, NXSBENCH_VDIM, 0);
+      if (ret < 0)
+        {
+          printf("ERROR: nxscope_chan_init failed %d\n", ret);
+          return ret;
+        }
+    }
+
+  nxscope_chan_all_en(s, true);
+
+  b->txbytes = 0;
+  b->rxbytes = 0;
+  ovf        = s->stream_ovf;
+
+  nxscope_stream_start(s, true);
+
+  /* Run */
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (i = 0; i < NXSBENCH_SAMPLES; i++)
+    {
+      for (ch = 0; ch < NXSBENCH_CHANNELS; ch++)
+        {
+          t0  = perf_gettime();
+          ret = nxsbench_put(s, t->type, ch, &v, i);
+          b->lat[k++] = perf_gettime() - t0;
+
+          if (ret < 0 && ret != -ENOBUFS)
+            {
+              err++;
+            }
+        }
+
+      if ((i + 1) % NXSBENCH_INTERVAL == 0)
+        {
+          nxscope_stream(s);
+          nxsbench_drain(b);
+        }
+    }
+
+  nxscope_stream(s);
+  nxsbench_drain(b);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  nxscope_stream_start(s, false);
+
+  elapsed = (uint64_t)(end.tv_sec - start.tv_sec) * NSEC_PER_SEC +
+            end.tv_nsec - start.tv_nsec;
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  /* Report */
+
+  qsort(b->lat, k, sizeof(uint32_t), nxsbench_cmp);
+
+  printf("%-7s p50=%6" PRIu32 " p90=%6" PRIu32 " p99=%6" PRIu32
+         " max=%7" PRIu32 " ns  ovf=%-5" PRIu32 " err=%-3" PRIu32
+         " smp/s=%-8" PRIu64 " tx B/s=%-9" PRIu64,
+         t->name,
+         nxsbench_nsec(b->lat[k / 2]),
+         nxsbench_nsec(b->lat[k * 90 / 100]),
+         nxsbench_nsec(b->lat[k * 99 / 100]),
+         nxsbench_nsec(b->lat[k - 1]),
+         s->stream_ovf - ovf, err,
+         (uint64_t)k * NSEC_PER_SEC / elapsed,
+         b->txbytes * NSEC_PER_SEC / elapsed);
+
+  if (b->fd >= 0)
+    {
+      printf(" rx B/s=%" PRIu64, b->rxbytes * NSEC_PER_SEC / elapsed);
+    }
+
+  printf("\n");
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsbench_intf
+ *
+ * Description:
+ *   Run the benchmark for all data types on an initialized interface
+ *
+ ****************************************************************************/
+
+static int nxsbench_intf(FAR struct nxsbench_s *b, FAR const char *name)
+{
+  struct nxscope_cfg_s cfg;
+  size_t               i   = 0;
+  int                  ret = OK;
+
+  /* Count the sent bytes */
+
+  b->ops             = b->intf.ops;
+  b->ops_cnt.send    = nxsbench_send;
+  b->ops_cnt.recv    = nxsbench_recv;
+  b->intf.ops        = &b->ops_cnt;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.intf_cmd      = &b->intf;
+  cfg.intf_stream   = &b->intf;
+  cfg.proto_cmd     = &b->proto;
+  cfg.proto_stream  = &b->proto;
+  cfg.channels      = NXSBENCH_CHANNELS;
+  cfg.streambuf_len = NXSBENCH_STREAMBUF_LEN;
+  cfg.rxbuf_len     = NXSBENCH_RXBUF_LEN;
+#ifdef CONFIG_LOGGING_NXSCOPE_CRICHANNELS
+  cfg.cribuf_len    = NXSBENCH_RXBUF_LEN;
+#endif
+
+  ret = nxscope_init(&b->nxs, &cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: nxscope_init failed %d\n", ret);
+      goto errout;
+    }
+
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_UDP
+  /* The UDP interface sends to the last peer it received from */
+
+  if (b->fd >= 0)
+    {
+      nxscope_recv(&b->nxs);
+    }
+#endif
+
+  printf("\n%s: %d channels, vdim=%d, %d samples, stream every %d\n",
+         name, NXSBENCH_CHANNELS, NXSBENCH_VDIM, NXSBENCH_SAMPLES,
+         NXSBENCH_INTERVAL);
+
+  for (i = 0; i < nitems(g_nxsbench_types); i++)
+    {
+      ret = nxsbench_type(b, &g_nxsbench_types[i]);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxscope_deinit(&b->nxs);
+
+errout:
+  b->intf.ops = b->ops;
+  return ret;
+}
+
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_DUMMY
+/****************************************************************************
+ * Name: nxsbench_dummy
+ ****************************************************************************/
+
+static int nxsbench_dummy(FAR struct nxsbench_s *b)
+{
+  struct nxscope_dummy_cfg_s cfg;
+  int                        ret = OK;
+
+  cfg.nodump = true;
+
+  ret = nxscope_dummy_init(&b->intf, &cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: nxscope_dummy_init failed %d\n", ret);
+      return ret;
+    }
+
+  ret = nxsbench_intf(b, "dummy");
+
+  nxscope_dummy_deinit(&b->intf);
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_UDP
+/****************************************************************************
+ * Name: nxsbench_udp
+ ****************************************************************************/
+
+static int nxsbench_udp(FAR struct nxsbench_s *b)
+{
+  struct nxscope_udp_cfg_s cfg;
+  struct sockaddr_in       addr;
+  uint8_t                  hello = 0;
+  int                      ret   = OK;
+
+  cfg.port     = CONFIG_BENCHMARK_NXSCOPE_UDP_PORT;
+  cfg.nonblock = true;
+
+  ret = nxscope_udp_init(&b->intf, &cfg);
+  if (ret < 0)
+    {
+      printf("ERROR: nxscope_udp_init failed %d\n", ret);
+      return ret;
+    }
+
+  /* Loopback peer */
+
+  b->fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (b->fd < 0)
+    {
+      ret = -errno;
+      printf("ERROR: socket failed %d\n", ret);
+      goto errout;
+    }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(CONFIG_BENCHMARK_NXSCOPE_UDP_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  ret = sendto(b->fd, &hello, 1, 0, (FAR struct sockaddr *)&addr,
+               sizeof(addr));
+  if (ret < 0)
+    {
+      ret = -errno;
+      printf("ERROR: sendto failed %d\n", ret);
+      goto errout;
+    }
+
+  ret = nxsbench_intf(b, "udp loopback");
+
+errout:
+  if (b->fd >= 0)
+    {
+      close(b->fd);
+      b->fd = -1;
+    }
+
+  nxscope_udp_deinit(&b->intf);
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  FAR struct nxsbench_s *b   = NULL;
+  int                    ret = OK;
+  int                    i   = 0;
+
+  b = zalloc(sizeof(struct nxsbench_s));
+  if (b == NULL)
+    {
+      printf("ERROR: failed to allocate benchmark data\n");
+      return EXIT_FAILURE;
+    }
+
+  b->lat = malloc(NXSBENCH_PUTS * sizeof(uint32_t));
+  if (b->lat == NULL)
+    {
+      printf("ERROR: failed to allocate latency buffer\n");
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  b->fd      = -1;
+  g_nxsbench = b;
+
+  for (i = 0; i < NXSBENCH_CHANNELS; i++)
+    {
+      snprintf(b->names[i], sizeof(b->names[i]), "ch%d", i);
+    }
+
+  ret = nxscope_proto_ser_init(&b->proto, NULL);
+  if (ret < 0)
+    {
+      printf("ERROR: nxscope_proto_ser_init failed %d\n", ret);
+      goto errout;
+    }
+
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_DUMMY
+  ret = nxsbench_dummy(b);
+  if (ret < 0)
+    {
+      goto errout_proto;
+    }
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_UDP
+  ret = nxsbench_udp(b);
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_DUMMY
+errout_proto:
+#endif
+  nxscope_proto_ser_deinit(&b->proto);
+
+errout:
+  g_nxsbench = NULL;
+  free(b->lat);
+  free(b);
+
+  return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
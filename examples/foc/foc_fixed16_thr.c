@@ -291,6 +291,21 @@ static void foc_fixed16_nxscope(FAR struct foc_nxscope_s *nxs,
   ptr = svm3_tmp;
   nxscope_put_vb16(&nxs->nxs, i++, ptr, 4);
 #endif
+#if (CONFIG_EXAMPLES_FOC_NXSCOPE_CFG & FOC_NXSCOPE_PERF)
+  /* Observer channels are not captured for fixed16, skip them */
+
+#  if (CONFIG_EXAMPLES_FOC_NXSCOPE_CFG & FOC_NXSCOPE_VOBS)
+  i++;
+#  endif
+#  if (CONFIG_EXAMPLES_FOC_NXSCOPE_CFG & FOC_NXSCOPE_AOBS)
+  i++;
+#  endif
+
+  uint32_t perf_tmp[FOC_PERF_HIST_VALS];
+
+  foc_perf_hist_get(&dev->perf, perf_tmp);
+  nxscope_put_vuint32(&nxs->nxs, i++, perf_tmp, FOC_PERF_HIST_VALS);
+#endif
 
   nxscope_unlock(&nxs->nxs);
 }
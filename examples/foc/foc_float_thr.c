@@ -302,6 +302,12 @@ static void foc_float_nxscope(FAR struct foc_nxscope_s *nxs,
   ptr = (FAR float *)&motor->angle_obs;
   nxscope_put_vfloat(&nxs->nxs, i++, ptr, 1);
 #endif
+#if (CONFIG_EXAMPLES_FOC_NXSCOPE_CFG & FOC_NXSCOPE_PERF)
+  uint32_t perf_tmp[FOC_PERF_HIST_VALS];
+
+  foc_perf_hist_get(&dev->perf, perf_tmp);
+  nxscope_put_vuint32(&nxs->nxs, i++, perf_tmp, FOC_PERF_HIST_VALS);
+#endif
 
 #ifndef CONFIG_EXAMPLES_FOC_NXSCOPE_CONTROL
   nxscope_unlock(&nxs->nxs);
@@ -540,6 +546,15 @@ int foc_float_thr(FAR struct foc_ctrl_env_s *envp)
 
 errout:
 
+#ifdef CONFIG_EXAMPLES_FOC_PERF_EXIT
+  /* Compare FOC handler dispatch before the handler is released */
+
+  if (motor.handler.ops.ctrl != NULL)
+    {
+      foc_perf_cmp_f32(&motor.handler);
+    }
+#endif
+
   /* Deinit motor controller */
 
   ret = foc_motor_deinit(&motor);
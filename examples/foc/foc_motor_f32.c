@@ -1294,6 +1294,65 @@ errout:
 }
 #endif  /* CONFIG_EXAMPLES_FOC_HAVE_VEL */
 
+#ifdef CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_ONLINE
+/****************************************************************************
+ * Name: foc_motor_ident_online
+ ****************************************************************************/
+
+static int foc_motor_ident_online(FAR struct foc_motor_f32_s *motor)
+{
+  struct motor_phy_params_f32_s phy;
+  int                           ret = OK;
+
+  DEBUGASSERT(motor);
+
+  /* Refine motor parameters only in closed-loop current control */
+
+  if (motor->foc_mode != FOC_HANDLER_MODE_CURRENT)
+    {
+      goto errout;
+    }
+
+#ifdef CONFIG_EXAMPLES_FOC_HAVE_OPENLOOP
+  if (motor->openloop_now != FOC_OPENLOOP_DISABLED)
+    {
+      goto errout;
+    }
+#endif
+
+  if (!foc_ident_online_run_f32(&motor->ident_online, &motor->foc_state,
+                                motor->vel_el))
+    {
+      goto errout;
+    }
+
+  /* New estimates - update angle observer */
+
+  foc_ident_online_phy_get_f32(&motor->ident_online, &phy);
+
+#ifdef CONFIG_EXAMPLES_FOC_ANGOBS_SMO
+  ret = foc_angle_phy_f32(&motor->ang_smo, &phy);
+  if (ret < 0)
+    {
+      PRINTF("ERROR: foc_angle_phy_f32 SMO failed %d\n", ret);
+      goto errout;
+    }
+#endif
+
+#ifdef CONFIG_EXAMPLES_FOC_ANGOBS_NFO
+  ret = foc_angle_phy_f32(&motor->ang_nfo, &phy);
+  if (ret < 0)
+    {
+      PRINTF("ERROR: foc_angle_phy_f32 NFO failed %d\n", ret);
+      goto errout;
+    }
+#endif
+
+errout:
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1331,6 +1390,9 @@ int foc_motor_init(FAR struct foc_motor_f32_s *motor,
 #endif
 #ifdef CONFIG_EXAMPLES_FOC_HAVE_IDENT
   struct foc_routine_ident_cfg_f32_s ident_cfg;
+#endif
+#ifdef CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_ONLINE
+  struct foc_ident_online_cfg_f32_s  idon_cfg;
 #endif
   int                                ret = OK;
 
@@ -1504,6 +1566,24 @@ int foc_motor_init(FAR struct foc_motor_f32_s *motor,
     }
 #endif
 
+#ifdef CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_ONLINE
+  /* Initialize online motor identification */
+
+  idon_cfg.per     = motor->per;
+  idon_cfg.forget  = (CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_FORGET / 1000.0f);
+  idon_cfg.vel_min = (CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_VELMIN / 1.0f);
+  idon_cfg.decim   = CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_DECIM;
+  memcpy(&idon_cfg.phy, &motor->phy,
+         sizeof(struct motor_phy_params_f32_s));
+
+  ret = foc_ident_online_init_f32(&motor->ident_online, &idon_cfg);
+  if (ret < 0)
+    {
+      PRINTFV("ERROR: foc_ident_online_init_f32 failed %d!\n", ret);
+      goto errout;
+    }
+#endif
+
 #ifdef CONFIG_EXAMPLES_FOC_VELOBS_DIV
   /* Initialize velocity observer */
 
@@ -1861,6 +1941,16 @@ int foc_motor_get(FAR struct foc_motor_f32_s *motor)
     }
 #endif
 
+#ifdef CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_ONLINE
+  /* Refine motor parameters for angle observer */
+
+  ret = foc_motor_ident_online(motor);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
 errout:
   return ret;
 }
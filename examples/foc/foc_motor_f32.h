@@ -43,6 +43,9 @@
 #ifdef CONFIG_EXAMPLES_FOC_HAVE_IDENT
 #  include "industry/foc/float/foc_ident.h"
 #endif
+#ifdef CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_ONLINE
+#  include "industry/foc/float/foc_ident_online.h"
+#endif
 #ifdef CONFIG_EXAMPLES_FOC_STATE_USE_MODEL_PMSM
 #  include "industry/foc/float/foc_model.h"
 #endif
@@ -196,6 +199,9 @@ struct foc_motor_f32_s
 #ifdef CONFIG_EXAMPLES_FOC_ANGOBS_NFO
   foc_angle_f32_t               ang_nfo;      /* NFO angle observer */
 #endif
+#ifdef CONFIG_EXAMPLES_FOC_ANGOBS_IDENT_ONLINE
+  struct foc_ident_online_f32_s ident_online; /* Online motor ident */
+#endif
 };
 
 /****************************************************************************
@@ -56,6 +56,7 @@
 #define FOC_NXSCOPE_SVM3       (1 << 16)  /* Space-vector modulation sector */
 #define FOC_NXSCOPE_VOBS       (1 << 17)  /* Output from velocity observer */
 #define FOC_NXSCOPE_AOBS       (1 << 18)  /* Output from angle observer */
+#define FOC_NXSCOPE_PERF       (1 << 19)  /* Exec time and jitter [nsec] */
                                           /* Max 32-bit */
 
 /****************************************************************************
@@ -41,6 +41,10 @@
 
 #define PRINTF_PERF(format, ...) printf(format, ##__VA_ARGS__)
 
+/* Iterations for the FOC handler dispatch comparison */
+
+#define FOC_PERF_CMP_ITER        (1000)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -73,6 +77,125 @@ static bool foc_perf_per(struct foc_perf_s *p, FAR uint32_t *per)
   return tmp;
 }
 
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+/****************************************************************************
+ * Name: foc_perf_nsec
+ ****************************************************************************/
+
+static uint32_t foc_perf_nsec(uint32_t ticks)
+{
+  struct timespec ts;
+
+  perf_convert(ticks, &ts);
+
+  return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: foc_perf_hist_put
+ ****************************************************************************/
+
+static void foc_perf_hist_put(FAR struct foc_perf_s *p,
+                              FAR struct foc_perf_hist_s *h,
+                              uint32_t ticks)
+{
+  uint32_t i = ticks / p->bin_ticks;
+
+  if (i >= CONFIG_EXAMPLES_FOC_PERF_HIST_BINS)
+    {
+      i = CONFIG_EXAMPLES_FOC_PERF_HIST_BINS - 1;
+    }
+
+  h->bin[i] += 1;
+  h->cnt    += 1;
+  h->last    = ticks;
+}
+
+/****************************************************************************
+ * Name: foc_perf_hist_print
+ ****************************************************************************/
+
+static void foc_perf_hist_print(FAR const char *name,
+                                FAR struct foc_perf_hist_s *h)
+{
+  uint32_t lo = 0;
+  int      i  = 0;
+
+  PRINTF_PERF("%s hist samples=%" PRId32 "\n", name, h->cnt);
+
+  if (h->cnt == 0)
+    {
+      return;
+    }
+
+  PRINTF_PERF("  p50=%" PRId32 " p90=%" PRId32 " p99=%" PRId32
+              " p99.9=%" PRId32 " nsec\n",
+              foc_perf_hist_pct(h, 500), foc_perf_hist_pct(h, 900),
+              foc_perf_hist_pct(h, 990), foc_perf_hist_pct(h, 999));
+
+  for (i = 0; i < CONFIG_EXAMPLES_FOC_PERF_HIST_BINS; i++)
+    {
+      if (h->bin[i] == 0)
+        {
+          continue;
+        }
+
+      lo = i * CONFIG_EXAMPLES_FOC_PERF_HIST_BIN_NSEC;
+
+      if (i == CONFIG_EXAMPLES_FOC_PERF_HIST_BINS - 1)
+        {
+          PRINTF_PERF("  >=%" PRId32 " nsec: %" PRId32 "\n",
+                      lo, h->bin[i]);
+        }
+      else
+        {
+          PRINTF_PERF("  %" PRId32 "-%" PRId32 " nsec: %" PRId32 "\n",
+                      lo, lo + CONFIG_EXAMPLES_FOC_PERF_HIST_BIN_NSEC,
+                      h->bin[i]);
+        }
+    }
+}
+#endif
+
+#ifdef CONFIG_INDUSTRY_FOC_FLOAT
+/****************************************************************************
+ * Name: foc_perf_ops_run_f32
+ *
+ * Description:
+ *   The current mode path of foc_handler_run_f32() with all calls
+ *   dispatched through the ops tables.
+ *
+ ****************************************************************************/
+
+static void foc_perf_ops_run_f32(FAR foc_handler_f32_t *h,
+                                 FAR struct foc_handler_input_f32_s *in,
+                                 FAR struct foc_handler_output_f32_s *out)
+{
+  ab_frame_f32_t v_ab_mod;
+  float          vbase = 0.0f;
+
+  h->ops.mod->current(h, in->current);
+  h->ops.mod->vbase_get(h, in->vbus, &vbase);
+  h->ops.ctrl->input_set(h, in->current, vbase, in->angle);
+  h->ops.ctrl->current_run(h, in->dq_ref, in->vdq_comp, &v_ab_mod);
+  h->ops.mod->run(h, &v_ab_mod, out->duty);
+}
+
+/****************************************************************************
+ * Name: foc_perf_cmp_print
+ ****************************************************************************/
+
+static void foc_perf_cmp_print(FAR const char *name, uint32_t ticks)
+{
+  struct timespec ts;
+  uint32_t        avg = ticks / FOC_PERF_CMP_ITER;
+
+  perf_convert(avg, &ts);
+  PRINTF_PERF("%s ticks=%" PRId32 "\n", name, avg);
+  PRINTF_PERF("  nsec=%" PRId32 "\n", ts.tv_nsec);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,6 +208,20 @@ int foc_perf_init(struct foc_perf_s *p)
 {
   memset(p, 0, sizeof(struct foc_perf_s));
 
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+  /* Histogram bin width and nominal period in perf ticks */
+
+  p->bin_ticks = (uint32_t)((float)perf_getfreq() *
+                            CONFIG_EXAMPLES_FOC_PERF_HIST_BIN_NSEC /
+                            NSEC_PER_SEC);
+  if (p->bin_ticks == 0)
+    {
+      p->bin_ticks = 1;
+    }
+
+  p->per_nom = perf_getfreq() / CONFIG_EXAMPLES_FOC_NOTIFIER_FREQ;
+#endif
+
   return OK;
 }
 
@@ -95,6 +232,10 @@ int foc_perf_init(struct foc_perf_s *p)
 void foc_perf_start(struct foc_perf_s *p)
 {
   p->exec = perf_gettime();
+
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+  p->started = true;
+#endif
 }
 
 /****************************************************************************
@@ -128,6 +269,24 @@ void foc_perf_end(struct foc_perf_s *p)
       p->per_max = tmp;
       p->per_max_changed = true;
     }
+
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+  /* Collect only complete control cycles */
+
+  if (p->started)
+    {
+      foc_perf_hist_put(p, &p->exec_hist, p->exec);
+
+      if (tmp > 0)
+        {
+          foc_perf_hist_put(p, &p->jit_hist,
+                            tmp > p->per_nom ?
+                            tmp - p->per_nom : p->per_nom - tmp);
+        }
+
+      p->started = false;
+    }
+#endif
 }
 
 /****************************************************************************
@@ -170,5 +329,158 @@ void foc_perf_exit(struct foc_perf_s *p)
   PRINTF_PERF("per ticks=%" PRId32 "\n", max);
   PRINTF_PERF("  nsec=%" PRId32 "\n", ts.tv_nsec);
 
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+  foc_perf_hist_print("exec", &p->exec_hist);
+  foc_perf_hist_print("jitter", &p->jit_hist);
+#endif
+
+  PRINTF_PERF("===============================\n");
+}
+
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+/****************************************************************************
+ * Name: foc_perf_hist_pct
+ *
+ * Description:
+ *   Get a histogram percentile in nsec (upper edge of the bin). Values out
+ *   of the histogram range are reported as the histogram range.
+ *
+ * Input Parameter:
+ *   h        - pointer to histogram
+ *   permille - percentile in 0.1% units
+ *
+ ****************************************************************************/
+
+uint32_t foc_perf_hist_pct(FAR struct foc_perf_hist_s *h, uint32_t permille)
+{
+  uint32_t thr = 0;
+  uint32_t sum = 0;
+  int      i   = 0;
+
+  DEBUGASSERT(h);
+
+  if (h->cnt == 0)
+    {
+      return 0;
+    }
+
+  /* Number of samples at or below the percentile, rounded up */
+
+  thr = (uint32_t)(((float)h->cnt * permille + 999) / 1000);
+
+  for (i = 0; i < CONFIG_EXAMPLES_FOC_PERF_HIST_BINS - 1; i++)
+    {
+      sum += h->bin[i];
+      if (sum >= thr)
+        {
+          break;
+        }
+    }
+
+  return (i + 1) * CONFIG_EXAMPLES_FOC_PERF_HIST_BIN_NSEC;
+}
+
+/****************************************************************************
+ * Name: foc_perf_hist_get
+ *
+ * Description:
+ *   Get the last values and percentiles of execution time and period
+ *   jitter in nsec:
+ *
+ *     [exec, exec p50, exec p99, jitter, jitter p50, jitter p99]
+ *
+ * Input Parameter:
+ *   p   - pointer to perf data
+ *   val - output buffer for FOC_PERF_HIST_VALS values
+ *
+ ****************************************************************************/
+
+void foc_perf_hist_get(FAR struct foc_perf_s *p, FAR uint32_t *val)
+{
+  DEBUGASSERT(p);
+  DEBUGASSERT(val);
+
+  val[0] = foc_perf_nsec(p->exec_hist.last);
+  val[1] = foc_perf_hist_pct(&p->exec_hist, 500);
+  val[2] = foc_perf_hist_pct(&p->exec_hist, 990);
+  val[3] = foc_perf_nsec(p->jit_hist.last);
+  val[4] = foc_perf_hist_pct(&p->jit_hist, 500);
+  val[5] = foc_perf_hist_pct(&p->jit_hist, 990);
+}
+#endif
+
+#ifdef CONFIG_INDUSTRY_FOC_FLOAT
+/****************************************************************************
+ * Name: foc_perf_cmp_f32
+ *
+ * Description:
+ *   Compare the average execution time of the FOC current loop dispatched
+ *   through the ops tables with foc_handler_run_f32(), which is statically
+ *   composed if CONFIG_INDUSTRY_FOC_STATIC is enabled.
+ *
+ *   The handler state is modified, so this should be called only when
+ *   the motor is stopped.
+ *
+ ****************************************************************************/
+
+void foc_perf_cmp_f32(FAR foc_handler_f32_t *h)
+{
+  struct foc_handler_input_f32_s  in;
+  struct foc_handler_output_f32_s out;
+  float                           current[CONFIG_MOTOR_FOC_PHASES];
+  dq_frame_f32_t                  dq_ref;
+  dq_frame_f32_t                  vdq_comp;
+  uint32_t                        ops = 0;
+  uint32_t                        run = 0;
+  int                             i   = 0;
+
+  DEBUGASSERT(h);
+
+  /* Synthetic current mode input */
+
+  memset(current, 0, sizeof(current));
+  dq_ref.d   = 0.0f;
+  dq_ref.q   = 0.1f;
+  vdq_comp.d = 0.0f;
+  vdq_comp.q = 0.0f;
+
+  in.current  = current;
+  in.dq_ref   = &dq_ref;
+  in.vdq_comp = &vdq_comp;
+  in.angle    = 0.0f;
+  in.vbus     = 12.0f;
+  in.mode     = FOC_HANDLER_MODE_CURRENT;
+
+  /* Ops table dispatch */
+
+  ops = perf_gettime();
+  for (i = 0; i < FOC_PERF_CMP_ITER; i++)
+    {
+      in.angle = (float)(i % 628) * 0.01f;
+      foc_perf_ops_run_f32(h, &in, &out);
+    }
+
+  ops = perf_gettime() - ops;
+
+  /* FOC handler */
+
+  run = perf_gettime();
+  for (i = 0; i < FOC_PERF_CMP_ITER; i++)
+    {
+      in.angle = (float)(i % 628) * 0.01f;
+      foc_handler_run_f32(h, &in, &out);
+    }
+
+  run = perf_gettime() - run;
+
+  PRINTF_PERF("===============================\n");
+#ifdef CONFIG_INDUSTRY_FOC_STATIC
+  PRINTF_PERF("foc current loop (static)\n");
+#else
+  PRINTF_PERF("foc current loop (ops)\n");
+#endif
+  foc_perf_cmp_print("ops", ops);
+  foc_perf_cmp_print("handler", run);
   PRINTF_PERF("===============================\n");
 }
+#endif
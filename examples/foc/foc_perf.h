@@ -29,6 +29,21 @@
 
 #include <nuttx/config.h>
 
+#ifdef CONFIG_INDUSTRY_FOC_FLOAT
+#  include "industry/foc/foc_common.h"
+#  include "industry/foc/float/foc_handler.h"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+/* Values returned by foc_perf_hist_get() */
+
+#  define FOC_PERF_HIST_VALS (6)
+#endif
+
 /****************************************************************************
  * Public Type Definition
  ****************************************************************************/
@@ -57,6 +72,19 @@
  *           called with CONFIG_EXAMPLES_FOC_NOTIFIER_FREQ frequency
  */
 
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+/* Histogram with CONFIG_EXAMPLES_FOC_PERF_HIST_BIN_NSEC wide bins.
+ * The last bin collects all values out of range.
+ */
+
+struct foc_perf_hist_s
+{
+  uint32_t bin[CONFIG_EXAMPLES_FOC_PERF_HIST_BINS];
+  uint32_t cnt;                 /* Samples */
+  uint32_t last;                /* Last sample in ticks */
+};
+#endif
+
 struct foc_perf_s
 {
   bool     exec_max_changed;    /* Max execution time changed */
@@ -65,6 +93,13 @@ struct foc_perf_s
   uint32_t per_max;             /* Control loop period max */
   uint32_t exec;                /* Temporary storage */
   uint32_t per;                 /* Temporary storage */
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+  bool     started;             /* Execution time measurement started */
+  uint32_t bin_ticks;           /* Histogram bin width in ticks */
+  uint32_t per_nom;             /* Nominal control loop period in ticks */
+  struct foc_perf_hist_s exec_hist; /* Execution time histogram */
+  struct foc_perf_hist_s jit_hist;  /* Period jitter histogram */
+#endif
 };
 
 /****************************************************************************
@@ -76,5 +111,12 @@ void foc_perf_start(struct foc_perf_s *p);
 void foc_perf_end(struct foc_perf_s *p);
 void foc_perf_live(struct foc_perf_s *p);
 void foc_perf_exit(struct foc_perf_s *p);
+#ifdef CONFIG_EXAMPLES_FOC_PERF_HIST
+uint32_t foc_perf_hist_pct(FAR struct foc_perf_hist_s *h, uint32_t permille);
+void foc_perf_hist_get(FAR struct foc_perf_s *p, FAR uint32_t *val);
+#endif
+#ifdef CONFIG_INDUSTRY_FOC_FLOAT
+void foc_perf_cmp_f32(FAR foc_handler_f32_t *h);
+#endif
 
 #endif /* __APPS_EXAMPLES_FOC_FOC_PERF_H */
@@ -595,7 +595,7 @@ int main(int argc, FAR char *argv[])
 #ifdef CONFIG_LOGGING_NXSCOPE_INTF_DUMMY
   /* Configuration */
 
-  nxs_dummy_cfg.res = 0;
+  nxs_dummy_cfg.nodump = false;
 
   /* Initialize dummy interface */
 
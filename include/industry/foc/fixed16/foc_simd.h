@@ -0,0 +1,276 @@
+/****************************************************************************
+ * apps/include/industry/foc/fixed16/foc_simd.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INDUSTRY_FOC_FIXED16_FOC_SIMD_H
+#define __INDUSTRY_FOC_FIXED16_FOC_SIMD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <dspb16.h>
+
+#ifdef __ARM_FEATURE_DSP
+#  include <arm_acle.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The DSP kernels split a b16_t coefficient c into its signed low halfword
+ * and an integer part hi, so that c = hi * 2^16 + (int16_t)c. Then:
+ *
+ *   b16mulb16(x, c) = x * hi + ((x * (int16_t)c) >> 16)
+ *
+ * The first term is an exact integer, so the result is bit-exact with
+ * b16mulb16() for all inputs. The second term is one SMULWx instruction
+ * and two such terms with different coefficients share one register
+ * (coefficient 0 in the bottom halfword, coefficient 1 in the top).
+ */
+
+#define FOC_SIMD_HI_B16(c)      (((c) >> 16) + (((c) >> 15) & 1))
+#define FOC_SIMD_PACK_B16(c0, c1) \
+  ((int32_t)(((uint32_t)(c0) & 0xffff) | ((uint32_t)(c1) << 16)))
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef __ARM_FEATURE_DSP
+
+/****************************************************************************
+ * Name: foc_simd_mla_b16
+ *
+ * Description:
+ *   Return acc + x * hi with the 32-bit wrap-around of b16mulb16()
+ *
+ ****************************************************************************/
+
+static inline b16_t foc_simd_mla_b16(b16_t acc, b16_t x, int32_t hi)
+{
+  return (b16_t)((uint32_t)acc + (uint32_t)x * (uint32_t)hi);
+}
+
+/****************************************************************************
+ * Name: foc_simd_sub_b16
+ ****************************************************************************/
+
+static inline b16_t foc_simd_sub_b16(b16_t a, b16_t b)
+{
+  return (b16_t)((uint32_t)a - (uint32_t)b);
+}
+
+/****************************************************************************
+ * Name: foc_simd_dot2_b16
+ *
+ * Description:
+ *   Return b16mulb16(x0, c0) + b16mulb16(x1, c1), where c holds the packed
+ *   low halfwords of both coefficients and hi0/hi1 their integer parts.
+ *
+ ****************************************************************************/
+
+static inline b16_t foc_simd_dot2_b16(b16_t x0, b16_t x1, int32_t c,
+                                      int32_t hi0, int32_t hi1)
+{
+  b16_t acc = __smlawt(x1, c, __smulwb(x0, c));
+
+  return foc_simd_mla_b16(foc_simd_mla_b16(acc, x0, hi0), x1, hi1);
+}
+#endif
+
+/****************************************************************************
+ * Name: foc_simd_mul_b16
+ *
+ * Description:
+ *   Fixed16 multiplication, bit-exact with b16mulb16()
+ *
+ ****************************************************************************/
+
+static inline b16_t foc_simd_mul_b16(b16_t x, b16_t c)
+{
+#ifdef __ARM_FEATURE_DSP
+  return foc_simd_mla_b16(__smulwb(x, c), x, FOC_SIMD_HI_B16(c));
+#else
+  return b16mulb16(x, c);
+#endif
+}
+
+/****************************************************************************
+ * Name: foc_simd_clarke_b16
+ *
+ * Description:
+ *   Clarke transform (abc frame -> ab frame), bit-exact with
+ *   clarke_transform_b16()
+ *
+ ****************************************************************************/
+
+static inline void foc_simd_clarke_b16(FAR abc_frame_b16_t *abc,
+                                       FAR ab_frame_b16_t *ab)
+{
+#ifdef __ARM_FEATURE_DSP
+  ab->b = foc_simd_dot2_b16(abc->a, abc->b,
+                            FOC_SIMD_PACK_B16(ONE_BY_SQRT3_B16,
+                                              TWO_BY_SQRT3_B16),
+                            FOC_SIMD_HI_B16(ONE_BY_SQRT3_B16),
+                            FOC_SIMD_HI_B16(TWO_BY_SQRT3_B16));
+#else
+  ab->b = b16mulb16(abc->a, ONE_BY_SQRT3_B16) +
+          b16mulb16(abc->b, TWO_BY_SQRT3_B16);
+#endif
+  ab->a = abc->a;
+}
+
+/****************************************************************************
+ * Name: foc_simd_park_b16
+ *
+ * Description:
+ *   Park transform (ab frame -> dq frame), bit-exact with
+ *   park_transform_b16()
+ *
+ ****************************************************************************/
+
+static inline void foc_simd_park_b16(FAR phase_angle_b16_t *angle,
+                                     FAR ab_frame_b16_t *ab,
+                                     FAR dq_frame_b16_t *dq)
+{
+#ifdef __ARM_FEATURE_DSP
+  int32_t cs     = FOC_SIMD_PACK_B16(angle->cos, angle->sin);
+  int32_t cos_hi = FOC_SIMD_HI_B16(angle->cos);
+  int32_t sin_hi = FOC_SIMD_HI_B16(angle->sin);
+  b16_t   a      = ab->a;
+  b16_t   b      = ab->b;
+
+  dq->d = foc_simd_dot2_b16(a, b, cs, cos_hi, sin_hi);
+  dq->q = foc_simd_sub_b16(foc_simd_mla_b16(__smulwb(b, cs), b, cos_hi),
+                           foc_simd_mla_b16(__smulwt(a, cs), a, sin_hi));
+#else
+  b16_t a = ab->a;
+  b16_t b = ab->b;
+
+  dq->d = b16mulb16(angle->cos, a) + b16mulb16(angle->sin, b);
+  dq->q = b16mulb16(angle->cos, b) - b16mulb16(angle->sin, a);
+#endif
+}
+
+/****************************************************************************
+ * Name: foc_simd_inv_park_b16
+ *
+ * Description:
+ *   Inverse Park transform (dq frame -> ab frame), bit-exact with
+ *   inv_park_transform_b16()
+ *
+ ****************************************************************************/
+
+static inline void foc_simd_inv_park_b16(FAR phase_angle_b16_t *angle,
+                                         FAR dq_frame_b16_t *dq,
+                                         FAR ab_frame_b16_t *ab)
+{
+#ifdef __ARM_FEATURE_DSP
+  int32_t cs     = FOC_SIMD_PACK_B16(angle->cos, angle->sin);
+  int32_t cos_hi = FOC_SIMD_HI_B16(angle->cos);
+  int32_t sin_hi = FOC_SIMD_HI_B16(angle->sin);
+  b16_t   d      = dq->d;
+  b16_t   q      = dq->q;
+
+  ab->a = foc_simd_sub_b16(foc_simd_mla_b16(__smulwb(d, cs), d, cos_hi),
+                           foc_simd_mla_b16(__smulwt(q, cs), q, sin_hi));
+  ab->b = foc_simd_dot2_b16(q, d, cs, cos_hi, sin_hi);
+#else
+  b16_t d = dq->d;
+  b16_t q = dq->q;
+
+  ab->a = b16mulb16(angle->cos, d) - b16mulb16(angle->sin, q);
+  ab->b = b16mulb16(angle->cos, q) + b16mulb16(angle->sin, d);
+#endif
+}
+
+/****************************************************************************
+ * Name: foc_simd_scale_b16
+ *
+ * Description:
+ *   Scale ab frame by a common factor, bit-exact with b16mulb16() applied
+ *   to each component
+ *
+ ****************************************************************************/
+
+static inline void foc_simd_scale_b16(FAR ab_frame_b16_t *in, b16_t scale,
+                                      FAR ab_frame_b16_t *out)
+{
+#ifdef __ARM_FEATURE_DSP
+  int32_t hi = FOC_SIMD_HI_B16(scale);
+
+  out->a = foc_simd_mla_b16(__smulwb(in->a, scale), in->a, hi);
+  out->b = foc_simd_mla_b16(__smulwb(in->b, scale), in->b, hi);
+#else
+  out->a = b16mulb16(in->a, scale);
+  out->b = b16mulb16(in->b, scale);
+#endif
+}
+
+/****************************************************************************
+ * Name: foc_simd_iabc_update_b16
+ *
+ * Description:
+ *   Update FOC controller with phase currents, drop-in replacement for
+ *   foc_iabc_update_b16()
+ *
+ ****************************************************************************/
+
+static inline void foc_simd_iabc_update_b16(FAR struct foc_data_b16_s *foc,
+                                            FAR abc_frame_b16_t *i_abc)
+{
+  foc->i_abc.a = i_abc->a;
+  foc->i_abc.b = i_abc->b;
+  foc->i_abc.c = i_abc->c;
+
+  foc_simd_clarke_b16(&foc->i_abc, &foc->i_ab);
+  foc_simd_park_b16(&foc->angle, &foc->i_ab, &foc->i_dq);
+}
+
+/****************************************************************************
+ * Name: foc_simd_voltage_control_b16
+ *
+ * Description:
+ *   FOC voltage control, drop-in replacement for foc_voltage_control_b16()
+ *
+ ****************************************************************************/
+
+static inline void
+foc_simd_voltage_control_b16(FAR struct foc_data_b16_s *foc,
+                             FAR dq_frame_b16_t *vdq_ref)
+{
+  foc->v_dq.d = vdq_ref->d;
+  foc->v_dq.q = vdq_ref->q;
+
+  foc_simd_inv_park_b16(&foc->angle, &foc->v_dq, &foc->v_ab);
+
+#ifdef CONFIG_LIBDSP_FOC_VABC
+  inv_clarke_transform_b16(&foc->v_ab, &foc->v_abc);
+#endif
+
+  foc_simd_scale_b16(&foc->v_ab, foc->vab_mod_scale, &foc->v_ab_mod);
+}
+
+#endif /* __INDUSTRY_FOC_FIXED16_FOC_SIMD_H */
@@ -89,6 +89,11 @@ struct foc_angle_ops_f32_s
   CODE int (*run)(FAR foc_angle_f32_t *h,
                   FAR struct foc_angle_in_f32_s *in,
                   FAR struct foc_angle_out_f32_s *out);
+
+  /* Update motor parameters (optional) */
+
+  CODE int (*phy)(FAR foc_angle_f32_t *h,
+                  FAR struct motor_phy_params_f32_s *phy);
 };
 
 /* Angle handler - sensor or sensorless */
@@ -225,4 +230,22 @@ int foc_angle_run_f32(FAR foc_angle_f32_t *h,
                       FAR struct foc_angle_in_f32_s *in,
                       FAR struct foc_angle_out_f32_s *out);
 
+/****************************************************************************
+ * Name: foc_angle_phy_f32
+ ****************************************************************************/
+
+int foc_angle_phy_f32(FAR foc_angle_f32_t *h,
+                      FAR struct motor_phy_params_f32_s *phy);
+
+#if defined(CONFIG_INDUSTRY_FOC_STATIC) && \
+    !defined(CONFIG_INDUSTRY_FOC_STATIC_ANGLE_NONE)
+/****************************************************************************
+ * Name: foc_angle_static_run_f32
+ ****************************************************************************/
+
+int foc_angle_static_run_f32(FAR foc_angle_f32_t *h,
+                             FAR struct foc_angle_in_f32_s *in,
+                             FAR struct foc_angle_out_f32_s *out);
+#endif
+
 #endif /* __INDUSTRY_FOC_FLOAT_FOC_ANGLE_H */
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * apps/include/industry/foc/float/foc_batch.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INDUSTRY_FOC_FLOAT_FOC_BATCH_H
+#define __INDUSTRY_FOC_FLOAT_FOC_BATCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <dsp.h>
+
+#include "industry/foc/float/foc_handler.h"
+#include "industry/foc/float/foc_angle.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FOC_BATCH_MOTORS CONFIG_INDUSTRY_FOC_BATCH_MOTORS
+
+/****************************************************************************
+ * Public Type Definition
+ ****************************************************************************/
+
+/* Input to batched FOC controller, one element per motor */
+
+struct foc_batch_input_f32_s
+{
+  float          current[FOC_BATCH_MOTORS][CONFIG_MOTOR_FOC_PHASES];
+  dq_frame_f32_t dq_ref[FOC_BATCH_MOTORS];   /* DQ reference frame */
+  dq_frame_f32_t vdq_comp[FOC_BATCH_MOTORS]; /* DQ voltage compensation */
+  float          angle[FOC_BATCH_MOTORS];    /* Phase angle (no observer) */
+  float          vel[FOC_BATCH_MOTORS];      /* Velocity (observer input) */
+  float          dir[FOC_BATCH_MOTORS];      /* Direction (observer input) */
+  float          vbus[FOC_BATCH_MOTORS];     /* Bus voltage */
+  int            mode[FOC_BATCH_MOTORS];     /* Controller mode */
+};
+
+/* Output from batched FOC controller, one element per motor */
+
+struct foc_batch_output_f32_s
+{
+  float duty[FOC_BATCH_MOTORS][CONFIG_MOTOR_FOC_PHASES];
+  float angle[FOC_BATCH_MOTORS];     /* Electrical angle used */
+  int   ret[FOC_BATCH_MOTORS];       /* Controller status */
+};
+
+/* Batched FOC controller data.
+ *
+ * Each stage (angle, controller input, controller, modulation) is run for
+ * all motors before the next one, so one thread can service all motors
+ * in one PWM period.
+ */
+
+struct foc_batch_f32_s
+{
+  uint8_t                 motors;                      /* Attached motors */
+  FAR foc_handler_f32_t  *handler[FOC_BATCH_MOTORS];   /* FOC handlers */
+  FAR foc_angle_f32_t    *obs[FOC_BATCH_MOTORS];       /* Angle handlers */
+  uint8_t                 poles[FOC_BATCH_MOTORS];     /* Pole pairs */
+  float                   angle[FOC_BATCH_MOTORS];     /* Last angle */
+  float                   vbase[FOC_BATCH_MOTORS];     /* Base voltage */
+  ab_frame_f32_t          v_ab_mod[FOC_BATCH_MOTORS];  /* Modulation */
+  struct foc_state_f32_s  state[FOC_BATCH_MOTORS];     /* Last state */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_batch_init_f32
+ ****************************************************************************/
+
+void foc_batch_init_f32(FAR struct foc_batch_f32_s *b);
+
+/****************************************************************************
+ * Name: foc_batch_add_f32
+ ****************************************************************************/
+
+int foc_batch_add_f32(FAR struct foc_batch_f32_s *b,
+                      FAR foc_handler_f32_t *h,
+                      FAR foc_angle_f32_t *obs,
+                      uint8_t poles);
+
+/****************************************************************************
+ * Name: foc_batch_run_f32
+ ****************************************************************************/
+
+int foc_batch_run_f32(FAR struct foc_batch_f32_s *b,
+                      FAR struct foc_batch_input_f32_s *in,
+                      FAR struct foc_batch_output_f32_s *out);
+
+/****************************************************************************
+ * Name: foc_batch_state_f32
+ ****************************************************************************/
+
+FAR struct foc_state_f32_s *
+foc_batch_state_f32(FAR struct foc_batch_f32_s *b, uint8_t i);
+
+#endif /* __INDUSTRY_FOC_FLOAT_FOC_BATCH_H */
@@ -0,0 +1,122 @@
+/****************************************************************************
+ * apps/include/industry/foc/float/foc_ident_online.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INDUSTRY_FOC_FLOAT_FOC_IDENT_ONLINE_H
+#define __INDUSTRY_FOC_FLOAT_FOC_IDENT_ONLINE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <dsp.h>
+
+#include "industry/foc/float/foc_handler.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Estimated parameters: phase resistance, phase inductance, flux linkage */
+
+#define FOC_IDENT_ONLINE_PARAMS (3)
+
+/****************************************************************************
+ * Public Type Definition
+ ****************************************************************************/
+
+/* Online identification configuration */
+
+struct foc_ident_online_cfg_f32_s
+{
+  struct motor_phy_params_f32_s phy; /* Initial motor parameters */
+  float    per;                      /* Controller period in sec */
+  float    forget;                   /* RLS forgetting factor (0.0, 1.0] */
+  float    vel_min;                  /* Minimum electrical velocity */
+  uint16_t decim;                    /* Control cycles per RLS update */
+};
+
+/* Online identification data.
+ *
+ * The estimator averages the DQ currents, DQ voltages and electrical
+ * velocity over cfg.decim control cycles and then runs one recursive least
+ * squares update with the PMSM DQ voltage equations:
+ *
+ *   vd = R * id + L * (did/dt - we * iq)
+ *   vq = R * iq + L * (diq/dt + we * id) + flux * we
+ *
+ * so the cost in most control cycles is a few additions.
+ */
+
+struct foc_ident_online_f32_s
+{
+  struct foc_ident_online_cfg_f32_s cfg;
+
+  float          theta[FOC_IDENT_ONLINE_PARAMS];  /* R, L, flux */
+  float          p[FOC_IDENT_ONLINE_PARAMS][FOC_IDENT_ONLINE_PARAMS];
+  float          p0[FOC_IDENT_ONLINE_PARAMS];     /* Initial covariance */
+  dq_frame_f32_t idq_sum;                         /* Window accumulators */
+  dq_frame_f32_t vdq_sum;
+  float          vel_sum;
+  dq_frame_f32_t idq_last;                        /* Last window current */
+  bool           last_valid;
+  uint16_t       cntr;
+  uint32_t       updates;                         /* RLS updates done */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_ident_online_init_f32
+ ****************************************************************************/
+
+int foc_ident_online_init_f32(FAR struct foc_ident_online_f32_s *id,
+                              FAR struct foc_ident_online_cfg_f32_s *cfg);
+
+/****************************************************************************
+ * Name: foc_ident_online_reset_f32
+ ****************************************************************************/
+
+void foc_ident_online_reset_f32(FAR struct foc_ident_online_f32_s *id);
+
+/****************************************************************************
+ * Name: foc_ident_online_run_f32
+ ****************************************************************************/
+
+bool foc_ident_online_run_f32(FAR struct foc_ident_online_f32_s *id,
+                              FAR struct foc_state_f32_s *state,
+                              float vel);
+
+/****************************************************************************
+ * Name: foc_ident_online_phy_get_f32
+ ****************************************************************************/
+
+void foc_ident_online_phy_get_f32(FAR struct foc_ident_online_f32_s *id,
+                                  FAR struct motor_phy_params_f32_s *phy);
+
+#endif /* __INDUSTRY_FOC_FLOAT_FOC_IDENT_ONLINE_H */
@@ -0,0 +1,125 @@
+/****************************************************************************
+ * apps/include/industry/foc/float/foc_trig.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INDUSTRY_FOC_FLOAT_FOC_TRIG_H
+#define __INDUSTRY_FOC_FLOAT_FOC_TRIG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FOC_TRIG_2PI        (2.0f * M_PI_F)
+#define FOC_TRIG_ONE_BY_2PI (1.0f / (2.0f * M_PI_F))
+
+#ifdef CONFIG_INDUSTRY_FOC_TRIG_LUT
+/* Sine table entries per period */
+
+#  define FOC_TRIG_LUT_SIZE (1 << CONFIG_INDUSTRY_FOC_TRIG_LUT_BITS)
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_angle_wrap_f32
+ *
+ * Description:
+ *   Normalize angle to <bottom, top> range, where top - bottom = 2PI.
+ *   Drop-in replacement for angle_norm_2pi() that does not loop when the
+ *   angle is many periods away from the range.
+ *
+ * Input Parameter:
+ *   angle  - (in/out) pointer to angle in rad
+ *   bottom - lower bound
+ *   top    - upper bound
+ *
+ ****************************************************************************/
+
+static inline void foc_angle_wrap_f32(FAR float *angle, float bottom,
+                                      float top)
+{
+  float a = *angle;
+
+  if (a > top)
+    {
+      a -= FOC_TRIG_2PI * (int32_t)((a - bottom) * FOC_TRIG_ONE_BY_2PI);
+    }
+  else if (a < bottom)
+    {
+      a += FOC_TRIG_2PI * (int32_t)((top - a) * FOC_TRIG_ONE_BY_2PI);
+    }
+
+  /* Rounding can leave the result one period off */
+
+  if (a > top)
+    {
+      a -= FOC_TRIG_2PI;
+    }
+  else if (a < bottom)
+    {
+      a += FOC_TRIG_2PI;
+    }
+
+  *angle = a;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_INDUSTRY_FOC_TRIG_LUT
+/* The table serves the PI controller phase angle only. The libdsp angle
+ * observers used by foc_ang_osmo.c and foc_ang_onfo.c compute their own
+ * sine and cosine internally and can't be routed through it.
+ */
+
+/****************************************************************************
+ * Name: foc_trig_init_f32
+ ****************************************************************************/
+
+void foc_trig_init_f32(void);
+
+/****************************************************************************
+ * Name: foc_sincos_f32
+ ****************************************************************************/
+
+void foc_sincos_f32(float a, FAR float *s, FAR float *c);
+
+/****************************************************************************
+ * Name: foc_trig_angle_f32
+ ****************************************************************************/
+
+void foc_trig_angle_f32(FAR phase_angle_f32_t *angle, float a);
+#endif
+
+#endif /* __INDUSTRY_FOC_FLOAT_FOC_TRIG_H */
@@ -0,0 +1,113 @@
+/****************************************************************************
+ * apps/include/industry/mbcrc.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_INDUSTRY_MBCRC_H
+#define __APPS_INCLUDE_INDUSTRY_MBCRC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MBCRC_CRC16_INIT 0xffff
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_MBCRC_HW_HOOK
+/* Hardware CRC16 hook, see mbcrc_crc16_set_hook() */
+
+typedef CODE uint16_t (*mbcrc_crc16_hook_t)(FAR const uint8_t *buf,
+                                            size_t len, uint16_t crc);
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mbcrc_crc16
+ *
+ * Description:
+ *   Calculate Modbus RTU CRC16 checksum. The low byte is sent first.
+ *
+ ****************************************************************************/
+
+uint16_t mbcrc_crc16(FAR const uint8_t *buf, size_t len);
+
+/****************************************************************************
+ * Name: mbcrc_crc16_part
+ *
+ * Description:
+ *   Continue a Modbus RTU CRC16 over another part of a frame.
+ *
+ ****************************************************************************/
+
+uint16_t mbcrc_crc16_part(FAR const uint8_t *buf, size_t len,
+                          uint16_t crc);
+
+/****************************************************************************
+ * Name: mbcrc_lrc
+ *
+ * Description:
+ *   Calculate Modbus ASCII LRC checksum.
+ *
+ ****************************************************************************/
+
+uint8_t mbcrc_lrc(FAR const uint8_t *buf, size_t len);
+
+#ifdef CONFIG_MBCRC_HW_HOOK
+/****************************************************************************
+ * Name: mbcrc_crc16_set_hook
+ *
+ * Description:
+ *   Route the CRC16 calculation to a hardware CRC unit.
+ *
+ ****************************************************************************/
+
+void mbcrc_crc16_set_hook(mbcrc_crc16_hook_t hook);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APPS_INCLUDE_INDUSTRY_MBCRC_H */
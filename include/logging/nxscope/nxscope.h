@@ -33,6 +33,10 @@
 #include <pthread.h>
 #include <stdint.h>
 
+#ifdef CONFIG_LOGGING_NXSCOPE_STAGE
+#  include <stdatomic.h>
+#endif
+
 #include <logging/nxscope/nxscope_chan.h>
 #include <logging/nxscope/nxscope_intf.h>
 #include <logging/nxscope/nxscope_proto.h>
@@ -106,9 +110,9 @@ enum nxscope_info_flags_e
 {
   NXSCOPE_FLAGS_DIVIDER_SUPPORT   = (1 << 0),
   NXSCOPE_FLAGS_ACK_SUPPORT       = (1 << 1),
-  NXSCOPE_FLAGS_RES2              = (1 << 2),
-  NXSCOPE_FLAGS_RES3              = (1 << 3),
-  NXSCOPE_FLAGS_RES4              = (1 << 4),
+  NXSCOPE_FLAGS_BLOCK_SUPPORT     = (1 << 2),
+  NXSCOPE_FLAGS_DELTA_SUPPORT     = (1 << 3),
+  NXSCOPE_FLAGS_LZ_SUPPORT        = (1 << 4),
   NXSCOPE_FLAGS_RES5              = (1 << 5),
   NXSCOPE_FLAGS_RES6              = (1 << 6),
   NXSCOPE_FLAGS_RES7              = (1 << 7),
@@ -118,14 +122,33 @@ enum nxscope_info_flags_e
 
 enum nxscope_stream_flags_s
 {
-  NXSCOPE_STREAM_FLAGS_OVERFLOW = (1 << 0)
+  NXSCOPE_STREAM_FLAGS_OVERFLOW = (1 << 0),
+  NXSCOPE_STREAM_FLAGS_DELTA    = (1 << 1), /* Samples delta encoded */
+  NXSCOPE_STREAM_FLAGS_LZ       = (1 << 2), /* Samples LZ compressed */
+  NXSCOPE_STREAM_FLAGS_TRIGGER  = (1 << 3), /* First frame of a capture */
+  NXSCOPE_STREAM_FLAGS_BLOCK    = (1 << 4)  /* Frame has block entries */
+};
+
+/* Nxscope start frame flags.
+ *
+ * Bit 0 starts/stops the stream. The other bits request a stream encoding,
+ * only encodings advertised in the common info flags can be requested.
+ */
+
+enum nxscope_start_flags_e
+{
+  NXSCOPE_START_STREAM = (1 << 0), /* Start stream */
+  NXSCOPE_START_DELTA  = (1 << 1), /* Request delta encoding */
+  NXSCOPE_START_LZ     = (1 << 2)  /* Request LZ compression */
 };
 
 /* Nxscope start frame data */
 
 begin_packed_struct struct nxscope_start_data_s
 {
-  uint8_t  start;                        /* Start/stop flag */
+  uint8_t  start;                        /* Start flags
+                                          * (enum nxscope_start_flags_e)
+                                          */
 } end_packed_struct;
 
 /* Nxscope enable channel data */
@@ -248,6 +271,143 @@ struct nxscope_stream_s
   struct nxscope_sample_s samples[1];        /* stream samples */
 };
 
+/* Nxscope block entry:
+ *
+ *   +----------+----------+----------+---------------------------+
+ *   | 0xff     | channel  | count    | samples data              |
+ *   +----------+----------+----------+---------------------------+
+ *   | 1B       | 1B       | 2B       | count * (n + m) bytes [1] |
+ *   +----------+----------+----------+---------------------------+
+ *
+ *   Samples put with nxscope_put_block_m() are stored in stream frames as
+ *   block entries, in order with the other samples. 0xff is never a valid
+ *   channel ID, so a block entry starts where a sample would otherwise
+ *   start with its channel ID. Frames with block entries have the
+ *   NXSCOPE_STREAM_FLAGS_BLOCK flag set.
+ *
+ *   [1] - consecutive samples of one channel without channel id,
+ *         each sample is vector data (n bytes) followed by metadata
+ *         (m bytes) as in struct nxscope_sample_s.
+ *         NOTE: count and sample data always little-endian !
+ *
+ */
+
+#define NXSCOPE_BLOCK_ID 0xff
+
+begin_packed_struct struct nxscope_block_s
+{
+  uint8_t  id;                           /* NXSCOPE_BLOCK_ID */
+  uint8_t  chan;                         /* Channel id */
+  uint16_t count;                        /* Number of samples */
+  uint8_t  data[1];                      /* Samples data */
+} end_packed_struct;
+
+/* Nxscope encoded samples data.
+ *
+ * Encodings are applied to the samples data of stream frames and reported
+ * in the frame flags. If both are set, the delta encoding is applied
+ * first.
+ *
+ * NXSCOPE_STREAM_FLAGS_DELTA:
+ *   Integer and fixed-point vector elements are replaced with the
+ *   difference to the same element of the previous sample of this channel
+ *   in this frame (or 0 for the first one), encoded as a zigzag varint
+ *   (LEB128). Other data types, channel IDs, block entry headers and
+ *   metadata are not changed.
+ *
+ * NXSCOPE_STREAM_FLAGS_LZ:
+ *   Sequence of tokens:
+ *     0x00-0x7f - literal run, (token + 1) bytes follow
+ *     0x80-0xff - match of ((token & 0x7f) + 3) bytes, followed by
+ *                 a 2B little-endian distance back in the decoded data
+ *
+ */
+
+#ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+/* Nxscope channel decimation mode.
+ *
+ * The decimation factor is the channel divider + 1.
+ */
+
+enum nxscope_dec_mode_e
+{
+  NXSCOPE_DEC_SKIP    = 0,      /* Keep one sample (default) */
+  NXSCOPE_DEC_AVERAGE = 1,      /* Average of the samples */
+  NXSCOPE_DEC_MINMAX  = 2       /* Two samples: minimum and maximum */
+};
+
+/* Nxscope channel decimation data */
+
+struct nxscope_dec_s
+{
+  uint8_t      mode;            /* Decimation mode */
+  uint32_t     n;               /* Samples in the current window */
+  FAR double  *acc;             /* Sum, min and max, 3 * vdim elements */
+  FAR uint8_t *out;             /* Decimated vectors, 2 * vdim elements */
+};
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+/* Nxscope trigger mode */
+
+enum nxscope_trig_mode_e
+{
+  NXSCOPE_TRIG_OFF     = 0,     /* No trigger, continuous stream */
+  NXSCOPE_TRIG_RISING  = 1,     /* Rising edge through level */
+  NXSCOPE_TRIG_FALLING = 2,     /* Falling edge through level */
+  NXSCOPE_TRIG_EDGE    = 3,     /* Any edge through level */
+  NXSCOPE_TRIG_ABOVE   = 4,     /* Value above level */
+  NXSCOPE_TRIG_BELOW   = 5,     /* Value below level */
+  NXSCOPE_TRIG_INSIDE  = 6,     /* Value inside [level, level2] */
+  NXSCOPE_TRIG_OUTSIDE = 7      /* Value outside [level, level2] */
+};
+
+/* Nxscope trigger state */
+
+enum nxscope_trig_state_e
+{
+  NXSCOPE_TRIG_ARMED     = 0,   /* Waiting for trigger */
+  NXSCOPE_TRIG_TRIGGERED = 1,   /* Capturing post-trigger samples */
+  NXSCOPE_TRIG_HOLD      = 2,   /* Capture sent out, re-arm when empty */
+  NXSCOPE_TRIG_DONE      = 3    /* Single capture complete */
+};
+
+/* Nxscope trigger configuration */
+
+struct nxscope_trig_cfg_s
+{
+  uint8_t  mode;                /* Trigger mode */
+  uint8_t  chan;                /* Source channel */
+  uint8_t  idx;                 /* Source vector element */
+  bool     single;              /* Stop after one capture */
+  float    level;               /* Level (lower window level) */
+  float    level2;              /* Upper window level */
+  uint32_t pre;                 /* Pre-trigger source samples */
+  uint32_t post;                /* Post-trigger source samples */
+};
+
+/* Nxscope trigger data */
+
+struct nxscope_trig_s
+{
+  struct nxscope_trig_cfg_s cfg;
+  uint8_t                   state;
+  bool                      fired;
+  bool                      prev_valid;
+  float                     prev;
+  uint32_t                  pre;
+  uint32_t                  post;
+
+  /* Capture buffer */
+
+  FAR uint8_t              *buf;
+  size_t                    len;
+  size_t                    head;
+  size_t                    tail;
+  size_t                    used;
+};
+#endif
+
 /* Nxscope callbacks */
 
 struct nxscope_callbacks_s
@@ -322,6 +482,15 @@ struct nxscope_cfg_s
   size_t cribuf_len;
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+  /* Trigger capture buffer len.
+   *
+   * Holds the pre-trigger samples and the capture not yet sent out.
+   */
+
+  size_t trigbuf_len;
+#endif
+
   /* RX padding.
    *
    * This option will be provided for client in common info data
@@ -331,6 +500,40 @@ struct nxscope_cfg_s
   uint8_t rx_padding;
 };
 
+#ifdef CONFIG_LOGGING_NXSCOPE_STAGE
+/* Nxscope producer staging buffer.
+ *
+ * Single-producer/single-consumer ring with samples already encoded in the
+ * stream format. The producer writes without taking the nxscope lock,
+ * the samples are moved to the stream buffer by nxscope_stream().
+ *
+ * head and tail are free-running byte counters, the ring offset is
+ * (counter & (len - 1)). A sample never wraps around the ring end, the
+ * unused space at the end is marked with NXSCOPE_STAGE_WRAP.
+ */
+
+struct nxscope_stage_s
+{
+  FAR struct nxscope_s        *s;
+  FAR struct nxscope_stage_s  *next;
+
+  /* Ring buffer, len is a power of two */
+
+  FAR uint8_t                 *buf;
+  size_t                       len;
+
+  /* Written only by the producer */
+
+  atomic_size_t                head;
+  atomic_uint                  overflow;
+
+  /* Written only by the consumer */
+
+  atomic_size_t                tail;
+  unsigned int                 overflow_seen;
+};
+#endif
+
 /* Nxscope data */
 
 struct nxscope_s
@@ -362,6 +565,9 @@ struct nxscope_s
 
 #ifdef CONFIG_LOGGING_NXSCOPE_DIVIDER
   FAR uint32_t                *cntr;
+#endif
+#ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+  FAR struct nxscope_dec_s    *dec;
 #endif
   uint8_t                      start;
 
@@ -371,6 +577,7 @@ struct nxscope_s
   size_t                       streambuf_len;
   size_t                       stream_i;
   bool                         stream_retry;
+  uint32_t                     stream_ovf;
 
 #ifdef CONFIG_LOGGING_NXSCOPE_CRICHANNELS
   /* Critical buffer data */
@@ -390,6 +597,27 @@ struct nxscope_s
   FAR uint8_t                 *txbuf;
   size_t                       txbuf_len;
 
+#ifdef CONFIG_LOGGING_NXSCOPE_ENCODE
+  /* Stream encoding data */
+
+  uint8_t                      encode;
+  FAR uint8_t                 *encbuf;
+  FAR size_t                  *enclast;
+  FAR uint16_t                *lzhash;
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+  /* Trigger data */
+
+  struct nxscope_trig_s        trig;
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_STAGE
+  /* Producers staging buffers */
+
+  FAR struct nxscope_stage_s  *stage;
+#endif
+
   /* Exclusive access */
 
   pthread_mutex_t              lock;
@@ -496,6 +724,135 @@ int nxscope_recv(FAR struct nxscope_s *s);
 
 int nxscope_stream_start(FAR struct nxscope_s *s, bool start);
 
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+/****************************************************************************
+ * Name: nxscope_trig_set
+ *
+ * Description:
+ *   Configure and arm the trigger.
+ *
+ *   While armed, samples are kept in the trigger buffer, only the newest
+ *   cfg->pre samples of the source channel (and the samples of other
+ *   channels between them) are kept. When the trigger condition is met,
+ *   the buffer and cfg->post further samples of the source channel are
+ *   sent out at full resolution. Levels are in channel units (real values
+ *   for fixed-point types).
+ *
+ * Input Parameters:
+ *   s   - a pointer to a nxscope instance
+ *   cfg - a pointer to a trigger configuration
+ *
+ ****************************************************************************/
+
+int nxscope_trig_set(FAR struct nxscope_s *s,
+                     FAR const struct nxscope_trig_cfg_s *cfg);
+
+/****************************************************************************
+ * Name: nxscope_trig_arm
+ *
+ * Description:
+ *   Discard the captured samples and arm the trigger again
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+int nxscope_trig_arm(FAR struct nxscope_s *s);
+
+/****************************************************************************
+ * Name: nxscope_trig_state
+ *
+ * Description:
+ *   Get the trigger state (enum nxscope_trig_state_e)
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+int nxscope_trig_state(FAR struct nxscope_s *s);
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_STAGE
+/****************************************************************************
+ * Name: nxscope_stage_init
+ *
+ * Description:
+ *   Initialize a producer staging buffer and attach it to a nxscope
+ *   instance.
+ *
+ *   Samples put with nxscope_stage_put() don't take the nxscope lock.
+ *   Each staging buffer must be used by a single producer thread and each
+ *   channel must be fed from a single staging buffer.
+ *
+ * Input Parameters:
+ *   s     - a pointer to a nxscope instance
+ *   stage - a pointer to a staging buffer
+ *   len   - staging buffer size in bytes (rounded up to a power of two)
+ *
+ ****************************************************************************/
+
+int nxscope_stage_init(FAR struct nxscope_s *s,
+                       FAR struct nxscope_stage_s *stage, size_t len);
+
+/****************************************************************************
+ * Name: nxscope_stage_deinit
+ *
+ * Description:
+ *   Detach a staging buffer from its nxscope instance and free it.
+ *   Samples not yet merged into the stream are lost.
+ *
+ * Input Parameters:
+ *   stage - a pointer to a staging buffer
+ *
+ ****************************************************************************/
+
+void nxscope_stage_deinit(FAR struct nxscope_stage_s *stage);
+
+/****************************************************************************
+ * Name: nxscope_stage_put_m
+ *
+ * Description:
+ *   Put a sample with metadata on a staging buffer. The data type is the
+ *   type of the channel.
+ *
+ *   This function never blocks. If there is no space in the staging
+ *   buffer the sample is dropped and the stream overflow flag is set.
+ *   Critical channels are not supported.
+ *
+ * Input Parameters:
+ *   stage - a pointer to a staging buffer
+ *   ch    - a channel id
+ *   val   - a pointer to a sample data vector
+ *   d     - a dimmention of sample data vector
+ *   meta  - a pointer to metadata
+ *   mlen  - a length of metadata
+ *
+ ****************************************************************************/
+
+int nxscope_stage_put_m(FAR struct nxscope_stage_s *stage, uint8_t ch,
+                        FAR void *val, uint8_t d,
+                        FAR uint8_t *meta, uint8_t mlen);
+
+/****************************************************************************
+ * Name: nxscope_stage_put
+ *
+ * Description:
+ *   Put a sample on a staging buffer
+ *
+ * Input Parameters:
+ *   stage - a pointer to a staging buffer
+ *   ch    - a channel id
+ *   val   - a pointer to a sample data vector
+ *   d     - a dimmention of sample data vector
+ *
+ ****************************************************************************/
+
+int nxscope_stage_put(FAR struct nxscope_stage_s *stage, uint8_t ch,
+                      FAR void *val, uint8_t d);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -154,6 +154,24 @@ int nxscope_chan_en(FAR struct nxscope_s *s, uint8_t chan, bool en);
 int nxscope_chan_div(FAR struct nxscope_s *s, uint8_t chan, uint8_t div);
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+/****************************************************************************
+ * Name: nxscope_chan_dec
+ *
+ * Description:
+ *   Configure decimation mode for a given channel. The channel must be
+ *   initialized and have a numerical type.
+ *
+ * Input Parameters:
+ *   s    - a pointer to a nxscope instance
+ *   chan - a channel id
+ *   mode - decimation mode (enum nxscope_dec_mode_e)
+ *
+ ****************************************************************************/
+
+int nxscope_chan_dec(FAR struct nxscope_s *s, uint8_t chan, uint8_t mode);
+#endif
+
 /****************************************************************************
  * Name: nxscope_chan_all_en
  *
@@ -375,6 +393,57 @@ int nxscope_put_user_m(FAR struct nxscope_s *s, uint8_t ch, uint8_t type,
                        FAR uint8_t *meta, uint8_t mlen);
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_BLOCK
+/****************************************************************************
+ * Name: nxscope_put_block_m
+ *
+ * Description:
+ *   Put n consecutive samples of a channel on the stream buffer.
+ *
+ *   The channel is validated once for the whole block and samples are
+ *   packed in block entries without the channel id. The data type is the
+ *   type of the channel. The samples are sent by nxscope_stream() in order
+ *   with the other samples. If the stream buffer gets full, the remaining
+ *   samples are dropped and -ENOBUFS is returned.
+ *
+ *   Critical channels are not supported and return -EINVAL, they must be
+ *   sent sample by sample through the critical channel buffer.
+ *
+ * Input Parameters:
+ *   s    - a pointer to a nxscope instance
+ *   ch   - a channel id
+ *   val  - a pointer to n sample data vectors
+ *   d    - a dimmention of sample data vector
+ *   meta - a pointer to n metadata (can be NULL if mlen is 0)
+ *   mlen - a length of metadata for one sample
+ *   n    - number of samples
+ *
+ ****************************************************************************/
+
+int nxscope_put_block_m(FAR struct nxscope_s *s, uint8_t ch,
+                        FAR void *val, uint8_t d,
+                        FAR uint8_t *meta, uint8_t mlen, size_t n);
+
+/****************************************************************************
+ * Name: nxscope_put_block
+ *
+ * Description:
+ *   Put n consecutive samples of a channel on the stream buffer, see
+ *   nxscope_put_block_m(). Critical channels return -EINVAL.
+ *
+ * Input Parameters:
+ *   s   - a pointer to a nxscope instance
+ *   ch  - a channel id
+ *   val - a pointer to n sample data vectors
+ *   d   - a dimmention of sample data vector
+ *   n   - number of samples
+ *
+ ****************************************************************************/
+
+int nxscope_put_block(FAR struct nxscope_s *s, uint8_t ch,
+                      FAR void *val, uint8_t d, size_t n);
+#endif
+
 /****************************************************************************
  * Name: nxscope_put_user_m
  *
@@ -84,7 +84,7 @@ struct nxscope_intf_s
 
 struct nxscope_dummy_cfg_s
 {
-  int res;                      /* Reserved */
+  bool nodump;                  /* Don't dump frames (benchmarks) */
 };
 #endif
 
@@ -109,6 +109,26 @@ struct nxscope_udp_cfg_s
 };
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_RING
+/* Nxscope RAM ring interface configuration */
+
+struct nxscope_ring_cfg_s
+{
+  size_t    len;                /* RAM ring size in bytes */
+  size_t    pretrig;            /* Bytes kept from before the trigger */
+  FAR char *path;               /* Default flush file path (optional) */
+};
+
+/* Nxscope RAM ring interface state */
+
+enum nxscope_ring_state_e
+{
+  NXSCOPE_RING_ARMED     = 0,   /* Keep the newest pretrig bytes */
+  NXSCOPE_RING_TRIGGERED = 1,   /* Fill the rest of the ring */
+  NXSCOPE_RING_DONE      = 2    /* Capture complete, frames dropped */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -158,6 +178,75 @@ int nxscope_udp_init(FAR struct nxscope_intf_s *intf,
 void nxscope_udp_deinit(FAR struct nxscope_intf_s *intf);
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_INTF_RING
+/****************************************************************************
+ * Name: nxscope_ring_init
+ *
+ * Description:
+ *   Initialize a RAM ring interface.
+ *
+ *   Frames are stored in a preallocated RAM ring. While armed, only the
+ *   newest cfg->pretrig bytes of frames are kept. After the trigger, the
+ *   rest of the ring is filled and the capture is complete. The ring
+ *   never receives data, so there is no host command handling.
+ *
+ ****************************************************************************/
+
+int nxscope_ring_init(FAR struct nxscope_intf_s *intf,
+                      FAR struct nxscope_ring_cfg_s *cfg);
+
+/****************************************************************************
+ * Name: nxscope_ring_deinit
+ ****************************************************************************/
+
+void nxscope_ring_deinit(FAR struct nxscope_intf_s *intf);
+
+/****************************************************************************
+ * Name: nxscope_ring_arm
+ *
+ * Description:
+ *   Discard the captured frames and arm the trigger again
+ *
+ ****************************************************************************/
+
+void nxscope_ring_arm(FAR struct nxscope_intf_s *intf);
+
+/****************************************************************************
+ * Name: nxscope_ring_trigger
+ *
+ * Description:
+ *   Trigger the capture. Can be called from any context, the trigger
+ *   applies from the next frame.
+ *
+ ****************************************************************************/
+
+void nxscope_ring_trigger(FAR struct nxscope_intf_s *intf);
+
+/****************************************************************************
+ * Name: nxscope_ring_state
+ *
+ * Description:
+ *   Get the capture state (enum nxscope_ring_state_e)
+ *
+ ****************************************************************************/
+
+int nxscope_ring_state(FAR struct nxscope_intf_s *intf);
+
+/****************************************************************************
+ * Name: nxscope_ring_flush
+ *
+ * Description:
+ *   Write the captured frames, from the oldest one, to a file. The file
+ *   holds the protocol frames as they would be sent over a serial link.
+ *   If path is NULL, cfg->path is used. Returns the number of bytes
+ *   written or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t nxscope_ring_flush(FAR struct nxscope_intf_s *intf,
+                           FAR const char *path);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -31,10 +31,37 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include <nxmodbus/nxmodbus.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Register table read by nxmb_read_batch() and nxmb_scan(). */
+
+enum nxmb_regtype_e
+{
+  NXMB_REGTYPE_HOLDING = 0,     /* Holding registers (FC03) */
+  NXMB_REGTYPE_INPUT            /* Input registers (FC04) */
+};
+
+/* One register read of nxmb_read_batch() or nxmb_scan(). result is set
+ * for every entry, so a failed read does not hide the others.
+ */
+
+struct nxmb_read_s
+{
+  FAR uint16_t        *buf;     /* Destination for count registers */
+  uint16_t             addr;    /* First register address */
+  uint16_t             count;   /* Number of registers */
+  uint8_t              uid;     /* Remote unit identifier */
+  enum nxmb_regtype_e  type;    /* Register table */
+  int                  result;  /* Zero or a negated errno value */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -237,6 +264,57 @@ int nxmb_readwrite_holdings(nxmb_handle_t h, uint8_t uid, uint16_t rd_addr,
                             uint16_t wr_addr, uint16_t wr_count,
                             FAR const uint16_t *wr_buf);
 
+/****************************************************************************
+ * Name: nxmb_read_batch
+ *
+ * Description:
+ *   Read several register ranges from remote units. With Modbus TCP up to
+ *   CONFIG_NXMODBUS_CLIENT_PIPELINE requests are kept in flight and the
+ *   responses are matched by their transaction identifier, so the batch
+ *   takes about one round trip per window instead of one per request.
+ *   Other transports send the requests one at a time.
+ *
+ * Input Parameters:
+ *   h     - The NxModbus client instance.
+ *   reqs  - The reads to perform, count 1-125 each. The result of each
+ *           read is stored in its result field.
+ *   nreqs - The number of entries in reqs.
+ *
+ * Returned Value:
+ *   Zero if all reads succeeded; otherwise the first negated errno value
+ *   from the transport or from reqs.
+ *
+ ****************************************************************************/
+
+int nxmb_read_batch(nxmb_handle_t h, FAR struct nxmb_read_s *reqs,
+                    size_t nreqs);
+
+/****************************************************************************
+ * Name: nxmb_scan
+ *
+ * Description:
+ *   Read a scan list of register ranges. Entries of the same unit and
+ *   register table that overlap or are adjacent (or closer than
+ *   CONFIG_NXMODBUS_CLIENT_SCAN_GAP registers) are merged and read with
+ *   the fewest requests of at most 125 registers, which are then sent as
+ *   with nxmb_read_batch(). The entries may be in any order and of any
+ *   length.
+ *
+ * Input Parameters:
+ *   h      - The NxModbus client instance.
+ *   items  - The scan list. The result of each entry is stored in its
+ *            result field.
+ *   nitems - The number of entries in items.
+ *
+ * Returned Value:
+ *   Zero if all entries were read; otherwise the first negated errno
+ *   value from the scan list.
+ *
+ ****************************************************************************/
+
+int nxmb_scan(nxmb_handle_t h, FAR struct nxmb_read_s *items,
+              size_t nitems);
+
 /****************************************************************************
  * Name: nxmb_set_timeout
  *
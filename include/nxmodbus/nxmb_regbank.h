@@ -0,0 +1,185 @@
+/****************************************************************************
+ * apps/include/nxmodbus/nxmb_regbank.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_NXMODBUS_NXMB_REGBANK_H
+#define __APPS_INCLUDE_NXMODBUS_NXMB_REGBANK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/compiler.h>
+#include <nuttx/config.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include <nxmodbus/nxmodbus.h>
+
+#ifdef CONFIG_NXMODBUS_REGBANK
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Register bank served by the protocol stack without callbacks.
+ *
+ * The application owns the register tables and fills in the table
+ * pointers, start addresses and counts before nxmb_regbank_init().
+ * Registers are kept in host byte order.
+ *
+ * Updates are bracketed by nxmb_regbank_write_begin() and
+ * nxmb_regbank_write_end(). The server reads the tables without a lock
+ * and retries when seq shows that an update ran at the same time, so a
+ * response never mixes old and new values of one update. Modbus writes
+ * to holding registers are applied the same way.
+ */
+
+struct nxmb_regbank_s
+{
+  FAR uint16_t   *holding;       /* Holding registers, NULL if none */
+  FAR uint16_t   *input;         /* Input registers, NULL if none */
+  uint16_t        holding_start; /* Address of holding[0] */
+  uint16_t        holding_count;
+  uint16_t        input_start;   /* Address of input[0] */
+  uint16_t        input_count;
+
+  /* Private data */
+
+  atomic_uint     seq;           /* Odd while an update is in progress */
+  pthread_mutex_t lock;          /* Serializes the updates */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Name: nxmb_regbank_init
+ *
+ * Description:
+ *   Initialize the synchronization of a register bank. The table fields
+ *   must be set before this call and not changed afterwards.
+ *
+ * Input Parameters:
+ *   bank - The register bank.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxmb_regbank_init(FAR struct nxmb_regbank_s *bank);
+
+/****************************************************************************
+ * Name: nxmb_regbank_deinit
+ *
+ * Description:
+ *   Release a register bank. It must not be attached to an instance.
+ *
+ * Input Parameters:
+ *   bank - The register bank.
+ *
+ ****************************************************************************/
+
+void nxmb_regbank_deinit(FAR struct nxmb_regbank_s *bank);
+
+/****************************************************************************
+ * Name: nxmb_regbank_write_begin
+ *
+ * Description:
+ *   Start an update of the register tables. Readers that overlap the
+ *   update retry, other writers wait until nxmb_regbank_write_end().
+ *   Keep the update short, a server thread may wait for it.
+ *
+ * Input Parameters:
+ *   bank - The register bank.
+ *
+ ****************************************************************************/
+
+void nxmb_regbank_write_begin(FAR struct nxmb_regbank_s *bank);
+
+/****************************************************************************
+ * Name: nxmb_regbank_write_end
+ *
+ * Description:
+ *   Finish an update started with nxmb_regbank_write_begin().
+ *
+ * Input Parameters:
+ *   bank - The register bank.
+ *
+ ****************************************************************************/
+
+void nxmb_regbank_write_end(FAR struct nxmb_regbank_s *bank);
+
+/****************************************************************************
+ * Name: nxmb_regbank_read
+ *
+ * Description:
+ *   Copy registers of the bank as one consistent snapshot, e.g. holding
+ *   registers written by Modbus clients.
+ *
+ * Input Parameters:
+ *   bank  - The register bank.
+ *   regs  - The first register to copy, within bank->holding or
+ *           bank->input.
+ *   count - The number of registers to copy.
+ *   buf   - The destination buffer.
+ *
+ ****************************************************************************/
+
+void nxmb_regbank_read(FAR struct nxmb_regbank_s *bank,
+                       FAR const uint16_t *regs, uint16_t count,
+                       FAR uint16_t *buf);
+
+/****************************************************************************
+ * Name: nxmb_set_regbank
+ *
+ * Description:
+ *   Attach a register bank to a server instance. Requests for holding and
+ *   input registers inside the bank are served from it, other addresses
+ *   still go to the callbacks set with nxmb_set_callbacks().
+ *
+ * Input Parameters:
+ *   handle - The NxModbus instance to update.
+ *   bank   - The initialized register bank, NULL to detach.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxmb_set_regbank(nxmb_handle_t handle,
+                     FAR struct nxmb_regbank_s *bank);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NXMODBUS_REGBANK */
+#endif /* __APPS_INCLUDE_NXMODBUS_NXMB_REGBANK_H */
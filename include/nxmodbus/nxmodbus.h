@@ -256,6 +256,12 @@ int nxmb_destroy(nxmb_handle_t handle);
  *   callback table defines how the application exposes coils, discrete
  *   inputs, input registers, and holding registers to the protocol stack.
  *
+ *   With CONFIG_NXMODBUS_TCP_CONCURRENT the callbacks of the read function
+ *   codes (FC01, FC02, FC03 and FC04) may run at the same time on several
+ *   threads and must be reentrant. The callbacks of write and custom
+ *   function codes still run exclusively, no other callback runs at the
+ *   same time.
+ *
  * Input Parameters:
  *   handle - The NxModbus instance to update.
  *   cbs    - The callback table to associate with the instance.
@@ -311,6 +317,10 @@ int nxmb_disable(nxmb_handle_t handle);
  *   single poll of the transport backend and processes one server-side
  *   Modbus transaction when data is available.
  *
+ *   With CONFIG_NXMODBUS_TCP_CONCURRENT, several threads may call this
+ *   function on the same TCP server instance to serve requests in
+ *   parallel.
+ *
  * Input Parameters:
  *   handle - The NxModbus instance to poll.
  *
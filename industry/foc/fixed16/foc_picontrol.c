@@ -32,6 +32,9 @@
 #include <string.h>
 
 #include "industry/foc/fixed16/foc_handler.h"
+#ifdef CONFIG_INDUSTRY_FOC_SIMD
+#  include "industry/foc/fixed16/foc_simd.h"
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -220,7 +223,11 @@ static void foc_control_input_set_b16(FAR foc_handler_b16_t *h,
   i_abc.b = current[1];
   i_abc.c = current[2];
 
+#ifndef CONFIG_INDUSTRY_FOC_SIMD
   foc_iabc_update_b16(&foc->data, &i_abc);
+#else
+  foc_simd_iabc_update_b16(&foc->data, &i_abc);
+#endif
 
   /* Update base voltage only if changed */
 
@@ -291,7 +298,11 @@ static void foc_control_voltage_run_b16(FAR foc_handler_b16_t *h,
 
   /* Call FOC voltage controller */
 
+#ifndef CONFIG_INDUSTRY_FOC_SIMD
   foc_voltage_control_b16(&foc->data, dq_ref);
+#else
+  foc_simd_voltage_control_b16(&foc->data, dq_ref);
+#endif
 
   /* Get output v_ab_mod frame */
 
@@ -353,7 +364,11 @@ static void foc_control_current_run_b16(FAR foc_handler_b16_t *h,
 
   /* Call FOC voltage control */
 
+#ifndef CONFIG_INDUSTRY_FOC_SIMD
   foc_voltage_control_b16(&foc->data, &v_dq_ref);
+#else
+  foc_simd_voltage_control_b16(&foc->data, &v_dq_ref);
+#endif
 
   /* Get output v_ab_mod frame */
 
@@ -34,6 +34,7 @@
 #include "industry/foc/foc_log.h"
 
 #include "industry/foc/float/foc_align.h"
+#include "industry/foc/float/foc_trig.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -162,7 +163,7 @@ static int foc_align_index_run_f32(FAR struct foc_align_f32_s *align,
   /* Normalize angle to <-M_PI, M_PI> range */
 
   align->angle_now = align->angle_now - M_PI;
-  angle_norm_2pi(&align->angle_now, -M_PI, M_PI);
+  foc_angle_wrap_f32(&align->angle_now, -M_PI, M_PI);
 
   /* The product of the previous angle with an angle now gives us
    * information about the encoder overflow.
@@ -426,7 +427,7 @@ static void foc_align_dir_hold_f32(FAR struct foc_align_f32_s *align,
       if (diff == true)
         {
           tmp = align->angle_now - align->angle_last;
-          angle_norm_2pi(&tmp, -M_PI_F, M_PI_F);
+          foc_angle_wrap_f32(&tmp, -M_PI_F, M_PI_F);
 
           if (dir == DIR_CW)
             {
@@ -38,6 +38,7 @@
 
 #include "industry/foc/foc_log.h"
 #include "industry/foc/float/foc_angle.h"
+#include "industry/foc/float/foc_trig.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -579,7 +580,7 @@ static int foc_angle_hl_run_f32(FAR foc_angle_f32_t *h,
 
   /* Normalize angle */
 
-  angle_norm_2pi(&hl->angle, MOTOR_ANGLE_E_MIN, MOTOR_ANGLE_E_MAX);
+  foc_angle_wrap_f32(&hl->angle, MOTOR_ANGLE_E_MIN, MOTOR_ANGLE_E_MAX);
 
   /* Copy data */
 
@@ -68,6 +68,8 @@ static int foc_angle_onfo_dir_f32(FAR foc_angle_f32_t *h, float dir);
 static int foc_angle_onfo_run_f32(FAR foc_angle_f32_t *h,
                                   FAR struct foc_angle_in_f32_s *in,
                                   FAR struct foc_angle_out_f32_s *out);
+static int foc_angle_onfo_phy_f32(FAR foc_angle_f32_t *h,
+                                  FAR struct motor_phy_params_f32_s *phy);
 
 /****************************************************************************
  * Public Data
@@ -83,6 +85,7 @@ struct foc_angle_ops_f32_s g_foc_angle_onfo_f32 =
   .zero   = foc_angle_onfo_zero_f32,
   .dir    = foc_angle_onfo_dir_f32,
   .run    = foc_angle_onfo_run_f32,
+  .phy    = foc_angle_onfo_phy_f32,
 };
 
 /****************************************************************************
@@ -317,3 +320,35 @@ static int foc_angle_onfo_run_f32(FAR foc_angle_f32_t *h,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: foc_angle_onfo_phy_f32
+ *
+ * Description:
+ *   Update the NFO observer motor parameters (float32)
+ *
+ * Input Parameter:
+ *   h   - pointer to FOC angle handler
+ *   phy - pointer to new motor parameters
+ *
+ ****************************************************************************/
+
+static int foc_angle_onfo_phy_f32(FAR foc_angle_f32_t *h,
+                                  FAR struct motor_phy_params_f32_s *phy)
+{
+  FAR struct foc_ang_onfo_f32_s *ob = NULL;
+
+  DEBUGASSERT(h);
+  DEBUGASSERT(phy);
+
+  /* Get sensorless observer data */
+
+  DEBUGASSERT(h->data);
+  ob = h->data;
+
+  /* The observer reads the parameters in each step */
+
+  memcpy(&ob->cfg.phy, phy, sizeof(struct motor_phy_params_f32_s));
+
+  return OK;
+}
@@ -38,6 +38,7 @@
 
 #include "industry/foc/foc_log.h"
 #include "industry/foc/float/foc_angle.h"
+#include "industry/foc/float/foc_trig.h"
 
 /****************************************************************************
  * Private Data Types
@@ -354,7 +355,7 @@ static int foc_angle_qe_run_f32(FAR foc_angle_f32_t *h,
 
   /* Normalize angle */
 
-  angle_norm_2pi(&qe->angle, MOTOR_ANGLE_M_MIN, MOTOR_ANGLE_M_MAX);
+  foc_angle_wrap_f32(&qe->angle, MOTOR_ANGLE_M_MIN, MOTOR_ANGLE_M_MAX);
 
   /* Copy data */
 
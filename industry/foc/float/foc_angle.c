@@ -194,3 +194,33 @@ int foc_angle_run_f32(FAR foc_angle_f32_t *h,
 
   return h->ops->run(h, in, out);
 }
+
+/****************************************************************************
+ * Name: foc_angle_phy_f32
+ *
+ * Description:
+ *   Update the motor parameters used by the FOC angle handler (float32).
+ *   Can be called from the control loop when the motor is running.
+ *
+ * Input Parameter:
+ *   h   - pointer to FOC angle handler
+ *   phy - pointer to new motor parameters
+ *
+ * Returned Value:
+ *   OK on success, -ENOTSUP if the handler doesn't use motor parameters.
+ *
+ ****************************************************************************/
+
+int foc_angle_phy_f32(FAR foc_angle_f32_t *h,
+                      FAR struct motor_phy_params_f32_s *phy)
+{
+  DEBUGASSERT(h);
+  DEBUGASSERT(phy);
+
+  if (h->ops->phy == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  return h->ops->phy(h, phy);
+}
@@ -0,0 +1,373 @@
+/****************************************************************************
+ * apps/industry/foc/float/foc_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#include "industry/foc/foc_log.h"
+#include "industry/foc/foc_common.h"
+#include "industry/foc/float/foc_batch.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_batch_angle_f32
+ *
+ * Description:
+ *   Get the electrical angle for all motors
+ *
+ ****************************************************************************/
+
+static void foc_batch_angle_f32(FAR struct foc_batch_f32_s *b,
+                                FAR struct foc_batch_input_f32_s *in,
+                                FAR struct foc_batch_output_f32_s *out)
+{
+  struct foc_angle_in_f32_s  ain;
+  struct foc_angle_out_f32_s aout;
+  int                        ret = OK;
+  int                        i   = 0;
+
+  for (i = 0; i < b->motors; i++)
+    {
+      out->ret[i] = OK;
+
+      if (b->obs[i] == NULL)
+        {
+          b->angle[i] = in->angle[i];
+          continue;
+        }
+
+      ain.state = &b->state[i];
+      ain.angle = b->angle[i];
+      ain.vel   = in->vel[i];
+      ain.dir   = in->dir[i];
+
+      ret = foc_angle_run_f32(b->obs[i], &ain, &aout);
+      if (ret < 0)
+        {
+          out->ret[i] = ret;
+          continue;
+        }
+
+      if (aout.type == FOC_ANGLE_TYPE_MECH)
+        {
+          /* Convert mechanical angle to electrical angle */
+
+          b->angle[i] = fmodf(aout.angle * b->poles[i], MOTOR_ANGLE_E_MAX);
+        }
+      else
+        {
+          b->angle[i] = aout.angle;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: foc_batch_input_f32
+ *
+ * Description:
+ *   Feed the controllers of all motors with phase currents
+ *
+ ****************************************************************************/
+
+static void foc_batch_input_f32(FAR struct foc_batch_f32_s *b,
+                                FAR struct foc_batch_input_f32_s *in,
+                                FAR struct foc_batch_output_f32_s *out)
+{
+  FAR foc_handler_f32_t *h = NULL;
+  int                    i = 0;
+
+  for (i = 0; i < b->motors; i++)
+    {
+      /* Do nothing if control mode not specified yet */
+
+      if (in->mode[i] <= FOC_HANDLER_MODE_INIT)
+        {
+          out->ret[i] = -EINVAL;
+        }
+
+      if (out->ret[i] < 0)
+        {
+          continue;
+        }
+
+      h = b->handler[i];
+
+      /* Correct current samples according to modulation state */
+
+      h->ops.mod->current(h, in->current[i]);
+
+      /* Get VBASE */
+
+      h->ops.mod->vbase_get(h, in->vbus[i], &b->vbase[i]);
+
+      /* Feed controller with phase currents */
+
+      h->ops.ctrl->input_set(h, in->current[i], b->vbase[i], b->angle[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: foc_batch_control_f32
+ *
+ * Description:
+ *   Run current/voltage controllers for all motors
+ *
+ ****************************************************************************/
+
+static void foc_batch_control_f32(FAR struct foc_batch_f32_s *b,
+                                  FAR struct foc_batch_input_f32_s *in,
+                                  FAR struct foc_batch_output_f32_s *out,
+                                  FAR bool *mod)
+{
+  FAR foc_handler_f32_t *h = NULL;
+  int                    i = 0;
+
+  for (i = 0; i < b->motors; i++)
+    {
+      mod[i] = false;
+
+      if (out->ret[i] < 0)
+        {
+          continue;
+        }
+
+      h = b->handler[i];
+
+      switch (in->mode[i])
+        {
+          /* IDLE - duty set to zeros */
+
+          case FOC_HANDLER_MODE_IDLE:
+            {
+              break;
+            }
+
+          /* FOC current mode - control DQ-current */
+
+          case FOC_HANDLER_MODE_CURRENT:
+            {
+              h->ops.ctrl->current_run(h,
+                                       &in->dq_ref[i],
+                                       &in->vdq_comp[i],
+                                       &b->v_ab_mod[i]);
+              mod[i] = true;
+              break;
+            }
+
+          /* FOC voltage mode - control DQ-voltage */
+
+          case FOC_HANDLER_MODE_VOLTAGE:
+            {
+              h->ops.ctrl->voltage_run(h,
+                                       &in->dq_ref[i],
+                                       &b->v_ab_mod[i]);
+              mod[i] = true;
+              break;
+            }
+
+          default:
+            {
+              out->ret[i] = -EINVAL;
+              break;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: foc_batch_modulation_f32
+ *
+ * Description:
+ *   Run duty cycle modulation for all motors
+ *
+ ****************************************************************************/
+
+static void foc_batch_modulation_f32(FAR struct foc_batch_f32_s *b,
+                                     FAR struct foc_batch_output_f32_s *out,
+                                     FAR bool *mod)
+{
+  FAR foc_handler_f32_t *h = NULL;
+  int                    i = 0;
+
+  for (i = 0; i < b->motors; i++)
+    {
+      h = b->handler[i];
+
+      if (mod[i])
+        {
+          h->ops.mod->run(h, &b->v_ab_mod[i], out->duty[i]);
+        }
+      else
+        {
+          memset(out->duty[i], 0, sizeof(float) * CONFIG_MOTOR_FOC_PHASES);
+        }
+
+      out->angle[i] = b->angle[i];
+
+      /* Angle observers need the last controller state */
+
+      h->ops.ctrl->state_get(h, &b->state[i]);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_batch_init_f32
+ *
+ * Description:
+ *   Initialize the batched FOC controller (float32)
+ *
+ * Input Parameter:
+ *   b - pointer to batched FOC controller
+ *
+ ****************************************************************************/
+
+void foc_batch_init_f32(FAR struct foc_batch_f32_s *b)
+{
+  DEBUGASSERT(b);
+
+  memset(b, 0, sizeof(struct foc_batch_f32_s));
+}
+
+/****************************************************************************
+ * Name: foc_batch_add_f32
+ *
+ * Description:
+ *   Attach a motor to the batched FOC controller (float32)
+ *
+ * Input Parameter:
+ *   b     - pointer to batched FOC controller
+ *   h     - pointer to initialized and configured FOC handler
+ *   obs   - pointer to angle handler (optional). If not set, the phase
+ *           angle is taken from the batch input
+ *   poles - motor pole pairs, used to convert a mechanical angle
+ *
+ * Returned Value:
+ *   Motor index in the batch on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int foc_batch_add_f32(FAR struct foc_batch_f32_s *b,
+                      FAR foc_handler_f32_t *h,
+                      FAR foc_angle_f32_t *obs,
+                      uint8_t poles)
+{
+  int i = 0;
+
+  DEBUGASSERT(b);
+  DEBUGASSERT(h);
+
+  if (b->motors >= FOC_BATCH_MOTORS)
+    {
+      FOCLIBERR("ERROR: no space for motor\n");
+      return -ENOSPC;
+    }
+
+  i = b->motors;
+
+  b->handler[i] = h;
+  b->obs[i]     = obs;
+  b->poles[i]   = poles;
+  b->motors    += 1;
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: foc_batch_run_f32
+ *
+ * Description:
+ *   Run the FOC handlers of all attached motors in one pass (float32).
+ *   The result for a given motor is the same as from foc_handler_run_f32().
+ *
+ * Input Parameter:
+ *   b   - pointer to batched FOC controller
+ *   in  - pointer to batch input data
+ *   out - pointer to batch output data
+ *
+ * Returned Value:
+ *   OK if all motors succeeded; otherwise the first negated errno value
+ *   from out->ret.
+ *
+ ****************************************************************************/
+
+int foc_batch_run_f32(FAR struct foc_batch_f32_s *b,
+                      FAR struct foc_batch_input_f32_s *in,
+                      FAR struct foc_batch_output_f32_s *out)
+{
+  bool mod[FOC_BATCH_MOTORS];
+  int  i = 0;
+
+  DEBUGASSERT(b);
+  DEBUGASSERT(in);
+  DEBUGASSERT(out);
+
+  foc_batch_angle_f32(b, in, out);
+  foc_batch_input_f32(b, in, out);
+  foc_batch_control_f32(b, in, out, mod);
+  foc_batch_modulation_f32(b, out, mod);
+
+  for (i = 0; i < b->motors; i++)
+    {
+      if (out->ret[i] < 0)
+        {
+          return out->ret[i];
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: foc_batch_state_f32
+ *
+ * Description:
+ *   Get the last controller state of a given motor (float32)
+ *
+ * Input Parameter:
+ *   b - pointer to batched FOC controller
+ *   i - motor index
+ *
+ ****************************************************************************/
+
+FAR struct foc_state_f32_s *
+foc_batch_state_f32(FAR struct foc_batch_f32_s *b, uint8_t i)
+{
+  DEBUGASSERT(b);
+  DEBUGASSERT(i < b->motors);
+
+  return &b->state[i];
+}
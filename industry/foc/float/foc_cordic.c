@@ -38,6 +38,7 @@
 
 #include "industry/foc/foc_log.h"
 #include "industry/foc/float/foc_cordic.h"
+#include "industry/foc/float/foc_trig.h"
 
 /****************************************************************************
  * Public Functions
@@ -153,7 +154,7 @@ int foc_cordic_angle_f32(int fd, FAR phase_angle_f32_t *angle, float a)
 
   /* Normalize angle to [-PI, PI] */
 
-  angle_norm_2pi(&anorm, -M_PI_F, M_PI_F);
+  foc_angle_wrap_f32(&anorm, -M_PI_F, M_PI_F);
 
   /* Normalize angle to [-1, 1] */
 
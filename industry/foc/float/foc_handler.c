@@ -36,6 +36,23 @@
 #include "industry/foc/foc_common.h"
 #include "industry/foc/float/foc_handler.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The statically composed pipeline (foc_static.c) includes this file
+ * together with the PI controller and SVM3 modulation, so the current loop
+ * calls them directly and the compiler can inline them.
+ */
+
+#ifdef CONFIG_INDUSTRY_FOC_STATIC
+#  define FOC_CTRL_OP(h, op) foc_control_##op##_f32
+#  define FOC_MOD_OP(h, op)  foc_modulation_##op##_f32
+#else
+#  define FOC_CTRL_OP(h, op) (h)->ops.ctrl->op
+#  define FOC_MOD_OP(h, op)  (h)->ops.mod->op
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -82,6 +99,19 @@ int foc_handler_init_f32(FAR foc_handler_f32_t *h,
   DEBUGASSERT(mod->vbase_get);
   DEBUGASSERT(mod->run);
 
+#ifdef CONFIG_INDUSTRY_FOC_STATIC
+  /* Only PI controller and SVM3 are supported by static pipeline, the
+   * handler calls them directly whatever ops are passed here.
+   */
+
+  if (ctrl != &g_foc_control_pi_f32 || mod != &g_foc_mod_svm3_f32)
+    {
+      FOCLIBERR("ERROR: static pipeline supports only PI and SVM3\n");
+      ret = -EINVAL;
+      goto errout;
+    }
+#endif
+
   /* Reset handler */
 
   memset(h, 0, sizeof(foc_handler_f32_t));
@@ -231,15 +261,15 @@ int foc_handler_run_f32(FAR foc_handler_f32_t *h,
 
   /* Correct current samples according to modulation state */
 
-  h->ops.mod->current(h, in->current);
+  FOC_MOD_OP(h, current)(h, in->current);
 
   /* Get VBASE */
 
-  h->ops.mod->vbase_get(h, in->vbus, &vbase);
+  FOC_MOD_OP(h, vbase_get)(h, in->vbus, &vbase);
 
   /* Feed controller with phase currents */
 
-  h->ops.ctrl->input_set(h, in->current, vbase, in->angle);
+  FOC_CTRL_OP(h, input_set)(h, in->current, vbase, in->angle);
 
   /* Call controller */
 
@@ -261,10 +291,10 @@ int foc_handler_run_f32(FAR foc_handler_f32_t *h,
         {
           /* Current controller */
 
-          h->ops.ctrl->current_run(h,
-                                   in->dq_ref,
-                                   in->vdq_comp,
-                                   &v_ab_mod);
+          FOC_CTRL_OP(h, current_run)(h,
+                                      in->dq_ref,
+                                      in->vdq_comp,
+                                      &v_ab_mod);
 
           break;
         }
@@ -275,9 +305,9 @@ int foc_handler_run_f32(FAR foc_handler_f32_t *h,
         {
           /* Voltage controller */
 
-          h->ops.ctrl->voltage_run(h,
-                                   in->dq_ref,
-                                   &v_ab_mod);
+          FOC_CTRL_OP(h, voltage_run)(h,
+                                      in->dq_ref,
+                                      &v_ab_mod);
 
           break;
         }
@@ -293,7 +323,7 @@ int foc_handler_run_f32(FAR foc_handler_f32_t *h,
 
   /* Duty cycle modulation */
 
-  h->ops.mod->run(h, &v_ab_mod, out->duty);
+  FOC_MOD_OP(h, run)(h, &v_ab_mod, out->duty);
 
   return ret;
 
@@ -325,11 +355,11 @@ void foc_handler_state_f32(FAR foc_handler_f32_t *h,
   DEBUGASSERT(h);
   DEBUGASSERT(state);
 
-  h->ops.ctrl->state_get(h, state);
+  FOC_CTRL_OP(h, state_get)(h, state);
 
   if (mod_state)
     {
-      h->ops.mod->state_get(h, mod_state);
+      FOC_MOD_OP(h, state_get)(h, mod_state);
     }
 }
 
@@ -0,0 +1,353 @@
+/****************************************************************************
+ * apps/industry/foc/float/foc_ident_online.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#include "industry/foc/foc_log.h"
+#include "industry/foc/float/foc_ident_online.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IDENT_RES  (0)
+#define IDENT_IND  (1)
+#define IDENT_FLUX (2)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_ident_online_window_reset
+ ****************************************************************************/
+
+static void foc_ident_online_window_reset(
+  FAR struct foc_ident_online_f32_s *id)
+{
+  id->idq_sum.d = 0.0f;
+  id->idq_sum.q = 0.0f;
+  id->vdq_sum.d = 0.0f;
+  id->vdq_sum.q = 0.0f;
+  id->vel_sum   = 0.0f;
+  id->cntr      = 0;
+}
+
+/****************************************************************************
+ * Name: foc_ident_online_rls
+ *
+ * Description:
+ *   One recursive least squares update for a scalar measurement y with
+ *   the regressor phi.
+ *
+ *   The forgetting factor is applied only while the covariance stays
+ *   below its initial value. Without this, the covariance grows without
+ *   bound when the motor runs at a constant operating point (no
+ *   excitation) and the next transient would throw the estimates away.
+ *
+ ****************************************************************************/
+
+static void foc_ident_online_rls(FAR struct foc_ident_online_f32_s *id,
+                                 FAR const float *phi, float y)
+{
+  float pphi[FOC_IDENT_ONLINE_PARAMS];
+  float forget = id->cfg.forget;
+  float den    = 0.0f;
+  float err    = y;
+  int   i      = 0;
+  int   j      = 0;
+
+  for (i = 0; i < FOC_IDENT_ONLINE_PARAMS; i++)
+    {
+      pphi[i] = 0.0f;
+      for (j = 0; j < FOC_IDENT_ONLINE_PARAMS; j++)
+        {
+          pphi[i] += id->p[i][j] * phi[j];
+        }
+
+      den += phi[i] * pphi[i];
+      err -= phi[i] * id->theta[i];
+
+      if (id->p[i][i] > id->p0[i])
+        {
+          forget = 1.0f;
+        }
+    }
+
+  den += forget;
+
+  /* Update estimates */
+
+  for (i = 0; i < FOC_IDENT_ONLINE_PARAMS; i++)
+    {
+      id->theta[i] += pphi[i] * err / den;
+    }
+
+  /* Update covariance, keep it symmetric */
+
+  for (i = 0; i < FOC_IDENT_ONLINE_PARAMS; i++)
+    {
+      for (j = i; j < FOC_IDENT_ONLINE_PARAMS; j++)
+        {
+          id->p[i][j] = (id->p[i][j] - pphi[i] * pphi[j] / den) / forget;
+          id->p[j][i] = id->p[i][j];
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_ident_online_init_f32
+ *
+ * Description:
+ *   Initialize the online motor identification (float32)
+ *
+ * Input Parameter:
+ *   id  - pointer to online identification data
+ *   cfg - pointer to online identification configuration
+ *
+ ****************************************************************************/
+
+int foc_ident_online_init_f32(FAR struct foc_ident_online_f32_s *id,
+                              FAR struct foc_ident_online_cfg_f32_s *cfg)
+{
+  DEBUGASSERT(id);
+  DEBUGASSERT(cfg);
+
+  if (cfg->per <= 0.0f || cfg->decim == 0 ||
+      cfg->forget <= 0.0f || cfg->forget > 1.0f)
+    {
+      FOCLIBERR("ERROR: invalid online ident configuration\n");
+      return -EINVAL;
+    }
+
+  if (cfg->phy.res <= 0.0f || cfg->phy.ind <= 0.0f ||
+      cfg->phy.flux_link <= 0.0f)
+    {
+      FOCLIBERR("ERROR: online ident needs initial motor parameters\n");
+      return -EINVAL;
+    }
+
+  memset(id, 0, sizeof(struct foc_ident_online_f32_s));
+  memcpy(&id->cfg, cfg, sizeof(struct foc_ident_online_cfg_f32_s));
+
+  foc_ident_online_reset_f32(id);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: foc_ident_online_reset_f32
+ *
+ * Description:
+ *   Restart the online motor identification from the initial motor
+ *   parameters (float32)
+ *
+ * Input Parameter:
+ *   id - pointer to online identification data
+ *
+ ****************************************************************************/
+
+void foc_ident_online_reset_f32(FAR struct foc_ident_online_f32_s *id)
+{
+  int i = 0;
+
+  DEBUGASSERT(id);
+
+  id->theta[IDENT_RES]  = id->cfg.phy.res;
+  id->theta[IDENT_IND]  = id->cfg.phy.ind;
+  id->theta[IDENT_FLUX] = id->cfg.phy.flux_link;
+
+  /* Initial uncertainty is 100% of the initial value */
+
+  memset(id->p, 0, sizeof(id->p));
+
+  for (i = 0; i < FOC_IDENT_ONLINE_PARAMS; i++)
+    {
+      id->p0[i]   = id->theta[i] * id->theta[i];
+      id->p[i][i] = id->p0[i];
+    }
+
+  foc_ident_online_window_reset(id);
+
+  id->last_valid = false;
+  id->updates    = 0;
+}
+
+/****************************************************************************
+ * Name: foc_ident_online_run_f32
+ *
+ * Description:
+ *   Feed the online motor identification with the controller state from
+ *   the current control cycle (float32). Must be called from the control
+ *   loop, after the FOC handler is run.
+ *
+ * Input Parameter:
+ *   id    - pointer to online identification data
+ *   state - pointer to FOC handler state
+ *   vel   - electrical velocity
+ *
+ * Returned Value:
+ *   True if the estimates were updated in this cycle.
+ *
+ ****************************************************************************/
+
+bool foc_ident_online_run_f32(FAR struct foc_ident_online_f32_s *id,
+                              FAR struct foc_state_f32_s *state,
+                              float vel)
+{
+  float          phi[FOC_IDENT_ONLINE_PARAMS];
+  dq_frame_f32_t idq;
+  dq_frame_f32_t vdq;
+  dq_frame_f32_t didq;
+  float          one_by_n = 0.0f;
+  float          one_by_t = 0.0f;
+  float          we       = 0.0f;
+
+  DEBUGASSERT(id);
+  DEBUGASSERT(state);
+
+  /* Not enough excitation at low speed, start a new window */
+
+  if (fabsf(vel) < id->cfg.vel_min)
+    {
+      foc_ident_online_window_reset(id);
+      id->last_valid = false;
+      return false;
+    }
+
+  id->idq_sum.d += state->idq.d;
+  id->idq_sum.q += state->idq.q;
+  id->vdq_sum.d += state->vdq.d;
+  id->vdq_sum.q += state->vdq.q;
+  id->vel_sum   += vel;
+
+  if (++id->cntr < id->cfg.decim)
+    {
+      return false;
+    }
+
+  /* Window complete - get average values */
+
+  one_by_n = 1.0f / id->cfg.decim;
+  one_by_t = one_by_n / id->cfg.per;
+
+  idq.d = id->idq_sum.d * one_by_n;
+  idq.q = id->idq_sum.q * one_by_n;
+  vdq.d = id->vdq_sum.d * one_by_n;
+  vdq.q = id->vdq_sum.q * one_by_n;
+  we    = id->vel_sum * one_by_n;
+
+  foc_ident_online_window_reset(id);
+
+  /* Current derivative needs the previous window */
+
+  if (id->last_valid == false)
+    {
+      id->idq_last   = idq;
+      id->last_valid = true;
+      return false;
+    }
+
+  didq.d = (idq.d - id->idq_last.d) * one_by_t;
+  didq.q = (idq.q - id->idq_last.q) * one_by_t;
+
+  id->idq_last = idq;
+
+  /* D-axis: vd = R * id + L * (did/dt - we * iq) */
+
+  phi[IDENT_RES]  = idq.d;
+  phi[IDENT_IND]  = didq.d - we * idq.q;
+  phi[IDENT_FLUX] = 0.0f;
+
+  foc_ident_online_rls(id, phi, vdq.d);
+
+  /* Q-axis: vq = R * iq + L * (diq/dt + we * id) + flux * we */
+
+  phi[IDENT_RES]  = idq.q;
+  phi[IDENT_IND]  = didq.q + we * idq.d;
+  phi[IDENT_FLUX] = we;
+
+  foc_ident_online_rls(id, phi, vdq.q);
+
+  id->updates += 1;
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: foc_ident_online_phy_get_f32
+ *
+ * Description:
+ *   Get the motor parameters estimated by the online identification
+ *   (float32). Estimates that are not physical (not positive) are replaced
+ *   with the initial values.
+ *
+ * Input Parameter:
+ *   id  - pointer to online identification data
+ *   phy - (out) pointer to motor parameters
+ *
+ ****************************************************************************/
+
+void foc_ident_online_phy_get_f32(FAR struct foc_ident_online_f32_s *id,
+                                  FAR struct motor_phy_params_f32_s *phy)
+{
+  float res  = 0.0f;
+  float ind  = 0.0f;
+  float flux = 0.0f;
+
+  DEBUGASSERT(id);
+  DEBUGASSERT(phy);
+
+  res  = id->theta[IDENT_RES];
+  ind  = id->theta[IDENT_IND];
+  flux = id->theta[IDENT_FLUX];
+
+  if (!(res > 0.0f))
+    {
+      res = id->cfg.phy.res;
+    }
+
+  if (!(ind > 0.0f))
+    {
+      ind = id->cfg.phy.ind;
+    }
+
+  if (!(flux > 0.0f))
+    {
+      flux = id->cfg.phy.flux_link;
+    }
+
+  motor_phy_params_init(phy, id->cfg.phy.p, res, ind, flux);
+}
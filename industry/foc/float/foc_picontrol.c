@@ -33,6 +33,10 @@
 
 #include "industry/foc/float/foc_handler.h"
 
+#ifdef CONFIG_INDUSTRY_FOC_TRIG_LUT
+#  include "industry/foc/float/foc_trig.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -123,6 +127,12 @@ static int foc_control_init_f32(FAR foc_handler_f32_t *h)
       goto errout;
     }
 
+#ifdef CONFIG_INDUSTRY_FOC_TRIG_LUT
+  /* Sine table is shared by all controllers */
+
+  foc_trig_init_f32();
+#endif
+
 errout:
   return ret;
 }
@@ -237,10 +247,12 @@ static void foc_control_input_set_f32(FAR foc_handler_f32_t *h,
 
   /* Update phase angle */
 
-#ifndef CONFIG_INDUSTRY_FOC_CORDIC_ANGLE
-  phase_angle_update(&foc->angle, angle);
-#else
+#if defined(CONFIG_INDUSTRY_FOC_CORDIC_ANGLE)
   foc_cordic_angle_f32(h->fd, &foc->angle, angle);
+#elif defined(CONFIG_INDUSTRY_FOC_TRIG_LUT)
+  foc_trig_angle_f32(&foc->angle, angle);
+#else
+  phase_angle_update(&foc->angle, angle);
 #endif
 
   /* Feed the controller with phase angle */
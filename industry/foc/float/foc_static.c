@@ -0,0 +1,94 @@
+/****************************************************************************
+ * apps/industry/foc/float/foc_static.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Statically composed FOC pipeline (float32).
+ *
+ * The controller, modulation and the selected angle observer are built
+ * together with the FOC handler as one translation unit. The handler calls
+ * them directly (see FOC_CTRL_OP and FOC_MOD_OP in foc_handler.c), so the
+ * compiler can inline the whole current loop without LTO. The ops tables
+ * are still exported, so the generic API keeps working.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifndef CONFIG_INDUSTRY_FOC_STATIC
+#  error CONFIG_INDUSTRY_FOC_STATIC must be set
+#endif
+
+#include "foc_picontrol.c"
+#include "foc_svm3.c"
+#include "foc_handler.c"
+
+#if defined(CONFIG_INDUSTRY_FOC_STATIC_ANGLE_OPENLOOP)
+#  include "foc_ang_openloop.c"
+#  define FOC_STATIC_ANGLE_RUN foc_angle_ol_run_f32
+#elif defined(CONFIG_INDUSTRY_FOC_STATIC_ANGLE_ONFO)
+#  include "foc_ang_onfo.c"
+#  define FOC_STATIC_ANGLE_RUN foc_angle_onfo_run_f32
+#elif defined(CONFIG_INDUSTRY_FOC_STATIC_ANGLE_OSMO)
+#  include "foc_ang_osmo.c"
+#  define FOC_STATIC_ANGLE_RUN foc_angle_osmo_run_f32
+#elif defined(CONFIG_INDUSTRY_FOC_STATIC_ANGLE_QENCO)
+#  include "foc_ang_qenco.c"
+#  define FOC_STATIC_ANGLE_RUN foc_angle_qe_run_f32
+#elif defined(CONFIG_INDUSTRY_FOC_STATIC_ANGLE_HALL)
+#  include "foc_ang_hall.c"
+#  define FOC_STATIC_ANGLE_RUN foc_angle_hl_run_f32
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef FOC_STATIC_ANGLE_RUN
+/****************************************************************************
+ * Name: foc_angle_static_run_f32
+ *
+ * Description:
+ *   Process the statically selected FOC angle handler data (float32).
+ *   The angle handler must be initialized with the ops of the observer
+ *   selected with CONFIG_INDUSTRY_FOC_STATIC_ANGLE_xxx.
+ *
+ * Input Parameter:
+ *   h   - pointer to FOC angle handler
+ *   in  - pointer to FOC angle handler input data
+ *   out - pointer to FOC angle handler output data
+ *
+ ****************************************************************************/
+
+int foc_angle_static_run_f32(FAR foc_angle_f32_t *h,
+                             FAR struct foc_angle_in_f32_s *in,
+                             FAR struct foc_angle_out_f32_s *out)
+{
+  DEBUGASSERT(h);
+  DEBUGASSERT(in);
+  DEBUGASSERT(out);
+  DEBUGASSERT(h->ops->run == FOC_STATIC_ANGLE_RUN);
+
+  return FOC_STATIC_ANGLE_RUN(h, in, out);
+}
+#endif
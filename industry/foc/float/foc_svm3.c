@@ -74,8 +74,8 @@ static void foc_modulation_vbase_get_f32(FAR foc_handler_f32_t *h,
 static void foc_modulation_run_f32(FAR foc_handler_f32_t *h,
                                    FAR ab_frame_f32_t *v_ab_mod,
                                    FAR float *duty);
-static void foc_modulation_state_f32(FAR foc_handler_f32_t *h,
-                                     FAR void *v_priv);
+static void foc_modulation_state_get_f32(FAR foc_handler_f32_t *h,
+                                         FAR void *v_priv);
 
 /****************************************************************************
  * Public Data
@@ -91,7 +91,7 @@ struct foc_modulation_ops_f32_s g_foc_mod_svm3_f32 =
   .current   = foc_modulation_current_f32,
   .vbase_get = foc_modulation_vbase_get_f32,
   .run       = foc_modulation_run_f32,
-  .state_get = foc_modulation_state_f32,
+  .state_get = foc_modulation_state_get_f32,
 };
 
 /****************************************************************************
@@ -292,7 +292,7 @@ static void foc_modulation_run_f32(FAR foc_handler_f32_t *h,
 }
 
 /****************************************************************************
- * Name: foc_modulation_state_f32
+ * Name: foc_modulation_state_get_f32
  *
  * Description:
  *   Get the SVM3 modulation state (float32)
@@ -303,8 +303,8 @@ static void foc_modulation_run_f32(FAR foc_handler_f32_t *h,
  *
  ****************************************************************************/
 
-static void foc_modulation_state_f32(FAR foc_handler_f32_t *h,
-                                     FAR void *state)
+static void foc_modulation_state_get_f32(FAR foc_handler_f32_t *h,
+                                         FAR void *state)
 {
   FAR struct foc_svm3mod_f32_s *svm = NULL;
 
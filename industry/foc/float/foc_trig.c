@@ -0,0 +1,160 @@
+/****************************************************************************
+ * apps/industry/foc/float/foc_trig.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+
+#include "industry/foc/float/foc_trig.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FOC_TRIG_LUT_MASK    (FOC_TRIG_LUT_SIZE - 1)
+#define FOC_TRIG_LUT_QUARTER (FOC_TRIG_LUT_SIZE / 4)
+#define FOC_TRIG_LUT_SCALE   (FOC_TRIG_LUT_SIZE * FOC_TRIG_ONE_BY_2PI)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Sine over one and a quarter period plus one entry for the interpolation,
+ * so cosine is read from the same table at a quarter period offset.
+ */
+
+static float g_foc_trig_lut[FOC_TRIG_LUT_SIZE + FOC_TRIG_LUT_QUARTER + 1];
+static bool  g_foc_trig_ready;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_trig_lookup
+ *
+ * Description:
+ *   Linear interpolation between table entries i and i + 1
+ *
+ ****************************************************************************/
+
+static inline float foc_trig_lookup(uint32_t i, float frac)
+{
+  float y0 = g_foc_trig_lut[i];
+
+  return y0 + frac * (g_foc_trig_lut[i + 1] - y0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_trig_init_f32
+ *
+ * Description:
+ *   Fill the sine table (float32). Safe to call more than once, the table
+ *   is filled only on the first call.
+ *
+ ****************************************************************************/
+
+void foc_trig_init_f32(void)
+{
+  int i = 0;
+
+  if (g_foc_trig_ready)
+    {
+      return;
+    }
+
+  for (i = 0; i < FOC_TRIG_LUT_SIZE + FOC_TRIG_LUT_QUARTER + 1; i++)
+    {
+      g_foc_trig_lut[i] = (float)sin(2.0 * M_PI * i / FOC_TRIG_LUT_SIZE);
+    }
+
+  g_foc_trig_ready = true;
+}
+
+/****************************************************************************
+ * Name: foc_sincos_f32
+ *
+ * Description:
+ *   Get sine and cosine from the interpolated table (float32)
+ *
+ * Input Parameter:
+ *   a - angle in rad
+ *   s - (out) sine
+ *   c - (out) cosine
+ *
+ ****************************************************************************/
+
+void foc_sincos_f32(float a, FAR float *s, FAR float *c)
+{
+  float    pos  = 0.0f;
+  float    frac = 0.0f;
+  uint32_t i    = 0;
+
+  DEBUGASSERT(s);
+  DEBUGASSERT(c);
+  DEBUGASSERT(g_foc_trig_ready);
+
+  foc_angle_wrap_f32(&a, 0.0f, FOC_TRIG_2PI);
+
+  /* Angle 2PI gives index FOC_TRIG_LUT_SIZE with zero fraction */
+
+  pos  = a * FOC_TRIG_LUT_SCALE;
+  i    = (uint32_t)pos;
+  frac = pos - i;
+  i   &= FOC_TRIG_LUT_MASK;
+
+  *s = foc_trig_lookup(i, frac);
+  *c = foc_trig_lookup(i + FOC_TRIG_LUT_QUARTER, frac);
+}
+
+/****************************************************************************
+ * Name: foc_trig_angle_f32
+ *
+ * Description:
+ *   Phase angle update with the interpolated table (float32), drop-in
+ *   replacement for phase_angle_update()
+ *
+ * Input Parameter:
+ *   angle - (out) phase angle data
+ *   a     - phase angle in rad
+ *
+ ****************************************************************************/
+
+void foc_trig_angle_f32(FAR phase_angle_f32_t *angle, float a)
+{
+  DEBUGASSERT(angle);
+
+  foc_angle_wrap_f32(&a, 0.0f, FOC_TRIG_2PI);
+
+  angle->angle = a;
+  foc_sincos_f32(a, &angle->sin, &angle->cos);
+}
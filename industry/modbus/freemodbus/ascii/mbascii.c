@@ -46,6 +46,8 @@
 #include "mbascii.h"
 #include "mbcrc.h"
 
+#include "industry/mbcrc.h"
+
 #ifdef CONFIG_MB_ASCII_ENABLED
 
 /****************************************************************************
@@ -158,17 +160,7 @@ static uint8_t prvucMBBIN2int8_t(uint8_t ucByte)
 
 static uint8_t prvucMBLRC(uint8_t * pucFrame, uint16_t usLen)
 {
-  uint8_t ucLocalLRC = 0;  /* LRC char initialized */
-
-  while (usLen--)
-    {
-      ucLocalLRC += *pucFrame++;   /* Add buffer byte without carry */
-    }
-
-  /* Return twos complement */
-
-  ucLocalLRC = (uint8_t) (-((int8_t) ucLocalLRC));
-  return ucLocalLRC;
+  return mbcrc_lrc(pucFrame, usLen);
 }
 
 /****************************************************************************
@@ -37,6 +37,22 @@
 
 #include "nxmb_internal.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Requests kept in flight by the batch reads. A serial line carries one
+ * request at a time, so only TCP uses the configured window.
+ */
+
+#ifdef CONFIG_NXMODBUS_CLIENT_PIPELINE
+#  define NXMB_CLIENT_PIPELINE CONFIG_NXMODBUS_CLIENT_PIPELINE
+#else
+#  define NXMB_CLIENT_PIPELINE 1
+#endif
+
+#define NXMB_CLIENT_REGS_MAX 125
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -44,6 +60,29 @@
 struct nxmb_client_state_s
 {
   uint32_t timeout_ms;
+  uint16_t trans_id;    /* Last MBAP transaction identifier sent */
+};
+
+/* Request in flight */
+
+struct nxmb_client_slot_s
+{
+  FAR struct nxmb_read_s *req;      /* NULL if the slot is free */
+  uint64_t                deadline;
+  uint16_t                trans_id;
+};
+
+/* Scan list merged into register reads. regs holds the registers of all
+ * the reads back to back, offs[i] is where the scan list entry i starts.
+ */
+
+struct nxmb_scan_plan_s
+{
+  FAR struct nxmb_read_s *reqs;
+  FAR uint32_t           *offs;
+  FAR uint16_t           *regs;
+  size_t                  nreqs;
+  uint32_t                nregs;
 };
 
 /****************************************************************************
@@ -151,6 +190,8 @@ static int nxmb_client_tx_wait_rx(nxmb_handle_t ctx, uint8_t expected_uid,
 
   state = (FAR struct nxmb_client_state_s *)ctx->client_state;
 
+  ctx->adu.trans_id = ++state->trans_id;
+
   ret = ctx->transport_ops->send(ctx);
   if (ret < 0)
     {
@@ -176,6 +217,14 @@ static int nxmb_client_tx_wait_rx(nxmb_handle_t ctx, uint8_t expected_uid,
       ret = ctx->transport_ops->receive(ctx);
       if (ret > 0)
         {
+          /* Drop a late response to an earlier request that timed out */
+
+          if (ctx->mode == NXMB_MODE_TCP &&
+              ctx->adu.trans_id != state->trans_id)
+            {
+              continue;
+            }
+
           return nxmb_client_validate_response(ctx, expected_uid,
                                                expected_fc);
         }
@@ -232,51 +281,437 @@ static int nxmb_client_read_bits(nxmb_handle_t ctx, uint8_t uid, uint8_t fc,
 }
 
 /****************************************************************************
- * Name: nxmb_client_read_regs
+ * Name: nxmb_client_read_check
+ ****************************************************************************/
+
+static int nxmb_client_read_check(FAR const struct nxmb_read_s *req)
+{
+  if (req->buf == NULL || req->uid == NXMB_ADDRESS_BROADCAST ||
+      req->count == 0 || req->count > NXMB_CLIENT_REGS_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if (req->type != NXMB_REGTYPE_HOLDING && req->type != NXMB_REGTYPE_INPUT)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmb_client_read_fc
+ ****************************************************************************/
+
+static uint8_t nxmb_client_read_fc(FAR const struct nxmb_read_s *req)
+{
+  return req->type == NXMB_REGTYPE_INPUT ? NXMB_FC_READ_INPUT :
+                                           NXMB_FC_READ_HOLDING;
+}
+
+/****************************************************************************
+ * Name: nxmb_client_read_put
  *
  * Description:
- *   Common helper for FC03 (Read Holding) and FC04 (Read Input) registers.
+ *   Build the FC03/FC04 request for a register read in ctx->adu.
  *
  ****************************************************************************/
 
-static int nxmb_client_read_regs(nxmb_handle_t ctx, uint8_t uid, uint8_t fc,
-                                 uint16_t addr, uint16_t count,
-                                 FAR uint16_t *buf)
+static void nxmb_client_read_put(nxmb_handle_t ctx,
+                                 FAR const struct nxmb_read_s *req)
+{
+  ctx->adu.unit_id = req->uid;
+  ctx->adu.fc = nxmb_client_read_fc(req);
+  nxmb_util_put_u16_be(&ctx->adu.data[0], req->addr);
+  nxmb_util_put_u16_be(&ctx->adu.data[2], req->count);
+  ctx->adu.length = 6;
+}
+
+/****************************************************************************
+ * Name: nxmb_client_read_get
+ *
+ * Description:
+ *   Check the response in ctx->adu and copy the registers to req->buf.
+ *
+ ****************************************************************************/
+
+static int nxmb_client_read_get(nxmb_handle_t ctx,
+                                FAR struct nxmb_read_s *req)
 {
   uint16_t nbytes;
   int      ret;
   int      i;
 
-  nbytes = count * 2;
-
-  pthread_mutex_lock(&ctx->lock);
-
-  ctx->adu.unit_id = uid;
-  ctx->adu.fc = fc;
-  nxmb_util_put_u16_be(&ctx->adu.data[0], addr);
-  nxmb_util_put_u16_be(&ctx->adu.data[2], count);
-  ctx->adu.length = 6;
-
-  ret = nxmb_client_tx_wait_rx(ctx, uid, fc);
+  ret = nxmb_client_validate_response(ctx, req->uid,
+                                      nxmb_client_read_fc(req));
   if (ret < 0)
     {
-      pthread_mutex_unlock(&ctx->lock);
       return ret;
     }
 
+  nbytes = req->count * 2;
+
   if (ctx->adu.length < (3 + nbytes) || ctx->adu.data[0] != nbytes)
     {
-      pthread_mutex_unlock(&ctx->lock);
       return -EPROTO;
     }
 
-  for (i = 0; i < count; i++)
+  for (i = 0; i < req->count; i++)
+    {
+      req->buf[i] = nxmb_util_get_u16_be(&ctx->adu.data[1 + i * 2]);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmb_client_slot_find
+ *
+ * Description:
+ *   Find the request a response in ctx->adu belongs to. Over TCP this is
+ *   the request with the same transaction identifier, other transports
+ *   have a single request in flight.
+ *
+ ****************************************************************************/
+
+static FAR struct nxmb_client_slot_s *
+nxmb_client_slot_find(nxmb_handle_t ctx,
+                      FAR struct nxmb_client_slot_s *slots, int nslots)
+{
+  int i;
+
+  for (i = 0; i < nslots; i++)
+    {
+      if (slots[i].req != NULL && (ctx->mode != NXMB_MODE_TCP ||
+                                   slots[i].trans_id == ctx->adu.trans_id))
+        {
+          return &slots[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nxmb_client_batch
+ *
+ * Description:
+ *   Perform register reads with up to NXMB_CLIENT_PIPELINE requests in
+ *   flight. Each request has its own timeout, a response that comes after
+ *   it is dropped. A transport error fails all the reads that did not
+ *   complete. Must be called with ctx->lock held.
+ *
+ * Returned Value:
+ *   Zero or the negated errno value of a transport error. The result of
+ *   each read is stored in reqs[i].result.
+ *
+ ****************************************************************************/
+
+static int nxmb_client_batch(nxmb_handle_t ctx,
+                             FAR struct nxmb_read_s *reqs, size_t nreqs)
+{
+  FAR struct nxmb_client_state_s *state;
+  struct nxmb_client_slot_s       slots[NXMB_CLIENT_PIPELINE];
+  FAR struct nxmb_client_slot_s  *slot;
+  FAR struct nxmb_read_s         *req;
+  uint64_t                        now;
+  size_t                          next     = 0;
+  int                             window   = 1;
+  int                             inflight = 0;
+  int                             ret      = OK;
+  int                             i;
+
+  if (ctx == NULL || ctx->client_state == NULL)
+    {
+      return -EINVAL;
+    }
+
+  state = (FAR struct nxmb_client_state_s *)ctx->client_state;
+
+  memset(slots, 0, sizeof(slots));
+
+  if (ctx->mode == NXMB_MODE_TCP)
+    {
+      window = NXMB_CLIENT_PIPELINE;
+    }
+
+  while (next < nreqs || inflight > 0)
+    {
+      /* Keep the window full */
+
+      while (next < nreqs && inflight < window)
+        {
+          req         = &reqs[next++];
+          req->result = nxmb_client_read_check(req);
+          if (req->result < 0)
+            {
+              continue;
+            }
+
+          slot = slots;
+          while (slot->req != NULL)
+            {
+              slot++;
+            }
+
+          nxmb_client_read_put(ctx, req);
+          ctx->adu.trans_id = ++state->trans_id;
+
+          ret = ctx->transport_ops->send(ctx);
+          if (ret < 0)
+            {
+              req->result = ret;
+              goto errout;
+            }
+
+          slot->req      = req;
+          slot->trans_id = state->trans_id;
+          slot->deadline = nxmb_util_clock_ms() + state->timeout_ms;
+          inflight++;
+        }
+
+      /* Give up on the requests that timed out */
+
+      now = nxmb_util_clock_ms();
+
+      for (i = 0; i < window; i++)
+        {
+          if (slots[i].req != NULL && now >= slots[i].deadline)
+            {
+              slots[i].req->result = -ETIMEDOUT;
+              slots[i].req         = NULL;
+              inflight--;
+            }
+        }
+
+      if (inflight == 0)
+        {
+          continue;
+        }
+
+      ret = ctx->transport_ops->receive(ctx);
+      if (ret == 0 || ret == -EAGAIN)
+        {
+          continue;
+        }
+      else if (ret < 0)
+        {
+          goto errout;
+        }
+
+      slot = nxmb_client_slot_find(ctx, slots, window);
+      if (slot != NULL)
+        {
+          slot->req->result = nxmb_client_read_get(ctx, slot->req);
+          slot->req         = NULL;
+          inflight--;
+        }
+    }
+
+  return OK;
+
+errout:
+  for (i = 0; i < window; i++)
+    {
+      if (slots[i].req != NULL)
+        {
+          slots[i].req->result = ret;
+        }
+    }
+
+  while (next < nreqs)
     {
-      buf[i] = nxmb_util_get_u16_be(&ctx->adu.data[1 + i * 2]);
+      reqs[next++].result = ret;
     }
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmb_client_read_regs
+ *
+ * Description:
+ *   Common helper for FC03 (Read Holding) and FC04 (Read Input) registers.
+ *
+ ****************************************************************************/
+
+static int nxmb_client_read_regs(nxmb_handle_t ctx, uint8_t uid,
+                                 enum nxmb_regtype_e type, uint16_t addr,
+                                 uint16_t count, FAR uint16_t *buf)
+{
+  struct nxmb_read_s req;
+  int                ret;
+
+  req.buf   = buf;
+  req.addr  = addr;
+  req.count = count;
+  req.uid   = uid;
+  req.type  = type;
+
+  pthread_mutex_lock(&ctx->lock);
+  ret = nxmb_client_batch(ctx, &req, 1);
   pthread_mutex_unlock(&ctx->lock);
 
+  return ret < 0 ? ret : req.result;
+}
+
+/****************************************************************************
+ * Name: nxmb_scan_sort
+ *
+ * Description:
+ *   Sort the scan list indexes by unit, register table and address.
+ *   Insertion sort, scan lists are short and often sorted already.
+ *
+ ****************************************************************************/
+
+static void nxmb_scan_sort(FAR const struct nxmb_read_s *items,
+                           FAR size_t *order, size_t nitems)
+{
+  FAR const struct nxmb_read_s *a;
+  FAR const struct nxmb_read_s *b;
+  size_t                        tmp;
+  size_t                        i;
+  size_t                        j;
+
+  for (i = 0; i < nitems; i++)
+    {
+      order[i] = i;
+    }
+
+  for (i = 1; i < nitems; i++)
+    {
+      tmp = order[i];
+      b   = &items[tmp];
+
+      for (j = i; j > 0; j--)
+        {
+          a = &items[order[j - 1]];
+
+          if (a->uid < b->uid ||
+              (a->uid == b->uid && (a->type < b->type ||
+                                    (a->type == b->type &&
+                                     a->addr <= b->addr))))
+            {
+              break;
+            }
+
+          order[j] = order[j - 1];
+        }
+
+      order[j] = tmp;
+    }
+}
+
+/****************************************************************************
+ * Name: nxmb_scan_plan
+ *
+ * Description:
+ *   Merge the sorted scan list into runs of overlapping and adjacent
+ *   entries and split each run into reads of at most 125 registers. With
+ *   plan->reqs NULL only nreqs and nregs are counted.
+ *
+ ****************************************************************************/
+
+static void nxmb_scan_plan(FAR const struct nxmb_read_s *items,
+                           FAR const size_t *order, size_t nitems,
+                           FAR struct nxmb_scan_plan_s *plan)
+{
+  FAR const struct nxmb_read_s *first;
+  FAR const struct nxmb_read_s *item;
+  FAR struct nxmb_read_s       *req;
+  uint32_t                      start;
+  uint32_t                      end;
+  uint32_t                      addr;
+  size_t                        i = 0;
+  size_t                        j;
+  size_t                        k;
+
+  plan->nreqs = 0;
+  plan->nregs = 0;
+
+  while (i < nitems)
+    {
+      first = &items[order[i]];
+      start = first->addr;
+      end   = start + first->count;
+
+      for (j = i + 1; j < nitems; j++)
+        {
+          item = &items[order[j]];
+
+          if (item->uid != first->uid || item->type != first->type ||
+              item->addr > end + CONFIG_NXMODBUS_CLIENT_SCAN_GAP)
+            {
+              break;
+            }
+
+          if (item->addr + item->count > end)
+            {
+              end = item->addr + item->count;
+            }
+        }
+
+      for (addr = start; addr < end; addr += NXMB_CLIENT_REGS_MAX)
+        {
+          if (plan->reqs != NULL)
+            {
+              req        = &plan->reqs[plan->nreqs];
+              req->buf   = &plan->regs[plan->nregs + addr - start];
+              req->addr  = addr;
+              req->count = end - addr < NXMB_CLIENT_REGS_MAX ?
+                           end - addr : NXMB_CLIENT_REGS_MAX;
+              req->uid   = first->uid;
+              req->type  = first->type;
+            }
+
+          plan->nreqs++;
+        }
+
+      if (plan->reqs != NULL)
+        {
+          for (k = i; k < j; k++)
+            {
+              plan->offs[order[k]] = plan->nregs +
+                                     items[order[k]].addr - start;
+            }
+        }
+
+      plan->nregs += end - start;
+      i = j;
+    }
+}
+
+/****************************************************************************
+ * Name: nxmb_scan_result
+ *
+ * Description:
+ *   Copy the registers of one scan list entry from the merged reads, or
+ *   get the error of the first read it overlaps that failed.
+ *
+ ****************************************************************************/
+
+static int nxmb_scan_result(FAR struct nxmb_read_s *item, uint32_t off,
+                            FAR const struct nxmb_scan_plan_s *plan)
+{
+  FAR const struct nxmb_read_s *req;
+  uint32_t                      roff;
+  size_t                        i;
+
+  for (i = 0; i < plan->nreqs; i++)
+    {
+      req  = &plan->reqs[i];
+      roff = req->buf - plan->regs;
+
+      if (req->result < 0 && roff < off + item->count &&
+          off < roff + req->count)
+        {
+          return req->result;
+        }
+    }
+
+  memcpy(item->buf, &plan->regs[off], item->count * sizeof(uint16_t));
+
   return OK;
 }
 
@@ -349,7 +784,7 @@ int nxmb_read_input(nxmb_handle_t ctx, uint8_t uid, uint16_t addr,
       return -ENOTSUP;
     }
 
-  return nxmb_client_read_regs(ctx, uid, NXMB_FC_READ_INPUT, addr,
+  return nxmb_client_read_regs(ctx, uid, NXMB_REGTYPE_INPUT, addr,
                                count, buf);
 }
 
@@ -372,7 +807,7 @@ int nxmb_read_holding(nxmb_handle_t ctx, uint8_t uid, uint16_t addr,
       return -ENOTSUP;
     }
 
-  return nxmb_client_read_regs(ctx, uid, NXMB_FC_READ_HOLDING, addr,
+  return nxmb_client_read_regs(ctx, uid, NXMB_REGTYPE_HOLDING, addr,
                                count, buf);
 }
 
@@ -672,6 +1107,119 @@ int nxmb_readwrite_holdings(nxmb_handle_t ctx, uint8_t uid, uint16_t rd_addr,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxmb_read_batch
+ ****************************************************************************/
+
+int nxmb_read_batch(nxmb_handle_t ctx, FAR struct nxmb_read_s *reqs,
+                    size_t nreqs)
+{
+  size_t i;
+  int    ret;
+
+  DEBUGASSERT(ctx && (reqs || nreqs == 0));
+
+  if (!ctx->is_client)
+    {
+      return -ENOTSUP;
+    }
+
+  pthread_mutex_lock(&ctx->lock);
+  ret = nxmb_client_batch(ctx, reqs, nreqs);
+  pthread_mutex_unlock(&ctx->lock);
+
+  for (i = 0; i < nreqs && ret == OK; i++)
+    {
+      ret = reqs[i].result;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmb_scan
+ ****************************************************************************/
+
+int nxmb_scan(nxmb_handle_t ctx, FAR struct nxmb_read_s *items,
+              size_t nitems)
+{
+  struct nxmb_scan_plan_s plan;
+  FAR size_t             *order;
+  size_t                  i;
+  int                     ret = OK;
+
+  DEBUGASSERT(ctx && (items || nitems == 0));
+
+  if (!ctx->is_client)
+    {
+      return -ENOTSUP;
+    }
+
+  for (i = 0; i < nitems; i++)
+    {
+      if (items[i].buf == NULL || items[i].count == 0 ||
+          items[i].addr + items[i].count > UINT16_MAX + 1 ||
+          items[i].uid == NXMB_ADDRESS_BROADCAST ||
+          (items[i].type != NXMB_REGTYPE_HOLDING &&
+           items[i].type != NXMB_REGTYPE_INPUT))
+        {
+          return -EINVAL;
+        }
+    }
+
+  if (nitems == 0)
+    {
+      return OK;
+    }
+
+  order = malloc(nitems * sizeof(size_t));
+  if (order == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmb_scan_sort(items, order, nitems);
+
+  /* Count the reads first, then get one buffer for the reads, the entry
+   * offsets and the registers.
+   */
+
+  plan.reqs = NULL;
+  nxmb_scan_plan(items, order, nitems, &plan);
+
+  plan.reqs = malloc(plan.nreqs * sizeof(struct nxmb_read_s) +
+                     nitems * sizeof(uint32_t) +
+                     plan.nregs * sizeof(uint16_t));
+  if (plan.reqs == NULL)
+    {
+      free(order);
+      return -ENOMEM;
+    }
+
+  plan.offs = (FAR uint32_t *)&plan.reqs[plan.nreqs];
+  plan.regs = (FAR uint16_t *)&plan.offs[nitems];
+
+  nxmb_scan_plan(items, order, nitems, &plan);
+
+  pthread_mutex_lock(&ctx->lock);
+  nxmb_client_batch(ctx, plan.reqs, plan.nreqs);
+  pthread_mutex_unlock(&ctx->lock);
+
+  for (i = 0; i < nitems; i++)
+    {
+      items[i].result = nxmb_scan_result(&items[i], plan.offs[i], &plan);
+      if (ret == OK)
+        {
+          ret = items[i].result;
+        }
+    }
+
+  free(plan.reqs);
+  free(order);
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: nxmb_set_timeout
  ****************************************************************************/
@@ -100,6 +100,26 @@ int nxmb_create(FAR nxmb_handle_t *handle,
       memset(ctx, 0, sizeof(struct nxmb_context_s));
 
       ret = pthread_mutex_init(&ctx->lock, NULL);
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+      if (ret == 0)
+        {
+          ret = pthread_rwlock_init(&ctx->data_lock, NULL);
+          if (ret == 0)
+            {
+              ret = pthread_cond_init(&ctx->idle, NULL);
+              if (ret != 0)
+                {
+                  pthread_rwlock_destroy(&ctx->data_lock);
+                }
+            }
+
+          if (ret != 0)
+            {
+              pthread_mutex_destroy(&ctx->lock);
+            }
+        }
+#endif
+
       if (ret == 0)
         {
           ctx->mode      = config->mode;
@@ -138,6 +158,10 @@ int nxmb_create(FAR nxmb_handle_t *handle,
 
               default:
                 pthread_mutex_destroy(&ctx->lock);
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+                pthread_rwlock_destroy(&ctx->data_lock);
+                pthread_cond_destroy(&ctx->idle);
+#endif
                 memset(ctx, 0, sizeof(struct nxmb_context_s));
                 ret = -EINVAL;
                 goto out;
@@ -193,6 +217,10 @@ int nxmb_destroy(nxmb_handle_t ctx)
 
   pthread_mutex_unlock(&ctx->lock);
   pthread_mutex_destroy(&ctx->lock);
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  pthread_rwlock_destroy(&ctx->data_lock);
+  pthread_cond_destroy(&ctx->idle);
+#endif
 
 #ifdef CONFIG_NXMODBUS_CUSTOM_FC
   entry = ctx->custom_fc_list;
@@ -231,7 +259,9 @@ int nxmb_set_callbacks(nxmb_handle_t ctx,
   DEBUGASSERT(ctx);
 
   pthread_mutex_lock(&ctx->lock);
+  nxmb_data_wrlock(ctx);
   ctx->callbacks = callbacks;
+  nxmb_data_unlock(ctx);
   pthread_mutex_unlock(&ctx->lock);
 
   return 0;
@@ -332,6 +362,7 @@ int nxmb_set_server_id(nxmb_handle_t ctx, uint8_t id, bool is_running,
     }
 
   pthread_mutex_lock(&ctx->lock);
+  nxmb_data_wrlock(ctx);
 
   ctx->server_id_len = 0;
   ctx->server_id_buf[ctx->server_id_len++] = id;
@@ -345,6 +376,7 @@ int nxmb_set_server_id(nxmb_handle_t ctx, uint8_t id, bool is_running,
       ctx->server_id_len += addlen;
     }
 
+  nxmb_data_unlock(ctx);
   pthread_mutex_unlock(&ctx->lock);
 
   return 0;
@@ -376,6 +408,16 @@ int nxmb_disable(nxmb_handle_t ctx)
       return 0;
     }
 
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  /* Stop new polls and wait for the threads still serving requests */
+
+  ctx->enabled = false;
+  while (ctx->pollers > 0)
+    {
+      pthread_cond_wait(&ctx->idle, &ctx->lock);
+    }
+#endif
+
   ctx->transport_ops->deinit(ctx);
 
 #ifdef CONFIG_NXMODBUS_CLIENT
@@ -29,6 +29,7 @@
 #include <nuttx/compiler.h>
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -49,7 +50,8 @@
 
 /* Function code handler signature */
 
-typedef enum nxmb_exception_e (*nxmb_fc_handler_t)(nxmb_handle_t ctx);
+typedef enum nxmb_exception_e
+  (*nxmb_fc_handler_t)(nxmb_handle_t ctx, FAR struct nxmb_adu_s *adu);
 
 /* Dispatch table entry */
 
@@ -113,24 +115,24 @@ static const struct nxmb_fc_entry_s g_nxmb_fc_table[] =
  * Name: nxmb_build_exception
  *
  * Description:
- *   Build a Modbus exception response in ctx->adu in place.
+ *   Build a Modbus exception response in the ADU in place.
  *
  * Input Parameters:
- *   ctx       - Instance context
+ *   adu       - Request ADU
  *   fc        - Function code
  *   exception - NxModbus exception code
  *
  ****************************************************************************/
 
-static void nxmb_build_exception(nxmb_handle_t ctx, uint8_t fc,
+static void nxmb_build_exception(FAR struct nxmb_adu_s *adu, uint8_t fc,
                                  enum nxmb_exception_e exception)
 {
-  ctx->adu.fc      = fc | NXMB_EXCEPTION_FLAG;
-  ctx->adu.data[0] = (uint8_t)exception;
+  adu->fc      = fc | NXMB_EXCEPTION_FLAG;
+  adu->data[0] = (uint8_t)exception;
 
   /* unit_id + fc + 1 exception byte */
 
-  ctx->adu.length  = 3;
+  adu->length  = 3;
 }
 
 /****************************************************************************
@@ -206,19 +208,20 @@ static nxmb_custom_fc_handler_t nxmb_lookup_custom_fc(
  *
  * Description:
  *   Dispatch a Modbus function code to the appropriate handler. Operates in
- *   place on ctx->adu. Checks standard handlers first, then custom handlers
- *   if enabled. Builds an exception response if no handler is found or the
- *   handler fails.
+ *   place on the given ADU. Checks standard handlers first, then custom
+ *   handlers if enabled. Builds an exception response if no handler is
+ *   found or the handler fails.
  *
  * Input Parameters:
  *   ctx - Instance context
+ *   adu - Request ADU, ctx->adu or a transaction buffer
  *
  * Returned Value:
  *   Zero on success; a negated errno value on failure
  *
  ****************************************************************************/
 
-int nxmb_dispatch_function(nxmb_handle_t ctx)
+int nxmb_dispatch_function(nxmb_handle_t ctx, FAR struct nxmb_adu_s *adu)
 {
   nxmb_fc_handler_t        handler;
   enum nxmb_exception_e    exception;
@@ -228,14 +231,14 @@ int nxmb_dispatch_function(nxmb_handle_t ctx)
   int                      ret;
 #endif
 
-  DEBUGASSERT(ctx);
+  DEBUGASSERT(ctx && adu);
 
-  if (ctx->adu.length < 2)
+  if (adu->length < 2)
     {
       return -EINVAL;
     }
 
-  fc = ctx->adu.fc;
+  fc = adu->fc;
 
   /* Look up standard handler first */
 
@@ -250,10 +253,25 @@ int nxmb_dispatch_function(nxmb_handle_t ctx)
       custom_handler = nxmb_lookup_custom_fc(ctx, fc);
       if (custom_handler != NULL)
         {
+          /* Custom handlers only know ctx->adu. The caller serializes
+           * them, so a transaction buffer can be passed through it.
+           */
+
+          if (adu != &ctx->adu)
+            {
+              memcpy(&ctx->adu, adu, sizeof(struct nxmb_adu_s));
+            }
+
           ret = custom_handler(ctx);
+
+          if (adu != &ctx->adu)
+            {
+              memcpy(adu, &ctx->adu, sizeof(struct nxmb_adu_s));
+            }
+
           if (ret < 0)
             {
-              nxmb_build_exception(ctx, fc, NXMB_EX_DEVICE_FAILURE);
+              nxmb_build_exception(adu, fc, NXMB_EX_DEVICE_FAILURE);
             }
 
           return 0;
@@ -265,24 +283,59 @@ int nxmb_dispatch_function(nxmb_handle_t ctx)
 
   if (handler == NULL)
     {
-      nxmb_build_exception(ctx, fc, NXMB_EX_ILLEGAL_FUNCTION);
+      nxmb_build_exception(adu, fc, NXMB_EX_ILLEGAL_FUNCTION);
       return 0;
     }
 
   /* Call the handler */
 
-  exception = handler(ctx);
+  exception = handler(ctx, adu);
 
   /* If handler returned exception, build exception response */
 
   if (exception != NXMB_EX_NONE)
     {
-      nxmb_build_exception(ctx, fc, exception);
+      nxmb_build_exception(adu, fc, exception);
     }
 
   return 0;
 }
 
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+/****************************************************************************
+ * Name: nxmb_fc_is_read_only
+ *
+ * Description:
+ *   Check if a function code only reads the application data model, so it
+ *   can be served concurrently with other read-only requests. Custom
+ *   function codes are never read-only.
+ *
+ * Input Parameters:
+ *   fc - Function code
+ *
+ * Returned Value:
+ *   True if the function code is read-only
+ *
+ ****************************************************************************/
+
+bool nxmb_fc_is_read_only(uint8_t fc)
+{
+  switch (fc)
+    {
+      case NXMB_FC_READ_COILS:
+      case NXMB_FC_READ_DISCRETE:
+      case NXMB_FC_READ_HOLDING:
+      case NXMB_FC_READ_INPUT:
+      case NXMB_FC_DIAGNOSTICS:
+      case NXMB_FC_REPORT_SERVER_ID:
+        return nxmb_lookup_standard_fc(fc) != NULL;
+
+      default:
+        return false;
+    }
+}
+#endif
+
 #ifdef CONFIG_NXMODBUS_CUSTOM_FC
 /****************************************************************************
  * Name: nxmb_register_custom_fc
@@ -345,7 +398,10 @@ int nxmb_register_custom_fc(nxmb_handle_t ctx, uint8_t fc,
   new_entry->fc       = fc;
   new_entry->handler  = handler;
   new_entry->next     = ctx->custom_fc_list;
+
+  nxmb_data_wrlock(ctx);
   ctx->custom_fc_list = new_entry;
+  nxmb_data_unlock(ctx);
 
   pthread_mutex_unlock(&ctx->lock);
   return 0;
@@ -82,9 +82,10 @@
  * Name: nxmb_fc01_read_coils
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc01_read_coils(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc01_read_coils(nxmb_handle_t ctx,
+                                           FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t addr;
   uint16_t qty;
   uint8_t  nbytes;
@@ -100,8 +101,8 @@ enum nxmb_exception_e nxmb_fc01_read_coils(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  addr = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC01_ADDR_OFF]);
-  qty  = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC01_QTY_OFF]);
+  addr = nxmb_util_get_u16_be(&adu->data[NXMB_FC01_ADDR_OFF]);
+  qty  = nxmb_util_get_u16_be(&adu->data[NXMB_FC01_QTY_OFF]);
 
   if (qty < 1 || qty > NXMB_COIL_READ_QTY_MAX)
     {
@@ -124,21 +125,21 @@ enum nxmb_exception_e nxmb_fc01_read_coils(nxmb_handle_t ctx)
 
   /* Build response: byte_count + coil data */
 
-  ctx->adu.fc      = NXMB_FC_READ_COILS;
-  ctx->adu.data[0] = nbytes;
+  adu->fc      = NXMB_FC_READ_COILS;
+  adu->data[0] = nbytes;
 
   /* Zero data area so unused trailing bits are clear */
 
-  memset(&ctx->adu.data[1], 0, nbytes);
+  memset(&adu->data[1], 0, nbytes);
 
-  ret = ctx->callbacks->coil_cb(&ctx->adu.data[1], addr, qty, NXMB_REG_READ,
+  ret = ctx->callbacks->coil_cb(&adu->data[1], addr, qty, NXMB_REG_READ,
                                 ctx->callbacks->priv);
   if (ret != 0)
     {
       return nxmb_cb_ret_to_exception(ret);
     }
 
-  ctx->adu.length = (uint16_t)(2 + 1 + nbytes);
+  adu->length = (uint16_t)(2 + 1 + nbytes);
   return NXMB_EX_NONE;
 }
 
@@ -146,9 +147,10 @@ enum nxmb_exception_e nxmb_fc01_read_coils(nxmb_handle_t ctx)
  * Name: nxmb_fc05_write_coil
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc05_write_coil(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc05_write_coil(nxmb_handle_t ctx,
+                                           FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t addr;
   uint16_t value;
   uint8_t  coil_buf[2];
@@ -164,8 +166,8 @@ enum nxmb_exception_e nxmb_fc05_write_coil(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  addr  = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC05_ADDR_OFF]);
-  value = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC05_VALUE_OFF]);
+  addr  = nxmb_util_get_u16_be(&adu->data[NXMB_FC05_ADDR_OFF]);
+  value = nxmb_util_get_u16_be(&adu->data[NXMB_FC05_VALUE_OFF]);
 
   if (addr == 0xffffu)
     {
@@ -198,9 +200,10 @@ enum nxmb_exception_e nxmb_fc05_write_coil(nxmb_handle_t ctx)
  * Name: nxmb_fc15_write_coils
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc15_write_coils(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc15_write_coils(nxmb_handle_t ctx,
+                                            FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t addr;
   uint16_t qty;
   uint8_t  byte_count;
@@ -217,9 +220,9 @@ enum nxmb_exception_e nxmb_fc15_write_coils(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  addr       = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC15_ADDR_OFF]);
-  qty        = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC15_QTY_OFF]);
-  byte_count = ctx->adu.data[NXMB_FC15_BCNT_OFF];
+  addr       = nxmb_util_get_u16_be(&adu->data[NXMB_FC15_ADDR_OFF]);
+  qty        = nxmb_util_get_u16_be(&adu->data[NXMB_FC15_QTY_OFF]);
+  byte_count = adu->data[NXMB_FC15_BCNT_OFF];
 
   if (qty < 1 || qty > NXMB_COIL_WRITE_QTY_MAX)
     {
@@ -245,7 +248,7 @@ enum nxmb_exception_e nxmb_fc15_write_coils(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  ret = ctx->callbacks->coil_cb(&ctx->adu.data[NXMB_FC15_DATA_OFF], addr,
+  ret = ctx->callbacks->coil_cb(&adu->data[NXMB_FC15_DATA_OFF], addr,
                                 qty, NXMB_REG_WRITE, ctx->callbacks->priv);
   if (ret != 0)
     {
@@ -254,6 +257,6 @@ enum nxmb_exception_e nxmb_fc15_write_coils(nxmb_handle_t ctx)
 
   /* Response: addr(2) + qty(2) — already in data[0..3] from request */
 
-  ctx->adu.length = (uint16_t)(2 + NXMB_FC15_RESP_DATA_LEN);
+  adu->length = (uint16_t)(2 + NXMB_FC15_RESP_DATA_LEN);
   return NXMB_EX_NONE;
 }
@@ -54,9 +54,10 @@
  * Name: nxmb_fc08_diagnostics
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc08_diagnostics(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc08_diagnostics(nxmb_handle_t ctx,
+                                            FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t subfunc;
 
   if (data_len < NXMB_DIAG_REQ_MIN_DATA_LEN)
@@ -64,7 +65,7 @@ enum nxmb_exception_e nxmb_fc08_diagnostics(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  subfunc = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_DIAG_SUBFUNC_OFF]);
+  subfunc = nxmb_util_get_u16_be(&adu->data[NXMB_DIAG_SUBFUNC_OFF]);
 
   switch (subfunc)
     {
@@ -53,9 +53,10 @@
  * Name: nxmb_fc02_read_discrete
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc02_read_discrete(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc02_read_discrete(nxmb_handle_t ctx,
+                                              FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t addr;
   uint16_t qty;
   uint8_t  nbytes;
@@ -71,8 +72,8 @@ enum nxmb_exception_e nxmb_fc02_read_discrete(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  addr = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC02_ADDR_OFF]);
-  qty  = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC02_QTY_OFF]);
+  addr = nxmb_util_get_u16_be(&adu->data[NXMB_FC02_ADDR_OFF]);
+  qty  = nxmb_util_get_u16_be(&adu->data[NXMB_FC02_QTY_OFF]);
 
   if (qty < 1 || qty > NXMB_DISCRETE_QTY_MAX)
     {
@@ -93,18 +94,18 @@ enum nxmb_exception_e nxmb_fc02_read_discrete(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  ctx->adu.fc      = NXMB_FC_READ_DISCRETE;
-  ctx->adu.data[0] = nbytes;
+  adu->fc      = NXMB_FC_READ_DISCRETE;
+  adu->data[0] = nbytes;
 
-  memset(&ctx->adu.data[1], 0, nbytes);
+  memset(&adu->data[1], 0, nbytes);
 
-  ret = ctx->callbacks->discrete_cb(&ctx->adu.data[1], addr, qty,
+  ret = ctx->callbacks->discrete_cb(&adu->data[1], addr, qty,
                                     ctx->callbacks->priv);
   if (ret != 0)
     {
       return nxmb_cb_ret_to_exception(ret);
     }
 
-  ctx->adu.length = (uint16_t)(2 + 1 + nbytes);
+  adu->length = (uint16_t)(2 + 1 + nbytes);
   return NXMB_EX_NONE;
 }
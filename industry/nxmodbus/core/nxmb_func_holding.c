@@ -28,6 +28,7 @@
 
 #include <nuttx/compiler.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nxmodbus/nxmodbus.h>
@@ -38,7 +39,7 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* PDU data offsets are relative to ctx->adu.data[] (after unit_id + fc).
+/* PDU data offsets are relative to adu->data[] (after unit_id + fc).
  * Lengths refer to the data payload only — adu.length = 2 + data_len.
  */
 
@@ -79,6 +80,61 @@
 #define NXMB_REG_READWRITE_RD_QTY_MAX 125 /* 0x007D */
 #define NXMB_REG_READWRITE_WR_QTY_MAX 121 /* 0x0079 */
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmb_holding_enabled
+ ****************************************************************************/
+
+static bool nxmb_holding_enabled(nxmb_handle_t ctx)
+{
+#ifdef CONFIG_NXMODBUS_REGBANK
+  if (ctx->regbank != NULL && ctx->regbank->holding != NULL)
+    {
+      return true;
+    }
+#endif
+
+  return ctx->callbacks != NULL && ctx->callbacks->holding_cb != NULL;
+}
+
+/****************************************************************************
+ * Name: nxmb_holding_access
+ *
+ * Description:
+ *   Access holding registers in the register bank if it holds the whole
+ *   range, through the application callback otherwise.
+ *
+ ****************************************************************************/
+
+static int nxmb_holding_access(nxmb_handle_t ctx, FAR uint8_t *buf,
+                               uint16_t addr, uint16_t nregs,
+                               enum nxmb_regmode_e mode)
+{
+#ifdef CONFIG_NXMODBUS_REGBANK
+  int ret;
+
+  if (ctx->regbank != NULL)
+    {
+      ret = nxmb_regbank_holding(ctx->regbank, buf, addr, nregs, mode);
+      if (ret != -ENOENT)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  if (ctx->callbacks == NULL || ctx->callbacks->holding_cb == NULL)
+    {
+      return -ENOENT;
+    }
+
+  return ctx->callbacks->holding_cb(buf, addr, nregs, mode,
+                                    ctx->callbacks->priv);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -87,9 +143,10 @@
  * Name: nxmb_fc03_read_holding
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc03_read_holding(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc03_read_holding(nxmb_handle_t ctx,
+                                             FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t addr;
   uint16_t qty;
   uint8_t  nbytes;
@@ -100,13 +157,13 @@ enum nxmb_exception_e nxmb_fc03_read_holding(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  if (ctx->callbacks == NULL || ctx->callbacks->holding_cb == NULL)
+  if (!nxmb_holding_enabled(ctx))
     {
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  addr = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC03_ADDR_OFF]);
-  qty  = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC03_QTY_OFF]);
+  addr = nxmb_util_get_u16_be(&adu->data[NXMB_FC03_ADDR_OFF]);
+  qty  = nxmb_util_get_u16_be(&adu->data[NXMB_FC03_QTY_OFF]);
 
   if (qty < 1 || qty > NXMB_REG_READ_QTY_MAX)
     {
@@ -129,17 +186,17 @@ enum nxmb_exception_e nxmb_fc03_read_holding(nxmb_handle_t ctx)
 
   /* Build response: byte_count + register data (big-endian) */
 
-  ctx->adu.fc      = NXMB_FC_READ_HOLDING;
-  ctx->adu.data[0] = nbytes;
+  adu->fc      = NXMB_FC_READ_HOLDING;
+  adu->data[0] = nbytes;
 
-  ret = ctx->callbacks->holding_cb(&ctx->adu.data[1], addr, qty,
-                                   NXMB_REG_READ, ctx->callbacks->priv);
+  ret = nxmb_holding_access(ctx, &adu->data[1], addr, qty,
+                            NXMB_REG_READ);
   if (ret != 0)
     {
       return nxmb_cb_ret_to_exception(ret);
     }
 
-  ctx->adu.length = (uint16_t)(2 + 1 + nbytes);
+  adu->length = (uint16_t)(2 + 1 + nbytes);
   return NXMB_EX_NONE;
 }
 
@@ -147,9 +204,10 @@ enum nxmb_exception_e nxmb_fc03_read_holding(nxmb_handle_t ctx)
  * Name: nxmb_fc06_write_holding
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc06_write_holding(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc06_write_holding(nxmb_handle_t ctx,
+                                              FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t addr;
   int      ret;
 
@@ -158,20 +216,20 @@ enum nxmb_exception_e nxmb_fc06_write_holding(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  if (ctx->callbacks == NULL || ctx->callbacks->holding_cb == NULL)
+  if (!nxmb_holding_enabled(ctx))
     {
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  addr = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC06_ADDR_OFF]);
+  addr = nxmb_util_get_u16_be(&adu->data[NXMB_FC06_ADDR_OFF]);
 
   if (addr == 0xffffu)
     {
       return NXMB_EX_ILLEGAL_DATA_ADDRESS;
     }
 
-  ret = ctx->callbacks->holding_cb(&ctx->adu.data[NXMB_FC06_VALUE_OFF], addr,
-                                   1, NXMB_REG_WRITE, ctx->callbacks->priv);
+  ret = nxmb_holding_access(ctx, &adu->data[NXMB_FC06_VALUE_OFF], addr, 1,
+                            NXMB_REG_WRITE);
   if (ret != 0)
     {
       return nxmb_cb_ret_to_exception(ret);
@@ -186,9 +244,10 @@ enum nxmb_exception_e nxmb_fc06_write_holding(nxmb_handle_t ctx)
  * Name: nxmb_fc16_write_holdings
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc16_write_holdings(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc16_write_holdings(nxmb_handle_t ctx,
+                                               FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t addr;
   uint16_t qty;
   uint8_t  byte_count;
@@ -199,14 +258,14 @@ enum nxmb_exception_e nxmb_fc16_write_holdings(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  if (ctx->callbacks == NULL || ctx->callbacks->holding_cb == NULL)
+  if (!nxmb_holding_enabled(ctx))
     {
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  addr       = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC16_ADDR_OFF]);
-  qty        = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC16_QTY_OFF]);
-  byte_count = ctx->adu.data[NXMB_FC16_BCNT_OFF];
+  addr       = nxmb_util_get_u16_be(&adu->data[NXMB_FC16_ADDR_OFF]);
+  qty        = nxmb_util_get_u16_be(&adu->data[NXMB_FC16_QTY_OFF]);
+  byte_count = adu->data[NXMB_FC16_BCNT_OFF];
 
   if (qty < 1 || qty > NXMB_REG_WRITE_MUL_QTY_MAX)
     {
@@ -230,9 +289,8 @@ enum nxmb_exception_e nxmb_fc16_write_holdings(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  ret = ctx->callbacks->holding_cb(&ctx->adu.data[NXMB_FC16_DATA_OFF], addr,
-                                   qty, NXMB_REG_WRITE,
-                                   ctx->callbacks->priv);
+  ret = nxmb_holding_access(ctx, &adu->data[NXMB_FC16_DATA_OFF], addr,
+                            qty, NXMB_REG_WRITE);
   if (ret != 0)
     {
       return nxmb_cb_ret_to_exception(ret);
@@ -240,7 +298,7 @@ enum nxmb_exception_e nxmb_fc16_write_holdings(nxmb_handle_t ctx)
 
   /* Response: addr(2) + qty(2) — already in data[0..3] from request */
 
-  ctx->adu.length = (uint16_t)(2 + NXMB_FC16_RESP_DATA_LEN);
+  adu->length = (uint16_t)(2 + NXMB_FC16_RESP_DATA_LEN);
   return NXMB_EX_NONE;
 }
 
@@ -248,9 +306,10 @@ enum nxmb_exception_e nxmb_fc16_write_holdings(nxmb_handle_t ctx)
  * Name: nxmb_fc23_readwrite_holding
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc23_readwrite_holding(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc23_readwrite_holding(nxmb_handle_t ctx,
+                                                  FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t rd_addr;
   uint16_t rd_qty;
   uint16_t wr_addr;
@@ -264,16 +323,16 @@ enum nxmb_exception_e nxmb_fc23_readwrite_holding(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  if (ctx->callbacks == NULL || ctx->callbacks->holding_cb == NULL)
+  if (!nxmb_holding_enabled(ctx))
     {
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  rd_addr = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC23_RD_ADDR_OFF]);
-  rd_qty  = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC23_RD_QTY_OFF]);
-  wr_addr = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC23_WR_ADDR_OFF]);
-  wr_qty  = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC23_WR_QTY_OFF]);
-  wr_bcnt = ctx->adu.data[NXMB_FC23_WR_BCNT_OFF];
+  rd_addr = nxmb_util_get_u16_be(&adu->data[NXMB_FC23_RD_ADDR_OFF]);
+  rd_qty  = nxmb_util_get_u16_be(&adu->data[NXMB_FC23_RD_QTY_OFF]);
+  wr_addr = nxmb_util_get_u16_be(&adu->data[NXMB_FC23_WR_ADDR_OFF]);
+  wr_qty  = nxmb_util_get_u16_be(&adu->data[NXMB_FC23_WR_QTY_OFF]);
+  wr_bcnt = adu->data[NXMB_FC23_WR_BCNT_OFF];
 
   if (rd_qty < 1 || rd_qty > NXMB_REG_READWRITE_RD_QTY_MAX || wr_qty < 1 ||
       wr_qty > NXMB_REG_READWRITE_WR_QTY_MAX || wr_bcnt != (wr_qty * 2))
@@ -305,9 +364,8 @@ enum nxmb_exception_e nxmb_fc23_readwrite_holding(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  ret = ctx->callbacks->holding_cb(&ctx->adu.data[NXMB_FC23_WR_DATA_OFF],
-                                   wr_addr, wr_qty, NXMB_REG_WRITE,
-                                   ctx->callbacks->priv);
+  ret = nxmb_holding_access(ctx, &adu->data[NXMB_FC23_WR_DATA_OFF],
+                            wr_addr, wr_qty, NXMB_REG_WRITE);
   if (ret != 0)
     {
       return nxmb_cb_ret_to_exception(ret);
@@ -315,17 +373,17 @@ enum nxmb_exception_e nxmb_fc23_readwrite_holding(nxmb_handle_t ctx)
 
   /* Build response: byte_count + read register data, overwriting request */
 
-  ctx->adu.fc      = NXMB_FC_READWRITE_HOLDINGS;
-  rd_bcnt          = rd_qty * 2;
-  ctx->adu.data[0] = (uint8_t)rd_bcnt;
+  adu->fc      = NXMB_FC_READWRITE_HOLDINGS;
+  rd_bcnt      = rd_qty * 2;
+  adu->data[0] = (uint8_t)rd_bcnt;
 
-  ret = ctx->callbacks->holding_cb(&ctx->adu.data[1], rd_addr, rd_qty,
-                                   NXMB_REG_READ, ctx->callbacks->priv);
+  ret = nxmb_holding_access(ctx, &adu->data[1], rd_addr, rd_qty,
+                            NXMB_REG_READ);
   if (ret != 0)
     {
       return nxmb_cb_ret_to_exception(ret);
     }
 
-  ctx->adu.length = (uint16_t)(2 + 1 + rd_bcnt);
+  adu->length = (uint16_t)(2 + 1 + rd_bcnt);
   return NXMB_EX_NONE;
 }
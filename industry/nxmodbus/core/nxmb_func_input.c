@@ -28,6 +28,7 @@
 
 #include <nuttx/compiler.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nxmodbus/nxmodbus.h>
@@ -50,6 +51,59 @@
 
 #define NXMB_REG_READ_QTY_MAX  125 /* 0x007D */
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmb_input_enabled
+ ****************************************************************************/
+
+static bool nxmb_input_enabled(nxmb_handle_t ctx)
+{
+#ifdef CONFIG_NXMODBUS_REGBANK
+  if (ctx->regbank != NULL && ctx->regbank->input != NULL)
+    {
+      return true;
+    }
+#endif
+
+  return ctx->callbacks != NULL && ctx->callbacks->input_cb != NULL;
+}
+
+/****************************************************************************
+ * Name: nxmb_input_access
+ *
+ * Description:
+ *   Read input registers from the register bank if it holds the whole
+ *   range, through the application callback otherwise.
+ *
+ ****************************************************************************/
+
+static int nxmb_input_access(nxmb_handle_t ctx, FAR uint8_t *buf,
+                             uint16_t addr, uint16_t nregs)
+{
+#ifdef CONFIG_NXMODBUS_REGBANK
+  int ret;
+
+  if (ctx->regbank != NULL)
+    {
+      ret = nxmb_regbank_input(ctx->regbank, buf, addr, nregs);
+      if (ret != -ENOENT)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  if (ctx->callbacks == NULL || ctx->callbacks->input_cb == NULL)
+    {
+      return -ENOENT;
+    }
+
+  return ctx->callbacks->input_cb(buf, addr, nregs, ctx->callbacks->priv);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -58,9 +112,10 @@
  * Name: nxmb_fc04_read_input
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc04_read_input(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc04_read_input(nxmb_handle_t ctx,
+                                           FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
   uint16_t addr;
   uint16_t qty;
   uint8_t  nbytes;
@@ -71,13 +126,13 @@ enum nxmb_exception_e nxmb_fc04_read_input(nxmb_handle_t ctx)
       return NXMB_EX_ILLEGAL_DATA_VALUE;
     }
 
-  if (ctx->callbacks == NULL || ctx->callbacks->input_cb == NULL)
+  if (!nxmb_input_enabled(ctx))
     {
       return NXMB_EX_ILLEGAL_FUNCTION;
     }
 
-  addr = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC04_ADDR_OFF]);
-  qty  = nxmb_util_get_u16_be(&ctx->adu.data[NXMB_FC04_QTY_OFF]);
+  addr = nxmb_util_get_u16_be(&adu->data[NXMB_FC04_ADDR_OFF]);
+  qty  = nxmb_util_get_u16_be(&adu->data[NXMB_FC04_QTY_OFF]);
 
   if (qty < 1 || qty > NXMB_REG_READ_QTY_MAX)
     {
@@ -100,16 +155,15 @@ enum nxmb_exception_e nxmb_fc04_read_input(nxmb_handle_t ctx)
 
   /* Build response: byte_count + register data (big-endian) */
 
-  ctx->adu.fc      = NXMB_FC_READ_INPUT;
-  ctx->adu.data[0] = nbytes;
+  adu->fc      = NXMB_FC_READ_INPUT;
+  adu->data[0] = nbytes;
 
-  ret = ctx->callbacks->input_cb(&ctx->adu.data[1], addr, qty,
-                                 ctx->callbacks->priv);
+  ret = nxmb_input_access(ctx, &adu->data[1], addr, qty);
   if (ret != 0)
     {
       return nxmb_cb_ret_to_exception(ret);
     }
 
-  ctx->adu.length = (uint16_t)(2 + 1 + nbytes);
+  adu->length = (uint16_t)(2 + 1 + nbytes);
   return NXMB_EX_NONE;
 }
@@ -59,9 +59,10 @@
  *
  ****************************************************************************/
 
-enum nxmb_exception_e nxmb_fc17_report_server_id(nxmb_handle_t ctx)
+enum nxmb_exception_e nxmb_fc17_report_server_id(nxmb_handle_t ctx,
+                                                 FAR struct nxmb_adu_s *adu)
 {
-  uint16_t data_len = ctx->adu.length - 2;
+  uint16_t data_len = adu->length - 2;
 
   if (data_len != NXMB_REPORT_ID_REQ_DATA_LEN)
     {
@@ -72,7 +73,7 @@ enum nxmb_exception_e nxmb_fc17_report_server_id(nxmb_handle_t ctx)
    * use that; otherwise fall back to unit_id + run status ON.
    */
 
-  ctx->adu.fc = NXMB_FC_REPORT_SERVER_ID;
+  adu->fc = NXMB_FC_REPORT_SERVER_ID;
 
   if (ctx->server_id_len > 0)
     {
@@ -83,16 +84,16 @@ enum nxmb_exception_e nxmb_fc17_report_server_id(nxmb_handle_t ctx)
           return NXMB_EX_DEVICE_FAILURE;
         }
 
-      ctx->adu.data[0] = (uint8_t)ctx->server_id_len;
-      memcpy(&ctx->adu.data[1], ctx->server_id_buf, ctx->server_id_len);
-      ctx->adu.length = (uint16_t)(2 + 1 + ctx->server_id_len);
+      adu->data[0] = (uint8_t)ctx->server_id_len;
+      memcpy(&adu->data[1], ctx->server_id_buf, ctx->server_id_len);
+      adu->length = (uint16_t)(2 + 1 + ctx->server_id_len);
     }
   else
     {
-      ctx->adu.data[0] = 2;                  /* byte count */
-      ctx->adu.data[1] = ctx->unit_id;       /* server ID */
-      ctx->adu.data[2] = NXMB_RUN_STATUS_ON; /* run indicator */
-      ctx->adu.length  = (uint16_t)(2 + 3);
+      adu->data[0] = 2;                  /* byte count */
+      adu->data[1] = ctx->unit_id;       /* server ID */
+      adu->data[2] = NXMB_RUN_STATUS_ON; /* run indicator */
+      adu->length  = (uint16_t)(2 + 3);
     }
 
   return NXMB_EX_NONE;
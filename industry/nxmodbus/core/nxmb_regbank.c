@@ -0,0 +1,313 @@
+/****************************************************************************
+ * apps/industry/nxmodbus/core/nxmb_regbank.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nxmodbus/nxmb_regbank.h>
+#include <nxmodbus/nxmodbus.h>
+
+#include "nxmb_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Lock-free read attempts before a reader waits for the writer on the
+ * lock. A writer that was preempted in the middle of an update would
+ * otherwise keep a higher priority reader spinning forever.
+ */
+
+#define NXMB_REGBANK_RETRIES 4
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmb_regbank_copy
+ *
+ * Description:
+ *   Copy registers out of the bank, to big-endian wire format if wire is
+ *   true or in host byte order otherwise.
+ *
+ ****************************************************************************/
+
+static void nxmb_regbank_copy(FAR const uint16_t *regs, uint16_t count,
+                              FAR void *buf, bool wire)
+{
+  FAR volatile const uint16_t *src = regs;
+  FAR uint8_t                 *dst8;
+  FAR uint16_t                *dst16;
+  uint16_t                     i;
+
+  if (wire)
+    {
+      dst8 = buf;
+      for (i = 0; i < count; i++)
+        {
+          nxmb_util_put_u16_be(&dst8[i * 2], src[i]);
+        }
+    }
+  else
+    {
+      dst16 = buf;
+      for (i = 0; i < count; i++)
+        {
+          dst16[i] = src[i];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxmb_regbank_snapshot
+ *
+ * Description:
+ *   Copy registers out of the bank without tearing. The copy is retried
+ *   if an update ran while it was made.
+ *
+ ****************************************************************************/
+
+static void nxmb_regbank_snapshot(FAR struct nxmb_regbank_s *bank,
+                                  FAR const uint16_t *regs, uint16_t count,
+                                  FAR void *buf, bool wire)
+{
+  unsigned int seq;
+  int          i;
+
+  for (i = 0; i < NXMB_REGBANK_RETRIES; i++)
+    {
+      seq = atomic_load_explicit(&bank->seq, memory_order_acquire);
+      if (seq & 1)
+        {
+          continue;
+        }
+
+      nxmb_regbank_copy(regs, count, buf, wire);
+
+      atomic_thread_fence(memory_order_acquire);
+      if (atomic_load_explicit(&bank->seq, memory_order_relaxed) == seq)
+        {
+          return;
+        }
+    }
+
+  /* Wait for the writer, with priority inheritance from the lock */
+
+  pthread_mutex_lock(&bank->lock);
+  nxmb_regbank_copy(regs, count, buf, wire);
+  pthread_mutex_unlock(&bank->lock);
+}
+
+/****************************************************************************
+ * Name: nxmb_regbank_find
+ *
+ * Description:
+ *   Get the bank register for addr if the whole range addr..addr+nregs-1
+ *   is inside the table.
+ *
+ ****************************************************************************/
+
+static FAR uint16_t *nxmb_regbank_find(FAR uint16_t *table, uint16_t start,
+                                       uint16_t count, uint16_t addr,
+                                       uint16_t nregs)
+{
+  if (table == NULL || addr < start ||
+      (uint32_t)addr + nregs > (uint32_t)start + count)
+    {
+      return NULL;
+    }
+
+  return &table[addr - start];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmb_regbank_init
+ ****************************************************************************/
+
+int nxmb_regbank_init(FAR struct nxmb_regbank_s *bank)
+{
+  DEBUGASSERT(bank);
+
+  if ((bank->holding == NULL && bank->holding_count > 0) ||
+      (bank->input == NULL && bank->input_count > 0))
+    {
+      return -EINVAL;
+    }
+
+  atomic_init(&bank->seq, 0);
+
+  return -pthread_mutex_init(&bank->lock, NULL);
+}
+
+/****************************************************************************
+ * Name: nxmb_regbank_deinit
+ ****************************************************************************/
+
+void nxmb_regbank_deinit(FAR struct nxmb_regbank_s *bank)
+{
+  DEBUGASSERT(bank);
+
+  pthread_mutex_destroy(&bank->lock);
+}
+
+/****************************************************************************
+ * Name: nxmb_regbank_write_begin
+ ****************************************************************************/
+
+void nxmb_regbank_write_begin(FAR struct nxmb_regbank_s *bank)
+{
+  unsigned int seq;
+
+  DEBUGASSERT(bank);
+
+  pthread_mutex_lock(&bank->lock);
+
+  /* Odd sequence tells the readers that the tables are changing. The
+   * fence keeps the table stores after the sequence store.
+   */
+
+  seq = atomic_load_explicit(&bank->seq, memory_order_relaxed);
+  atomic_store_explicit(&bank->seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+}
+
+/****************************************************************************
+ * Name: nxmb_regbank_write_end
+ ****************************************************************************/
+
+void nxmb_regbank_write_end(FAR struct nxmb_regbank_s *bank)
+{
+  unsigned int seq;
+
+  DEBUGASSERT(bank);
+
+  seq = atomic_load_explicit(&bank->seq, memory_order_relaxed);
+  atomic_store_explicit(&bank->seq, seq + 1, memory_order_release);
+
+  pthread_mutex_unlock(&bank->lock);
+}
+
+/****************************************************************************
+ * Name: nxmb_regbank_read
+ ****************************************************************************/
+
+void nxmb_regbank_read(FAR struct nxmb_regbank_s *bank,
+                       FAR const uint16_t *regs, uint16_t count,
+                       FAR uint16_t *buf)
+{
+  DEBUGASSERT(bank && regs && buf);
+
+  nxmb_regbank_snapshot(bank, regs, count, buf, false);
+}
+
+/****************************************************************************
+ * Name: nxmb_set_regbank
+ ****************************************************************************/
+
+int nxmb_set_regbank(nxmb_handle_t ctx, FAR struct nxmb_regbank_s *bank)
+{
+  DEBUGASSERT(ctx);
+
+  if (ctx->is_client)
+    {
+      return -ENOTSUP;
+    }
+
+  pthread_mutex_lock(&ctx->lock);
+  nxmb_data_wrlock(ctx);
+  ctx->regbank = bank;
+  nxmb_data_unlock(ctx);
+  pthread_mutex_unlock(&ctx->lock);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmb_regbank_holding
+ ****************************************************************************/
+
+int nxmb_regbank_holding(FAR struct nxmb_regbank_s *bank, FAR uint8_t *buf,
+                         uint16_t addr, uint16_t nregs,
+                         enum nxmb_regmode_e mode)
+{
+  FAR uint16_t *regs;
+  uint16_t      i;
+
+  regs = nxmb_regbank_find(bank->holding, bank->holding_start,
+                           bank->holding_count, addr, nregs);
+  if (regs == NULL)
+    {
+      return -ENOENT;
+    }
+
+  if (mode == NXMB_REG_READ)
+    {
+      nxmb_regbank_snapshot(bank, regs, nregs, buf, true);
+      return OK;
+    }
+
+  nxmb_regbank_write_begin(bank);
+
+  for (i = 0; i < nregs; i++)
+    {
+      regs[i] = nxmb_util_get_u16_be(&buf[i * 2]);
+    }
+
+  nxmb_regbank_write_end(bank);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmb_regbank_input
+ ****************************************************************************/
+
+int nxmb_regbank_input(FAR struct nxmb_regbank_s *bank, FAR uint8_t *buf,
+                       uint16_t addr, uint16_t nregs)
+{
+  FAR uint16_t *regs;
+
+  regs = nxmb_regbank_find(bank->input, bank->input_start,
+                           bank->input_count, addr, nregs);
+  if (regs == NULL)
+    {
+      return -ENOENT;
+    }
+
+  nxmb_regbank_snapshot(bank, regs, nregs, buf, true);
+
+  return OK;
+}
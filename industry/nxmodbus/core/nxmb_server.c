@@ -43,6 +43,82 @@
 
 #define NXMB_FUNC_ERROR 0x80
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+/****************************************************************************
+ * Name: nxmb_poll_txn
+ *
+ * Description:
+ *   Serve one request taken from a transport with transaction support.
+ *   ctx->lock is held only to check the instance state, so other threads
+ *   can serve requests at the same time. Read-only requests share the
+ *   data model lock, everything else takes it exclusively.
+ *
+ ****************************************************************************/
+
+static int nxmb_poll_txn(nxmb_handle_t ctx)
+{
+  struct nxmb_txn_s txn;
+  uint8_t           rcv_address;
+  bool              reply;
+  int               ret;
+
+  pthread_mutex_lock(&ctx->lock);
+
+  if (!ctx->enabled)
+    {
+      pthread_mutex_unlock(&ctx->lock);
+      return -EAGAIN;
+    }
+
+  ctx->pollers++;
+  pthread_mutex_unlock(&ctx->lock);
+
+  ret = ctx->transport_ops->txn_get(ctx, &txn);
+  if (ret <= 0)
+    {
+      goto out;
+    }
+
+  rcv_address = txn.adu.unit_id;
+  reply       = false;
+
+  if (rcv_address == NXMB_ADDRESS_BROADCAST || rcv_address == ctx->unit_id)
+    {
+      if (txn.rdonly)
+        {
+          nxmb_data_rdlock(ctx);
+        }
+      else
+        {
+          nxmb_data_wrlock(ctx);
+        }
+
+      nxmb_dispatch_function(ctx, &txn.adu);
+      nxmb_data_unlock(ctx);
+
+      reply = rcv_address != NXMB_ADDRESS_BROADCAST;
+    }
+
+  ret = ctx->transport_ops->txn_put(ctx, &txn, reply);
+
+out:
+  pthread_mutex_lock(&ctx->lock);
+
+  if (--ctx->pollers == 0)
+    {
+      pthread_cond_broadcast(&ctx->idle);
+    }
+
+  pthread_mutex_unlock(&ctx->lock);
+
+  return ret < 0 ? ret : 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -68,6 +144,13 @@ int nxmb_poll(nxmb_handle_t ctx)
 
   DEBUGASSERT(ctx && ctx->transport_ops && ctx->transport_ops->receive);
 
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  if (ctx->transport_ops->txn_get != NULL && !ctx->is_client)
+    {
+      return nxmb_poll_txn(ctx);
+    }
+#endif
+
   pthread_mutex_lock(&ctx->lock);
 
   if (!ctx->enabled)
@@ -101,7 +184,7 @@ int nxmb_poll(nxmb_handle_t ctx)
    * turning the request into the response.
    */
 
-  ret = nxmb_dispatch_function(ctx);
+  ret = nxmb_dispatch_function(ctx, &ctx->adu);
 
   if (rcv_address != NXMB_ADDRESS_BROADCAST)
     {
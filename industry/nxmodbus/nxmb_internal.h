@@ -36,6 +36,7 @@
 #include <stdint.h>
 #include <time.h>
 
+#include <nxmodbus/nxmb_regbank.h>
 #include <nxmodbus/nxmodbus.h>
 
 /****************************************************************************
@@ -60,12 +61,32 @@
 #define NXMB_FC_REPORT_SERVER_ID   0x11
 #define NXMB_FC_READWRITE_HOLDINGS 0x17
 
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+/* Server transaction. The transport fills adu with a request and keeps
+ * track of the connection it came from, the core turns the request into
+ * the response in place.
+ */
+
+struct nxmb_txn_s
+{
+  struct nxmb_adu_s adu;
+  uint8_t           conn;     /* Connection index */
+  bool              rdonly;   /* Read-only function code */
+};
+#endif
+
 /* Transport operations interface.
  *
  * receive() must not block indefinitely. Implementations should use an
  * internal timeout (e.g. select()) and return 0 or -EAGAIN when no
  * complete frame is available yet. The client polling loop relies on
  * this to enforce its own response timeout.
+ *
+ * txn_get() and txn_put() are optional. When provided, a server takes
+ * requests with txn_get() and returns each of them with txn_put(), which
+ * sends the response if reply is true. Both may be called from several
+ * threads at once, and several requests may be taken before the first
+ * one is returned.
  */
 
 struct nxmb_transport_ops_s
@@ -74,6 +95,11 @@ struct nxmb_transport_ops_s
   CODE int (*deinit)(nxmb_handle_t ctx);
   CODE int (*send)(nxmb_handle_t ctx);
   CODE int (*receive)(nxmb_handle_t ctx);
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  CODE int (*txn_get)(nxmb_handle_t ctx, FAR struct nxmb_txn_s *txn);
+  CODE int (*txn_put)(nxmb_handle_t ctx, FAR struct nxmb_txn_s *txn,
+                      bool reply);
+#endif
 };
 
 /* Custom function code handler */
@@ -118,6 +144,21 @@ struct nxmb_context_s
   FAR struct nxmb_custom_fc_s *custom_fc_list;
   FAR void                    *transport_state;
   FAR void                    *client_state;
+
+#ifdef CONFIG_NXMODBUS_REGBANK
+  FAR struct nxmb_regbank_s   *regbank;
+#endif
+
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  /* Concurrent server: data_lock serializes access to the application
+   * data model (shared for read-only function codes), pollers counts the
+   * threads inside nxmb_poll() so that nxmb_disable() can wait for them.
+   */
+
+  pthread_rwlock_t data_lock;
+  pthread_cond_t   idle;
+  uint8_t          pollers;
+#endif
 };
 
 /****************************************************************************
@@ -165,6 +206,48 @@ static inline enum nxmb_exception_e nxmb_cb_ret_to_exception(int ret)
   return NXMB_EX_DEVICE_FAILURE;
 }
 
+/****************************************************************************
+ * Name: nxmb_data_rdlock
+ *
+ * Description:
+ *   Lock the application data model for a read-only request. No-op unless
+ *   the concurrent server is enabled.
+ *
+ ****************************************************************************/
+
+static inline void nxmb_data_rdlock(nxmb_handle_t ctx)
+{
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  pthread_rwlock_rdlock(&ctx->data_lock);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxmb_data_wrlock
+ *
+ * Description:
+ *   Lock the application data model for exclusive access.
+ *
+ ****************************************************************************/
+
+static inline void nxmb_data_wrlock(nxmb_handle_t ctx)
+{
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  pthread_rwlock_wrlock(&ctx->data_lock);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxmb_data_unlock
+ ****************************************************************************/
+
+static inline void nxmb_data_unlock(nxmb_handle_t ctx)
+{
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  pthread_rwlock_unlock(&ctx->data_lock);
+#endif
+}
+
 /****************************************************************************
  * Name: nxmb_util_get_u16_be
  *
@@ -208,6 +291,22 @@ static inline uint64_t nxmb_util_clock_ms(void)
   return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 }
 
+/****************************************************************************
+ * Name: nxmb_util_clock_us
+ *
+ * Description:
+ *   Return the current monotonic clock value in microseconds.
+ *
+ ****************************************************************************/
+
+static inline uint64_t nxmb_util_clock_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -347,33 +446,96 @@ int nxmb_client_deinit(nxmb_handle_t ctx);
  *
  * Description:
  *   Dispatch a Modbus function code to the appropriate handler. Operates
- *   in place on ctx->adu.
+ *   in place on the given ADU.
  *
  * Input Parameters:
  *   ctx - Instance context
+ *   adu - Request ADU, ctx->adu or a transaction buffer
  *
  * Returned Value:
  *   Zero on success; a negated errno value on failure
  *
  ****************************************************************************/
 
-int nxmb_dispatch_function(nxmb_handle_t ctx);
+int nxmb_dispatch_function(nxmb_handle_t ctx, FAR struct nxmb_adu_s *adu);
+
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+/****************************************************************************
+ * Name: nxmb_fc_is_read_only
+ *
+ * Description:
+ *   Check if a function code only reads the application data model.
+ *
+ * Input Parameters:
+ *   fc - Function code
+ *
+ * Returned Value:
+ *   True if the function code is read-only
+ *
+ ****************************************************************************/
+
+bool nxmb_fc_is_read_only(uint8_t fc);
+#endif
+
+#ifdef CONFIG_NXMODBUS_REGBANK
+/****************************************************************************
+ * Name: nxmb_regbank_holding
+ *
+ * Description:
+ *   Read or write holding registers of a register bank, buf is in wire
+ *   format (big-endian).
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if the range is not inside the bank
+ *
+ ****************************************************************************/
+
+int nxmb_regbank_holding(FAR struct nxmb_regbank_s *bank, FAR uint8_t *buf,
+                         uint16_t addr, uint16_t nregs,
+                         enum nxmb_regmode_e mode);
+
+/****************************************************************************
+ * Name: nxmb_regbank_input
+ *
+ * Description:
+ *   Read input registers of a register bank, buf is in wire format
+ *   (big-endian).
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if the range is not inside the bank
+ *
+ ****************************************************************************/
+
+int nxmb_regbank_input(FAR struct nxmb_regbank_s *bank, FAR uint8_t *buf,
+                       uint16_t addr, uint16_t nregs);
+#endif
 
-/* Function-code handlers operate on ctx->adu in place: they read the
- * request from adu.fc/adu.data[]/adu.length and overwrite those fields
+/* Function-code handlers operate on the given ADU in place: they read the
+ * request from adu->fc/adu->data[]/adu->length and overwrite those fields
  * with the response.
  */
 
-enum nxmb_exception_e nxmb_fc01_read_coils(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc02_read_discrete(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc05_write_coil(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc15_write_coils(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc03_read_holding(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc04_read_input(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc06_write_holding(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc16_write_holdings(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc23_readwrite_holding(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc08_diagnostics(nxmb_handle_t ctx);
-enum nxmb_exception_e nxmb_fc17_report_server_id(nxmb_handle_t ctx);
+enum nxmb_exception_e nxmb_fc01_read_coils(nxmb_handle_t ctx,
+                                           FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc02_read_discrete(nxmb_handle_t ctx,
+                                              FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc05_write_coil(nxmb_handle_t ctx,
+                                           FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc15_write_coils(nxmb_handle_t ctx,
+                                            FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc03_read_holding(nxmb_handle_t ctx,
+                                             FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc04_read_input(nxmb_handle_t ctx,
+                                           FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc06_write_holding(nxmb_handle_t ctx,
+                                              FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc16_write_holdings(nxmb_handle_t ctx,
+                                               FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc23_readwrite_holding(nxmb_handle_t ctx,
+                                                  FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc08_diagnostics(nxmb_handle_t ctx,
+                                            FAR struct nxmb_adu_s *adu);
+enum nxmb_exception_e nxmb_fc17_report_server_id(nxmb_handle_t ctx,
+                                                 FAR struct nxmb_adu_s *adu);
 
 #endif /* __APPS_INDUSTRY_NXMODBUS_NXMB_INTERNAL_H */
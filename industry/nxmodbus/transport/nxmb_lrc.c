@@ -30,6 +30,8 @@
 
 #include <stdint.h>
 
+#include "industry/mbcrc.h"
+
 #include "nxmb_internal.h"
 
 /****************************************************************************
@@ -53,18 +55,5 @@
 
 uint8_t nxmb_lrc(FAR const uint8_t *buf, uint16_t len)
 {
-  uint8_t  lrc = 0;
-  uint16_t i;
-
-  if (buf == NULL || len == 0)
-    {
-      return lrc;
-    }
-
-  for (i = 0; i < len; i++)
-    {
-      lrc += buf[i];
-    }
-
-  return (uint8_t)(-((int8_t)lrc));
+  return mbcrc_lrc(buf, len);
 }
@@ -54,6 +54,15 @@
 
 #define NXMB_RTU_FRAME_MAX      (NXMB_ADU_DATA_MAX + 4)
 
+/* Frame length not known yet, or only known from the T3.5 silence */
+
+#define NXMB_RTU_LEN_UNKNOWN    0
+#define NXMB_RTU_LEN_GAP        UINT16_MAX
+
+/* Character time: start + 8 data + parity/stop + stop bits */
+
+#define NXMB_RTU_CHAR_BITS      11
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -61,8 +70,14 @@
 struct nxmb_serial_state_s
 {
   int            fd;
-  uint32_t       t35_usec;
+  uint32_t       char_usec;    /* Time of one character on the wire */
+  uint32_t       t15_usec;     /* Maximum silence inside a frame */
+  uint32_t       t35_usec;     /* Minimum silence between frames */
+  uint64_t       rx_last_usec; /* Time of the last read with data */
+  uint64_t       tx_next_usec; /* Earliest time for the next frame */
   bool           rx_frame_now;
+  bool           rx_broken;
+  uint16_t       rx_expect;
   uint16_t       rx_pos;
   uint8_t        rx_buf[NXMB_RTU_FRAME_MAX];
 #ifdef CONFIG_SERIAL_TERMIOS
@@ -74,7 +89,13 @@ struct nxmb_serial_state_s
  * Private Function Prototypes
  ****************************************************************************/
 
-static uint32_t nxmb_serial_calculate_t35(uint32_t baudrate);
+static void nxmb_serial_calculate_timing(
+  FAR struct nxmb_serial_state_s *state, uint32_t baudrate);
+static uint16_t nxmb_serial_frame_len(nxmb_handle_t ctx,
+                                      FAR struct nxmb_serial_state_s *state);
+static bool nxmb_serial_frame_get(nxmb_handle_t ctx,
+                                  FAR struct nxmb_serial_state_s *state);
+static void nxmb_serial_frame_reset(FAR struct nxmb_serial_state_s *state);
 static int nxmb_serial_init(nxmb_handle_t ctx);
 static int nxmb_serial_deinit(nxmb_handle_t ctx);
 static int nxmb_serial_send(nxmb_handle_t ctx);
@@ -97,37 +118,228 @@ const struct nxmb_transport_ops_s g_nxmb_serial_ops =
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxmb_serial_calculate_t35
+ * Name: nxmb_serial_calculate_timing
  *
  * Description:
- *   Calculate T3.5 character timeout in microseconds based on baud rate.
+ *   Calculate the character time and the T1.5/T3.5 silent intervals in
+ *   microseconds based on baud rate.
  *
  * Input Parameters:
+ *   state    - Transport state
  *   baudrate - Serial baud rate
  *
- * Returned Value:
- *   T3.5 timeout in microseconds
- *
  ****************************************************************************/
 
-static uint32_t nxmb_serial_calculate_t35(uint32_t baudrate)
+static void nxmb_serial_calculate_timing(
+  FAR struct nxmb_serial_state_s *state, uint32_t baudrate)
 {
+  /* Use integer arithmetic to avoid floating-point, which may require FPU
+   * context save/restore on embedded targets.
+   */
+
+  state->char_usec = (NXMB_RTU_CHAR_BITS * 1000000u + baudrate - 1) /
+                     baudrate;
+
   if (baudrate <= 19200)
     {
-      /* T3.5 = 3.5 * 11 bits/char * 1e6 us/s / baudrate
-       * = 38500000 / baudrate (in microseconds).
-       * Use integer arithmetic to avoid floating-point, which may
-       * require FPU context save/restore on embedded targets.
+      /* T1.5 = 1.5 * 11 bits/char * 1e6 us/s / baudrate
+       * T3.5 = 3.5 * 11 bits/char * 1e6 us/s / baudrate
        */
 
-      return 38500000u / baudrate;
+      state->t15_usec = 16500000u / baudrate;
+      state->t35_usec = 38500000u / baudrate;
     }
   else
     {
-      /* Per Modbus spec, fixed 1750 us for baud rates above 19200 */
+      /* Per Modbus spec, fixed 750 us and 1750 us for baud rates above
+       * 19200
+       */
+
+      state->t15_usec = 750;
+      state->t35_usec = 1750;
+    }
+}
+
+/****************************************************************************
+ * Name: nxmb_serial_frame_len
+ *
+ * Description:
+ *   Get the length of the frame being received from its first bytes, so
+ *   that the frame can be passed on as soon as its last byte is read
+ *   instead of after the T3.5 silence. A server receives requests, a
+ *   client receives responses.
+ *
+ * Input Parameters:
+ *   ctx   - Instance context
+ *   state - Transport state
+ *
+ * Returned Value:
+ *   Frame length in bytes including the CRC, NXMB_RTU_LEN_UNKNOWN if more
+ *   bytes are needed, NXMB_RTU_LEN_GAP if the end of the frame is only
+ *   given by the T3.5 silence (diagnostics and custom function codes).
+ *
+ ****************************************************************************/
+
+static uint16_t nxmb_serial_frame_len(nxmb_handle_t ctx,
+                                      FAR struct nxmb_serial_state_s *state)
+{
+  FAR const uint8_t *buf = state->rx_buf;
+  uint16_t           pos = state->rx_pos;
+  uint16_t           len = NXMB_RTU_LEN_GAP;
+
+  if (pos < 2)
+    {
+      return NXMB_RTU_LEN_UNKNOWN;
+    }
+
+  if (ctx->is_client)
+    {
+      if (buf[1] & 0x80)
+        {
+          return 5;
+        }
+
+      switch (buf[1])
+        {
+          case NXMB_FC_READ_COILS:
+          case NXMB_FC_READ_DISCRETE:
+          case NXMB_FC_READ_HOLDING:
+          case NXMB_FC_READ_INPUT:
+          case NXMB_FC_REPORT_SERVER_ID:
+          case NXMB_FC_READWRITE_HOLDINGS:
+            if (pos < 3)
+              {
+                return NXMB_RTU_LEN_UNKNOWN;
+              }
+
+            len = 5 + buf[2];
+            break;
+
+          case NXMB_FC_WRITE_COIL:
+          case NXMB_FC_WRITE_HOLDING:
+          case NXMB_FC_WRITE_COILS:
+          case NXMB_FC_WRITE_HOLDINGS:
+            len = 8;
+            break;
+
+          default:
+            break;
+        }
+    }
+  else
+    {
+      switch (buf[1])
+        {
+          case NXMB_FC_READ_COILS:
+          case NXMB_FC_READ_DISCRETE:
+          case NXMB_FC_READ_HOLDING:
+          case NXMB_FC_READ_INPUT:
+          case NXMB_FC_WRITE_COIL:
+          case NXMB_FC_WRITE_HOLDING:
+            len = 8;
+            break;
+
+          case NXMB_FC_WRITE_COILS:
+          case NXMB_FC_WRITE_HOLDINGS:
+            if (pos < 7)
+              {
+                return NXMB_RTU_LEN_UNKNOWN;
+              }
+
+            len = 9 + buf[6];
+            break;
+
+          case NXMB_FC_READWRITE_HOLDINGS:
+            if (pos < 11)
+              {
+                return NXMB_RTU_LEN_UNKNOWN;
+              }
+
+            len = 13 + buf[10];
+            break;
+
+          case NXMB_FC_REPORT_SERVER_ID:
+            len = 4;
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  return len > NXMB_RTU_FRAME_MAX ? NXMB_RTU_LEN_GAP : len;
+}
+
+/****************************************************************************
+ * Name: nxmb_serial_frame_get
+ *
+ * Description:
+ *   Check the received frame and unpack it into ctx->adu.
+ *
+ * Input Parameters:
+ *   ctx   - Instance context
+ *   state - Transport state
+ *
+ * Returned Value:
+ *   True if the frame is valid
+ *
+ ****************************************************************************/
+
+static bool nxmb_serial_frame_get(nxmb_handle_t ctx,
+                                  FAR struct nxmb_serial_state_s *state)
+{
+  uint16_t crc_calc;
+  uint16_t crc_recv;
+  uint16_t data_len;
+
+  if (state->rx_pos < NXMB_RTU_MIN_FRAME_SIZE || state->rx_broken)
+    {
+      return false;
+    }
+
+  crc_calc = nxmb_crc16(state->rx_buf, state->rx_pos - 2);
+  crc_recv = state->rx_buf[state->rx_pos - 2] |
+             (state->rx_buf[state->rx_pos - 1] << 8);
+
+  if (crc_calc != crc_recv)
+    {
+      return false;
+    }
+
+  /* Unpack frame into ctx->adu (excluding the trailing CRC). */
+
+  data_len         = (state->rx_pos - 4);
+  ctx->adu.unit_id = state->rx_buf[0];
+  ctx->adu.fc      = state->rx_buf[1];
+  memcpy(ctx->adu.data, &state->rx_buf[2], data_len);
+  ctx->adu.crc     = crc_recv;
+  ctx->adu.length  = (state->rx_pos - 2);
+
+  return true;
+}
 
-      return 1750;
+/****************************************************************************
+ * Name: nxmb_serial_frame_reset
+ *
+ * Description:
+ *   Start waiting for a new frame. The next frame may be sent T3.5 after
+ *   the last received character at the earliest.
+ *
+ ****************************************************************************/
+
+static void nxmb_serial_frame_reset(FAR struct nxmb_serial_state_s *state)
+{
+  uint64_t tx_next = state->rx_last_usec + state->t35_usec;
+
+  if (tx_next > state->tx_next_usec)
+    {
+      state->tx_next_usec = tx_next;
     }
+
+  state->rx_pos       = 0;
+  state->rx_expect    = NXMB_RTU_LEN_UNKNOWN;
+  state->rx_broken    = false;
+  state->rx_frame_now = false;
 }
 
 /****************************************************************************
@@ -154,7 +366,7 @@ static int nxmb_serial_init(nxmb_handle_t ctx)
 
   cfg = &ctx->transport_cfg.serial;
 
-  if (cfg->devpath == NULL)
+  if (cfg->devpath == NULL || cfg->baudrate == 0)
     {
       return -EINVAL;
     }
@@ -194,8 +406,10 @@ static int nxmb_serial_init(nxmb_handle_t ctx)
   tcflush(state->fd, TCIOFLUSH);
 #endif
 
-  state->t35_usec     = nxmb_serial_calculate_t35(cfg->baudrate);
-  state->rx_frame_now = false;
+  nxmb_serial_calculate_timing(state, cfg->baudrate);
+
+  state->rx_last_usec = nxmb_util_clock_us();
+  nxmb_serial_frame_reset(state);
 
   ctx->transport_state = state;
 
@@ -239,7 +453,9 @@ static int nxmb_serial_deinit(nxmb_handle_t ctx)
  * Name: nxmb_serial_send
  *
  * Description:
- *   Send RTU frame over serial port.
+ *   Send RTU frame over serial port. The frame is held back until the
+ *   bus has been silent for T3.5, or for the turnaround delay after a
+ *   broadcast request.
  *
  * Input Parameters:
  *   ctx - Instance context
@@ -253,6 +469,8 @@ static int nxmb_serial_send(nxmb_handle_t ctx)
 {
   FAR struct nxmb_serial_state_s *state;
   uint8_t                         frame[NXMB_RTU_FRAME_MAX];
+  uint64_t                        now;
+  uint32_t                        gap;
   uint16_t                        data_len;
   uint16_t                        total;
   uint16_t                        crc;
@@ -282,7 +500,20 @@ static int nxmb_serial_send(nxmb_handle_t ctx)
 
   ctx->adu.crc = crc;
 
-  total   = ctx->adu.length + 2;
+  total = ctx->adu.length + 2;
+
+  /* Keep the frames apart. Usually the time spent on processing the
+   * request already covers the silent interval. Without
+   * CONFIG_SCHED_TICKLESS the wait is rounded up to the system tick, which
+   * only makes the gap longer than required.
+   */
+
+  now = nxmb_util_clock_us();
+  if (now < state->tx_next_usec)
+    {
+      usleep(state->tx_next_usec - now);
+    }
+
   written = write(state->fd, frame, total);
 
   if (written < 0)
@@ -295,6 +526,22 @@ static int nxmb_serial_send(nxmb_handle_t ctx)
       return -EIO;
     }
 
+  /* write() returns when the frame is queued, it is on the wire for
+   * another total characters
+   */
+
+  gap = state->t35_usec;
+
+#ifdef CONFIG_NXMODBUS_CLIENT
+  if (ctx->is_client && frame[0] == NXMB_ADDRESS_BROADCAST)
+    {
+      gap = CONFIG_NXMODBUS_RTU_TURNAROUND_MS * 1000;
+    }
+#endif
+
+  state->tx_next_usec = nxmb_util_clock_us() +
+                        (uint64_t)total * state->char_usec + gap;
+
   return 0;
 }
 
@@ -302,13 +549,16 @@ static int nxmb_serial_send(nxmb_handle_t ctx)
  * Name: nxmb_serial_receive
  *
  * Description:
- *   Receive RTU frame from serial port with dynamic timeout.
+ *   Receive RTU frame from serial port. The end of a frame is detected
+ *   from its length when the function code gives it, and from the T3.5
+ *   silence after the last read otherwise.
  *
  * Input Parameters:
  *   ctx - Instance context
  *
  * Returned Value:
- *   Zero on success; a negated errno value on failure
+ *   1 if a frame was received, zero if not; a negated errno value on
+ *   failure
  *
  ****************************************************************************/
 
@@ -318,9 +568,8 @@ static int nxmb_serial_receive(nxmb_handle_t ctx)
   struct timeval                  timeout;
   fd_set                          readfds;
   ssize_t                         nread;
-  uint16_t                        crc_calc;
-  uint16_t                        crc_recv;
-  uint16_t                        data_len;
+  uint64_t                        now;
+  uint64_t                        elapsed;
   int                             ret;
 
   DEBUGASSERT(ctx && ctx->transport_state);
@@ -332,8 +581,13 @@ static int nxmb_serial_receive(nxmb_handle_t ctx)
 
   if (state->rx_frame_now)
     {
+      /* Wait for the rest of the T3.5 silence after the last read */
+
+      elapsed = nxmb_util_clock_us() - state->rx_last_usec;
+
       timeout.tv_sec  = 0;
-      timeout.tv_usec = state->t35_usec;
+      timeout.tv_usec = elapsed < state->t35_usec ?
+                        state->t35_usec - elapsed : 0;
     }
   else
     {
@@ -352,35 +606,9 @@ static int nxmb_serial_receive(nxmb_handle_t ctx)
     {
       if (state->rx_frame_now)
         {
-          state->rx_frame_now = false;
-
-          if (state->rx_pos < NXMB_RTU_MIN_FRAME_SIZE)
-            {
-              state->rx_pos = 0;
-              return 0;
-            }
-
-          crc_calc = nxmb_crc16(state->rx_buf, state->rx_pos - 2);
-          crc_recv = state->rx_buf[state->rx_pos - 2] |
-                     (state->rx_buf[state->rx_pos - 1] << 8);
-
-          if (crc_calc != crc_recv)
-            {
-              state->rx_pos = 0;
-              return 0;
-            }
-
-          /* Unpack frame into ctx->adu (excluding the trailing CRC). */
-
-          data_len         = (state->rx_pos - 4);
-          ctx->adu.unit_id = state->rx_buf[0];
-          ctx->adu.fc      = state->rx_buf[1];
-          memcpy(ctx->adu.data, &state->rx_buf[2], data_len);
-          ctx->adu.crc     = crc_recv;
-          ctx->adu.length  = (state->rx_pos - 2);
-
-          state->rx_pos = 0;
-          return 1;
+          ret = nxmb_serial_frame_get(ctx, state);
+          nxmb_serial_frame_reset(state);
+          return ret;
         }
 
       return 0;
@@ -410,14 +638,50 @@ static int nxmb_serial_receive(nxmb_handle_t ctx)
       return 0;
     }
 
-  state->rx_pos += nread;
+  now = nxmb_util_clock_us();
+
+#ifdef CONFIG_NXMODBUS_RTU_T15_CHECK
+  /* With prompt reads the first character of this read ended nread - 1
+   * characters before this read and the previous character at the
+   * previous read.
+   */
+
+  if (state->rx_pos > 0 &&
+      now > state->rx_last_usec + (uint64_t)nread * state->char_usec +
+            state->t15_usec)
+    {
+      state->rx_broken = true;
+    }
+#endif
+
+  state->rx_last_usec = now;
+  state->rx_pos      += nread;
 
   if (state->rx_pos >= sizeof(state->rx_buf))
     {
-      state->rx_pos       = 0;
-      state->rx_frame_now = false;
+      nxmb_serial_frame_reset(state);
       return 0;
     }
 
+  if (state->rx_expect == NXMB_RTU_LEN_UNKNOWN)
+    {
+      state->rx_expect = nxmb_serial_frame_len(ctx, state);
+    }
+
+  if (state->rx_pos == state->rx_expect)
+    {
+      if (nxmb_serial_frame_get(ctx, state))
+        {
+          nxmb_serial_frame_reset(state);
+          return 1;
+        }
+
+      /* Not a frame of the expected kind, e.g. another server's response
+       * seen by a server. Drop it at the T3.5 silence.
+       */
+
+      state->rx_expect = NXMB_RTU_LEN_GAP;
+    }
+
   return 0;
 }
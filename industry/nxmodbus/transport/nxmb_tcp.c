@@ -29,6 +29,7 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <netinet/in.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -51,6 +52,15 @@
 #define MBAP_FC_SIZE     8
 #define NXMB_TCP_RECV_MS 1000
 
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+/* Receive buffer holds up to CONFIG_NXMODBUS_TCP_PIPELINE whole frames */
+
+#  define NXMB_TCP_FRAME_MAX  (MBAP_FC_SIZE + NXMB_ADU_DATA_MAX)
+#  define NXMB_TCP_RXBUF_SIZE \
+     (CONFIG_NXMODBUS_TCP_PIPELINE * NXMB_TCP_FRAME_MAX)
+#  define NXMB_TCP_POLL_US    50000
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -60,6 +70,21 @@ struct nxmb_tcp_client_s
   int      fd;
   uint16_t trans_id;
   time_t   last_activity;
+
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  /* Requests are parsed from rxbuf as they complete. Several requests of
+   * one connection may be served at once as long as they are read-only.
+   * Any other request waits for the previous ones and blocks the next
+   * ones, so writes keep their order.
+   */
+
+  pthread_mutex_t txlock;      /* Serializes responses */
+  uint16_t        rxlen;       /* Bytes in rxbuf */
+  uint8_t         inflight;    /* Requests taken, not yet returned */
+  bool            inflight_wr; /* A request in flight is not read-only */
+  bool            closing;     /* Close when inflight drops to zero */
+  uint8_t         rxbuf[NXMB_TCP_RXBUF_SIZE];
+#endif
 };
 
 struct nxmb_tcp_state_s
@@ -67,6 +92,13 @@ struct nxmb_tcp_state_s
   struct nxmb_tcp_client_s clients[CONFIG_NXMODBUS_TCP_MAX_CLIENTS];
   int                      listen_fd;
   int                      active_idx;
+
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  pthread_mutex_t          lock;    /* Protects the state */
+  pthread_cond_t           cond;    /* Poll done or request returned */
+  bool                     polling; /* A thread waits in select() */
+  uint8_t                  next;    /* Round-robin start index */
+#endif
 };
 
 /****************************************************************************
@@ -77,6 +109,11 @@ static int nxmb_tcp_init(nxmb_handle_t ctx);
 static int nxmb_tcp_deinit(nxmb_handle_t ctx);
 static int nxmb_tcp_send(nxmb_handle_t ctx);
 static int nxmb_tcp_receive(nxmb_handle_t ctx);
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+static int nxmb_tcp_txn_get(nxmb_handle_t ctx, FAR struct nxmb_txn_s *txn);
+static int nxmb_tcp_txn_put(nxmb_handle_t ctx, FAR struct nxmb_txn_s *txn,
+                            bool reply);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -88,6 +125,10 @@ const struct nxmb_transport_ops_s g_nxmb_tcp_ops =
   .deinit  = nxmb_tcp_deinit,
   .send    = nxmb_tcp_send,
   .receive = nxmb_tcp_receive,
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  .txn_get = nxmb_tcp_txn_get,
+  .txn_put = nxmb_tcp_txn_put,
+#endif
 };
 
 /****************************************************************************
@@ -122,6 +163,78 @@ static void nxmb_tcp_get_header(FAR struct nxmb_adu_s *adu,
   adu->fc       = hdr[7];
 }
 
+/****************************************************************************
+ * Name: nxmb_tcp_write_adu
+ *
+ * Description:
+ *   Write an ADU with its MBAP header to a connection.
+ *
+ ****************************************************************************/
+
+static int nxmb_tcp_write_adu(int fd, FAR const struct nxmb_adu_s *adu)
+{
+  uint8_t      header[MBAP_FC_SIZE];
+  struct iovec iov[2];
+  uint16_t     data_len;
+  uint16_t     total;
+  ssize_t      sent;
+
+  if (adu->length < 2)
+    {
+      return -EINVAL;
+    }
+
+  data_len = adu->length - 2;
+
+  /* Emit MBAP header + PDU data via writev() to avoid a stack-side
+   * copy. The kernel gathers both iovecs into a single TCP segment.
+   */
+
+  nxmb_tcp_put_header(adu, header);
+
+  iov[0].iov_base = header;
+  iov[0].iov_len  = MBAP_FC_SIZE;
+  iov[1].iov_base = (FAR void *)adu->data;
+  iov[1].iov_len  = data_len;
+
+  total = MBAP_FC_SIZE + data_len;
+  sent  = writev(fd, iov, (data_len > 0) ? 2 : 1);
+  if (sent != total)
+    {
+      return (sent < 0) ? -errno : -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmb_tcp_close_client
+ *
+ * Description:
+ *   Close a client connection. With the concurrent server, a connection
+ *   that still has requests in flight is only marked and closed when the
+ *   last one is returned, so the slot is not reused under them.
+ *
+ ****************************************************************************/
+
+static void nxmb_tcp_close_client(FAR struct nxmb_tcp_client_s *client)
+{
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  client->rxlen = 0;
+
+  if (client->inflight > 0)
+    {
+      client->closing = true;
+      return;
+    }
+
+  client->closing = false;
+#endif
+
+  close(client->fd);
+  client->fd = -1;
+}
+
 /****************************************************************************
  * Name: nxmb_tcp_create_server
  ****************************************************************************/
@@ -275,6 +388,27 @@ static int nxmb_tcp_recv_full(int fd, FAR uint8_t *buf, size_t len,
   return received;
 }
 
+/****************************************************************************
+ * Name: nxmb_tcp_free_state
+ ****************************************************************************/
+
+static void nxmb_tcp_free_state(FAR struct nxmb_tcp_state_s *state)
+{
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  int i;
+
+  for (i = 0; i < CONFIG_NXMODBUS_TCP_MAX_CLIENTS; i++)
+    {
+      pthread_mutex_destroy(&state->clients[i].txlock);
+    }
+
+  pthread_mutex_destroy(&state->lock);
+  pthread_cond_destroy(&state->cond);
+#endif
+
+  free(state);
+}
+
 /****************************************************************************
  * Name: nxmb_tcp_init
  ****************************************************************************/
@@ -302,14 +436,22 @@ static int nxmb_tcp_init(nxmb_handle_t ctx)
   for (i = 0; i < CONFIG_NXMODBUS_TCP_MAX_CLIENTS; i++)
     {
       state->clients[i].fd = -1;
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+      pthread_mutex_init(&state->clients[i].txlock, NULL);
+#endif
     }
 
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+  pthread_mutex_init(&state->lock, NULL);
+  pthread_cond_init(&state->cond, NULL);
+#endif
+
   if (ctx->is_client)
     {
       fd = nxmb_tcp_connect_client(cfg);
       if (fd < 0)
         {
-          free(state);
+          nxmb_tcp_free_state(state);
           return fd;
         }
 
@@ -321,7 +463,7 @@ static int nxmb_tcp_init(nxmb_handle_t ctx)
       fd = nxmb_tcp_create_server(cfg);
       if (fd < 0)
         {
-          free(state);
+          nxmb_tcp_free_state(state);
           return fd;
         }
 
@@ -359,7 +501,7 @@ static int nxmb_tcp_deinit(nxmb_handle_t ctx)
       close(state->listen_fd);
     }
 
-  free(state);
+  nxmb_tcp_free_state(state);
   ctx->transport_state = NULL;
 
   return OK;
@@ -373,12 +515,8 @@ static int nxmb_tcp_send(nxmb_handle_t ctx)
 {
   FAR struct nxmb_tcp_state_s  *state;
   FAR struct nxmb_tcp_client_s *client;
-  uint8_t                       header[MBAP_FC_SIZE];
-  struct iovec                  iov[2];
-  uint16_t                      data_len;
-  uint16_t                      total;
-  ssize_t                       sent;
   int                           fd;
+  int                           ret;
 
   DEBUGASSERT(ctx && ctx->transport_state);
 
@@ -408,34 +546,22 @@ static int nxmb_tcp_send(nxmb_handle_t ctx)
       return -ENOTCONN;
     }
 
-  if (ctx->adu.length < 2)
+  /* Populate the MBAP fields before serializing the header. A server
+   * echoes the transaction identifier of the request, a client sends the
+   * one set by the client core.
+   */
+
+  if (!ctx->is_client)
     {
-      return -EINVAL;
+      ctx->adu.trans_id = client->trans_id;
     }
 
-  /* Populate the MBAP fields before serializing the header */
-
-  ctx->adu.trans_id = client->trans_id;
   ctx->adu.proto_id = 0x0000;
 
-  data_len = ctx->adu.length - 2;
-
-  /* Emit MBAP header + PDU data via writev() to avoid a stack-side
-   * copy. The kernel gathers both iovecs into a single TCP segment.
-   */
-
-  nxmb_tcp_put_header(&ctx->adu, header);
-
-  iov[0].iov_base = header;
-  iov[0].iov_len  = MBAP_FC_SIZE;
-  iov[1].iov_base = ctx->adu.data;
-  iov[1].iov_len  = data_len;
-
-  total = MBAP_FC_SIZE + data_len;
-  sent  = writev(fd, iov, (data_len > 0) ? 2 : 1);
-  if (sent != total)
+  ret = nxmb_tcp_write_adu(fd, &ctx->adu);
+  if (ret < 0)
     {
-      return (sent < 0) ? -errno : -EIO;
+      return ret;
     }
 
   client->last_activity = time(NULL);
@@ -462,8 +588,7 @@ static void nxmb_tcp_evict_idle(FAR struct nxmb_tcp_state_s *state,
           (now - state->clients[i].last_activity) >
           CONFIG_NXMODBUS_TCP_TIMEOUT_SEC)
         {
-          close(state->clients[i].fd);
-          state->clients[i].fd = -1;
+          nxmb_tcp_close_client(&state->clients[i]);
         }
     }
 }
@@ -493,6 +618,12 @@ static void nxmb_tcp_accept_new(FAR struct nxmb_tcp_state_s *state)
         {
           state->clients[i].fd            = fd;
           state->clients[i].last_activity = time(NULL);
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+          state->clients[i].rxlen         = 0;
+          state->clients[i].inflight      = 0;
+          state->clients[i].inflight_wr   = false;
+          state->clients[i].closing       = false;
+#endif
           return;
         }
     }
@@ -682,3 +813,328 @@ static int nxmb_tcp_receive(nxmb_handle_t ctx)
 
   return -EAGAIN;
 }
+
+#ifdef CONFIG_NXMODBUS_TCP_CONCURRENT
+/****************************************************************************
+ * Name: nxmb_tcp_frame_len
+ *
+ * Description:
+ *   Get the length of the first frame in the client receive buffer.
+ *
+ * Returned Value:
+ *   Frame length if a whole frame is buffered, 0 if more data is needed,
+ *   a negated errno value if the MBAP header is invalid.
+ *
+ ****************************************************************************/
+
+static int nxmb_tcp_frame_len(FAR struct nxmb_tcp_client_s *client)
+{
+  uint16_t length;
+
+  if (client->rxlen < MBAP_FC_SIZE)
+    {
+      return 0;
+    }
+
+  if (nxmb_util_get_u16_be(&client->rxbuf[2]) != 0x0000)
+    {
+      return -EPROTO;
+    }
+
+  length = nxmb_util_get_u16_be(&client->rxbuf[4]);
+  if (length < 2 || length - 2 > NXMB_ADU_DATA_MAX)
+    {
+      return -EMSGSIZE;
+    }
+
+  /* MBAP length counts the bytes after the length field */
+
+  if (client->rxlen < MBAP_HEADER_SIZE - 1 + length)
+    {
+      return 0;
+    }
+
+  return MBAP_HEADER_SIZE - 1 + length;
+}
+
+/****************************************************************************
+ * Name: nxmb_tcp_txn_pop
+ *
+ * Description:
+ *   Take the next request that can be served now from the client receive
+ *   buffers. Clients are visited round-robin so that a client with many
+ *   pipelined requests does not starve the others. Must be called with
+ *   state->lock held.
+ *
+ * Returned Value:
+ *   1 if a request was taken, 0 if none is ready.
+ *
+ ****************************************************************************/
+
+static int nxmb_tcp_txn_pop(FAR struct nxmb_tcp_state_s *state,
+                            FAR struct nxmb_txn_s *txn)
+{
+  FAR struct nxmb_tcp_client_s *client;
+  bool                          rdonly;
+  int                           len;
+  int                           i;
+  int                           j;
+
+  for (j = 0; j < CONFIG_NXMODBUS_TCP_MAX_CLIENTS; j++)
+    {
+      i      = (state->next + j) % CONFIG_NXMODBUS_TCP_MAX_CLIENTS;
+      client = &state->clients[i];
+
+      if (client->fd < 0 || client->closing || client->inflight_wr ||
+          client->inflight >= CONFIG_NXMODBUS_TCP_PIPELINE)
+        {
+          continue;
+        }
+
+      len = nxmb_tcp_frame_len(client);
+      if (len < 0)
+        {
+          nxmb_tcp_close_client(client);
+          continue;
+        }
+      else if (len == 0)
+        {
+          continue;
+        }
+
+      /* A request that is not read-only waits for the previous ones */
+
+      rdonly = nxmb_fc_is_read_only(client->rxbuf[MBAP_HEADER_SIZE]);
+      if (!rdonly && client->inflight > 0)
+        {
+          continue;
+        }
+
+      nxmb_tcp_get_header(&txn->adu, client->rxbuf);
+      memcpy(txn->adu.data, &client->rxbuf[MBAP_FC_SIZE],
+             len - MBAP_FC_SIZE);
+
+      client->rxlen -= len;
+      memmove(client->rxbuf, &client->rxbuf[len], client->rxlen);
+
+      client->inflight     += 1;
+      client->inflight_wr   = !rdonly;
+      client->last_activity = time(NULL);
+
+      txn->conn   = i;
+      txn->rdonly = rdonly;
+
+      state->next = (i + 1) % CONFIG_NXMODBUS_TCP_MAX_CLIENTS;
+      return 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nxmb_tcp_poll_clients
+ *
+ * Description:
+ *   Wait for data on the listen socket and all client connections at once
+ *   and append whatever arrived to the client receive buffers. Must be
+ *   called with state->lock held, the lock is released while waiting.
+ *
+ ****************************************************************************/
+
+static void nxmb_tcp_poll_clients(FAR struct nxmb_tcp_state_s *state)
+{
+  FAR struct nxmb_tcp_client_s *client;
+  struct timeval                tv;
+  fd_set                        readfds;
+  int                           maxfd;
+  int                           ret;
+  int                           i;
+
+  state->polling = true;
+
+  nxmb_tcp_evict_idle(state, time(NULL));
+
+  FD_ZERO(&readfds);
+  maxfd = -1;
+
+  if (state->listen_fd >= 0)
+    {
+      FD_SET(state->listen_fd, &readfds);
+      maxfd = state->listen_fd;
+    }
+
+  /* Connections with a full buffer are not read until requests are taken,
+   * which pushes back on the client through TCP flow control.
+   */
+
+  for (i = 0; i < CONFIG_NXMODBUS_TCP_MAX_CLIENTS; i++)
+    {
+      client = &state->clients[i];
+
+      if (client->fd >= 0 && !client->closing &&
+          client->rxlen < NXMB_TCP_RXBUF_SIZE)
+        {
+          FD_SET(client->fd, &readfds);
+          if (client->fd > maxfd)
+            {
+              maxfd = client->fd;
+            }
+        }
+    }
+
+  pthread_mutex_unlock(&state->lock);
+
+  tv.tv_sec  = 0;
+  tv.tv_usec = NXMB_TCP_POLL_US;
+
+  ret = select(maxfd + 1, &readfds, NULL, NULL, &tv);
+
+  pthread_mutex_lock(&state->lock);
+
+  if (ret > 0)
+    {
+      if (state->listen_fd >= 0 && FD_ISSET(state->listen_fd, &readfds))
+        {
+          nxmb_tcp_accept_new(state);
+        }
+
+      /* Only the polling thread reads and closes, so every fd in the set
+       * is still the same connection.
+       */
+
+      for (i = 0; i < CONFIG_NXMODBUS_TCP_MAX_CLIENTS; i++)
+        {
+          client = &state->clients[i];
+
+          if (client->fd < 0 || client->closing ||
+              !FD_ISSET(client->fd, &readfds))
+            {
+              continue;
+            }
+
+          ret = recv(client->fd, &client->rxbuf[client->rxlen],
+                     NXMB_TCP_RXBUF_SIZE - client->rxlen, 0);
+          if (ret > 0)
+            {
+              client->rxlen        += ret;
+              client->last_activity = time(NULL);
+            }
+          else if (ret == 0 || (errno != EAGAIN && errno != EWOULDBLOCK &&
+                                errno != EINTR))
+            {
+              nxmb_tcp_close_client(client);
+            }
+        }
+    }
+
+  state->polling = false;
+  pthread_cond_broadcast(&state->cond);
+}
+
+/****************************************************************************
+ * Name: nxmb_tcp_txn_get
+ *
+ * Description:
+ *   Take one request for the concurrent server. A request that is already
+ *   buffered is returned at once. Otherwise one thread polls all the
+ *   connections while the others wait for it to finish.
+ *
+ ****************************************************************************/
+
+static int nxmb_tcp_txn_get(nxmb_handle_t ctx, FAR struct nxmb_txn_s *txn)
+{
+  FAR struct nxmb_tcp_state_s *state;
+  int                          ret;
+
+  DEBUGASSERT(ctx && ctx->transport_state && txn);
+
+  state = ctx->transport_state;
+
+  pthread_mutex_lock(&state->lock);
+
+  ret = nxmb_tcp_txn_pop(state, txn);
+  if (ret == 0)
+    {
+      if (state->polling)
+        {
+          pthread_cond_wait(&state->cond, &state->lock);
+        }
+      else
+        {
+          nxmb_tcp_poll_clients(state);
+        }
+
+      ret = nxmb_tcp_txn_pop(state, txn);
+    }
+
+  pthread_mutex_unlock(&state->lock);
+
+  return ret > 0 ? ret : -EAGAIN;
+}
+
+/****************************************************************************
+ * Name: nxmb_tcp_txn_put
+ *
+ * Description:
+ *   Return a request taken with nxmb_tcp_txn_get() and send the response
+ *   if reply is true. Responses to one connection are serialized, requests
+ *   of other connections are not blocked while sending.
+ *
+ ****************************************************************************/
+
+static int nxmb_tcp_txn_put(nxmb_handle_t ctx, FAR struct nxmb_txn_s *txn,
+                            bool reply)
+{
+  FAR struct nxmb_tcp_state_s  *state;
+  FAR struct nxmb_tcp_client_s *client;
+  int                           ret = OK;
+
+  DEBUGASSERT(ctx && ctx->transport_state && txn);
+
+  state  = ctx->transport_state;
+  client = &state->clients[txn->conn];
+
+  /* The connection is not closed while the request is in flight, so fd
+   * can be used without state->lock.
+   */
+
+  DEBUGASSERT(client->fd >= 0 && client->inflight > 0);
+
+  if (reply && !client->closing)
+    {
+      txn->adu.proto_id = 0x0000;
+
+      pthread_mutex_lock(&client->txlock);
+      ret = nxmb_tcp_write_adu(client->fd, &txn->adu);
+      pthread_mutex_unlock(&client->txlock);
+    }
+
+  pthread_mutex_lock(&state->lock);
+
+  client->inflight -= 1;
+  if (!txn->rdonly)
+    {
+      client->inflight_wr = false;
+    }
+
+  if (ret < 0 && !client->closing)
+    {
+      nxmb_tcp_close_client(client);
+    }
+  else if (client->closing && client->inflight == 0)
+    {
+      nxmb_tcp_close_client(client);
+    }
+  else
+    {
+      client->last_activity = time(NULL);
+    }
+
+  /* Requests waiting for this one may be served now */
+
+  pthread_cond_broadcast(&state->cond);
+  pthread_mutex_unlock(&state->lock);
+
+  return ret;
+}
+#endif /* CONFIG_NXMODBUS_TCP_CONCURRENT */
@@ -442,63 +442,30 @@ static int nxscope_start_set(FAR struct nxscope_s *s, bool start)
 static int nxscope_start_req(FAR struct nxscope_s *s,
                              FAR struct nxscope_start_data_s *data)
 {
-  int ret = -EINVAL;
+  uint8_t enc = 0;
+  int     ret = -EINVAL;
 
   DEBUGASSERT(s);
   DEBUGASSERT(data);
 
-  if (data->start == 0 || data->start == 1)
+#ifdef CONFIG_LOGGING_NXSCOPE_ENCODE
+  enc = NXSCOPE_START_DELTA | NXSCOPE_START_LZ;
+#endif
+
+  /* Only supported encodings can be requested */
+
+  if ((data->start & ~(NXSCOPE_START_STREAM | enc)) == 0)
     {
       _info("data->start=%d\n", data->start);
-      ret = nxscope_start_set(s, data->start);
+#ifdef CONFIG_LOGGING_NXSCOPE_ENCODE
+      s->encode = data->start & enc;
+#endif
+      ret = nxscope_start_set(s, data->start & NXSCOPE_START_STREAM);
     }
 
   return ret;
 }
 
-/****************************************************************************
- * Name: nxscope_stream_reset
- *
- * NOTE: This function assumes that we have exclusive access to the nxscope
- *       instance
- *
- ****************************************************************************/
-
-static void nxscope_stream_reset(FAR struct nxscope_s *s)
-{
-  DEBUGASSERT(s);
-
-  /* Offset for hdr + 1 byte for flags */
-
-  s->stream_i = s->proto_stream->hdrlen + 1;
-
-  /* Reset flags */
-
-  s->streambuf[s->proto_stream->hdrlen] = 0;
-}
-
-/****************************************************************************
- * Name: nxscope_stream_empty
- *
- * NOTE: This function assumes that we have exclusive access to the nxscope
- *       instance
- *
- ****************************************************************************/
-
-static bool nxscope_stream_empty(FAR struct nxscope_s *s)
-{
-  DEBUGASSERT(s);
-
-  if (s->stream_i > s->proto_stream->hdrlen + 1)
-    {
-      return false;
-    }
-  else
-    {
-      return true;
-    }
-}
-
 #ifdef CONFIG_LOGGING_NXSCOPE_ACKFRAMES
 /****************************************************************************
  * Name: nxscope_ack
@@ -806,6 +773,34 @@ int nxscope_init(FAR struct nxscope_s *s, FAR struct nxscope_cfg_s *cfg)
     }
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+  /* Allocate memory for decimation data */
+
+  s->dec = zalloc(cfg->channels * sizeof(struct nxscope_dec_s));
+  if (s->dec == NULL)
+    {
+      ret = -errno;
+      _err("ERROR: dec zalloc failed %d\n", ret);
+      goto errout;
+    }
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+  /* Allocate memory for trigger buffer */
+
+  if (cfg->trigbuf_len > 0)
+    {
+      s->trig.len = cfg->trigbuf_len;
+      s->trig.buf = zalloc(s->trig.len);
+      if (s->trig.buf == NULL)
+        {
+          ret = -errno;
+          _err("ERROR: trigbuf zalloc failed %d\n", ret);
+          goto errout;
+        }
+    }
+#endif
+
   /* Allocate memory for RX buffer */
 
   DEBUGASSERT(cfg->rxbuf_len > 0);
@@ -870,6 +865,20 @@ int nxscope_init(FAR struct nxscope_s *s, FAR struct nxscope_cfg_s *cfg)
 #ifdef CONFIG_LOGGING_NXSCOPE_ACKFRAMES
   s->cmninfo.flags |= NXSCOPE_FLAGS_ACK_SUPPORT;
 #endif
+#ifdef CONFIG_LOGGING_NXSCOPE_BLOCK
+  s->cmninfo.flags |= NXSCOPE_FLAGS_BLOCK_SUPPORT;
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_ENCODE
+  /* Initialize stream encoding */
+
+  ret = nxscope_encode_init(s);
+  if (ret < 0)
+    {
+      _err("ERROR: nxscope_encode_init failed %d\n", ret);
+      goto errout;
+    }
+#endif
 
   s->cmninfo.rx_padding = cfg->rx_padding;
 
@@ -901,6 +910,18 @@ errout:
     }
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+  nxscope_dec_deinit(s);
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+  if (s->trig.buf != NULL)
+    {
+      free(s->trig.buf);
+      s->trig.buf = NULL;
+    }
+#endif
+
   if (s->rxbuf != NULL)
     {
       free(s->rxbuf);
@@ -911,6 +932,10 @@ errout:
       free(s->txbuf);
     }
 
+#ifdef CONFIG_LOGGING_NXSCOPE_ENCODE
+  nxscope_encode_deinit(s);
+#endif
+
 #ifdef CONFIG_LOGGING_NXSCOPE_CRICHANNELS
   if (s->cribuf != NULL)
     {
@@ -959,6 +984,18 @@ void nxscope_deinit(FAR struct nxscope_s *s)
     }
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+  nxscope_dec_deinit(s);
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+  if (s->trig.buf != NULL)
+    {
+      free(s->trig.buf);
+      s->trig.buf = NULL;
+    }
+#endif
+
 #ifdef CONFIG_LOGGING_NXSCOPE_CRICHANNELS
   if (s->cribuf != NULL)
     {
@@ -970,6 +1007,10 @@ void nxscope_deinit(FAR struct nxscope_s *s)
     {
       free(s->txbuf);
     }
+
+#ifdef CONFIG_LOGGING_NXSCOPE_ENCODE
+  nxscope_encode_deinit(s);
+#endif
 }
 
 /****************************************************************************
@@ -1037,6 +1078,18 @@ int nxscope_stream(FAR struct nxscope_s *s)
       goto errout;
     }
 
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+  /* Send out the captured samples */
+
+  nxscope_trig_merge(s);
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_STAGE
+  /* Collect samples from the producers staging buffers */
+
+  nxscope_stage_merge(s);
+#endif
+
   /* Do nothing if no data */
 
   if (nxscope_stream_empty(s))
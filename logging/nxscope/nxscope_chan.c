@@ -87,21 +87,6 @@ int g_type_size[] =
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: nxscope_stream_overflow
- *
- * NOTE: This function assumes that we have exclusive access to the nxscope
- *       instance
- *
- ****************************************************************************/
-
-static void nxscope_stream_overflow(FAR struct nxscope_s *s)
-{
-  DEBUGASSERT(s);
-
-  s->streambuf[s->proto_stream->hdrlen] |= NXSCOPE_STREAM_FLAGS_OVERFLOW;
-}
-
 /****************************************************************************
  * Name: nxscope_ch_validate
  ****************************************************************************/
@@ -174,13 +159,20 @@ static int nxscope_ch_validate(FAR struct nxscope_s *s, uint8_t ch,
 #endif
 
 #ifdef CONFIG_LOGGING_NXSCOPE_DIVIDER
-  /* Handle sample rate divider */
+  /* Handle sample rate divider.
+   * Decimated channels get all samples, see nxscope_dec_put().
+   */
 
-  s->cntr[ch] += 1;
-  if (s->cntr[ch] % (s->chinfo[ch].div + 1) != 0)
+#  ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+  if (s->dec[ch].mode == NXSCOPE_DEC_SKIP)
+#  endif
     {
-      ret = -EAGAIN;
-      goto errout;
+      s->cntr[ch] += 1;
+      if (s->cntr[ch] % (s->chinfo[ch].div + 1) != 0)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
     }
 #endif
 
@@ -188,6 +180,16 @@ static int nxscope_ch_validate(FAR struct nxscope_s *s, uint8_t ch,
 
   utype.u8 = type;
 
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+  /* Samples go to the trigger buffer, not to the stream buffer */
+
+  if (s->trig.cfg.mode != NXSCOPE_TRIG_OFF && !utype.s.cri)
+    {
+      ret = OK;
+      goto errout;
+    }
+#endif
+
   /* Check buffer size */
 
 #ifdef CONFIG_LOGGING_NXSCOPE_USERTYPES
@@ -234,7 +236,7 @@ static int nxscope_ch_validate(FAR struct nxscope_s *s, uint8_t ch,
   if (next_i > s->streambuf_len)
     {
       _err("ERROR: no space for data %zu\n", s->stream_i);
-      nxscope_stream_overflow(s);
+      nxscope_stream_overflow(s, 1);
       ret = -ENOBUFS;
       goto errout;
     }
@@ -410,36 +412,64 @@ static int nxscope_put_meta(FAR uint8_t *buff, FAR uint8_t *meta,
   return mlen;
 }
 
+#if defined(CONFIG_LOGGING_NXSCOPE_DECIMATE) || \
+    defined(CONFIG_LOGGING_NXSCOPE_TRIGGER)
 /****************************************************************************
- * Name: nxscope_put_sample
+ * Name: nxscope_put_capture
+ *
+ * Description:
+ *   Put a validated sample through the decimation and the trigger
  *
  * NOTE: This function assumes that we have exclusive access to the nxscope
- *       stream buffer
+ *       instance
  *
  ****************************************************************************/
 
-static void nxscope_put_sample(FAR uint8_t *buff, FAR size_t *buff_i,
-                               uint8_t type, uint8_t ch, FAR void *val,
-                               uint8_t d, FAR uint8_t *meta, uint8_t mlen)
+static int nxscope_put_capture(FAR struct nxscope_s *s, uint8_t type,
+                               uint8_t ch, FAR void *val, uint8_t d,
+                               FAR uint8_t *meta, uint8_t mlen)
 {
-  size_t i = 0;
+  FAR void *vec[2];
+  int       nvec = 1;
+  int       ret  = OK;
+  int       i    = 0;
 
-  /* Channel ID */
+  vec[0] = val;
 
-  buff[(*buff_i)++] = ch;
+#ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+  nvec = nxscope_dec_put(s, type, ch, val, d, vec);
+  if (nvec < 0)
+    {
+      return nvec;
+    }
+#endif
 
-  /* Vector sample data - always little-endian */
+  for (i = 0; i < nvec; i++)
+    {
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+      if (s->trig.cfg.mode != NXSCOPE_TRIG_OFF)
+        {
+          ret = nxscope_trig_put(s, type, ch, vec[i], d, meta, mlen);
+          continue;
+        }
+#endif
 
-  i = nxscope_put_vector(&buff[*buff_i], type, val, d);
-  *buff_i += i;
+      /* Space for the first sample checked in nxscope_ch_validate() */
 
-  /* Meta data.
-   * REVISIT: what about endianness ?
-   */
+      if (i > 0 && (s->stream_i + nxscope_sample_size(s, ch) +
+                    s->proto_stream->footlen > s->streambuf_len))
+        {
+          nxscope_stream_overflow(s, 1);
+          return -ENOBUFS;
+        }
 
-  i = nxscope_put_meta(&buff[*buff_i], meta, mlen);
-  *buff_i += i;
+      nxscope_put_sample(s->streambuf, &s->stream_i, type, ch, vec[i], d,
+                         meta, mlen);
+    }
+
+  return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: nxscope_put_common_m
@@ -489,6 +519,12 @@ static int nxscope_put_common_m(FAR struct nxscope_s *s, uint8_t type,
 
       buff   = s->streambuf;
       buff_i = &s->stream_i;
+
+#if defined(CONFIG_LOGGING_NXSCOPE_DECIMATE) || \
+    defined(CONFIG_LOGGING_NXSCOPE_TRIGGER)
+      ret = nxscope_put_capture(s, type, ch, val, d, meta, mlen);
+      goto errout;
+#endif
     }
 
   /* Put sample on buffer */
@@ -517,10 +553,392 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_LOGGING_NXSCOPE_BLOCK
+/****************************************************************************
+ * Name: nxscope_block_validate
+ ****************************************************************************/
+
+static int nxscope_block_validate(FAR struct nxscope_s *s, uint8_t ch,
+                                  uint8_t d, uint8_t mlen)
+{
+  DEBUGASSERT(s);
+
+  /* Do nothing if stream not started or channel not enabled */
+
+  if (!s->start || s->chinfo[ch].enable != 1)
+    {
+      return -EAGAIN;
+    }
+
+#ifdef CONFIG_DEBUG_FEATURES
+  /* Validate channel */
+
+  if (ch > s->cmninfo.chmax)
+    {
+      _err("ERROR: invalid channel %d\n", ch);
+      return -EINVAL;
+    }
+
+  /* Validate channel vdim */
+
+  if (s->chinfo[ch].vdim != d)
+    {
+      _err("ERROR: invalid channel dim %d\n", d);
+      return -EINVAL;
+    }
+
+  /* Validate channel metadata size */
+
+  if (s->chinfo[ch].mlen != mlen)
+    {
+      _err("ERROR: invalid channel mlen %d\n", mlen);
+      return -EINVAL;
+    }
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_CRICHANNELS
+  /* Critical channels are sent without buffering */
+
+  if (s->chinfo[ch].type.s.cri)
+    {
+      return -EINVAL;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxscope_block_put
+ *
+ * Description:
+ *   Put samples on the stream buffer in block entries. A new entry is
+ *   started when the count of the current one reaches its maximum.
+ *
+ * NOTE: This function assumes that we have exclusive access to the nxscope
+ *       instance
+ *
+ ****************************************************************************/
+
+static int nxscope_block_put(FAR struct nxscope_s *s, uint8_t ch,
+                             FAR uint8_t *val, uint8_t d,
+                             FAR uint8_t *meta, uint8_t mlen, size_t n)
+{
+  FAR uint8_t *buff   = s->streambuf;
+  size_t       footer = s->proto_stream->footlen;
+  size_t       blk_i  = 0;
+  size_t       vsize  = 0;
+  size_t       ssize  = 0;
+  size_t       next   = 0;
+  size_t       cnt    = 0;
+  size_t       i      = 0;
+  uint8_t      type   = 0;
+  int          ret    = OK;
+
+  /* Sample without channel id */
+
+  ssize = nxscope_sample_size(s, ch) - 1;
+  vsize = ssize - mlen;
+
+  type = s->chinfo[ch].type.s.dtype;
+#ifdef CONFIG_LOGGING_NXSCOPE_USERTYPES
+  if (type >= NXSCOPE_TYPE_USER)
+    {
+      type = NXSCOPE_TYPE_USER;
+    }
+#endif
+
+  for (i = 0; i < n; i++)
+    {
+#ifdef CONFIG_LOGGING_NXSCOPE_DIVIDER
+      /* Handle sample rate divider */
+
+      s->cntr[ch] += 1;
+      if (s->cntr[ch] % (s->chinfo[ch].div + 1) != 0)
+        {
+          continue;
+        }
+#endif
+
+      /* Space for the sample and a new entry header if needed */
+
+      next = s->stream_i + ssize + footer;
+      if (cnt == 0 || cnt == UINT16_MAX)
+        {
+          next += 4;
+        }
+
+      if (next > s->streambuf_len)
+        {
+          nxscope_stream_overflow(s, n - i);
+          ret = -ENOBUFS;
+          break;
+        }
+
+      if (cnt == 0 || cnt == UINT16_MAX)
+        {
+          /* Start a new block entry */
+
+          blk_i            = s->stream_i;
+          buff[blk_i]      = NXSCOPE_BLOCK_ID;
+          buff[blk_i + 1]  = ch;
+          s->stream_i     += 4;
+          cnt              = 0;
+        }
+
+      s->stream_i += nxscope_put_vector(&buff[s->stream_i], type,
+                                        &val[i * vsize], d);
+      s->stream_i += nxscope_put_meta(&buff[s->stream_i],
+                                      meta ? &meta[i * mlen] : NULL, mlen);
+
+      /* Entry count - always little-endian */
+
+      cnt++;
+      buff[blk_i + 2] = cnt & 0xff;
+      buff[blk_i + 3] = (cnt >> 8) & 0xff;
+
+      buff[s->proto_stream->hdrlen] |= NXSCOPE_STREAM_FLAGS_BLOCK;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxscope_put_sample
+ *
+ * NOTE: This function assumes that we have exclusive access to the nxscope
+ *       stream buffer
+ *
+ ****************************************************************************/
+
+void nxscope_put_sample(FAR uint8_t *buff, FAR size_t *buff_i,
+                        uint8_t type, uint8_t ch, FAR void *val,
+                        uint8_t d, FAR uint8_t *meta, uint8_t mlen)
+{
+  size_t i = 0;
+
+  /* Channel ID */
+
+  buff[(*buff_i)++] = ch;
+
+  /* Vector sample data - always little-endian */
+
+  i = nxscope_put_vector(&buff[*buff_i], type, val, d);
+  *buff_i += i;
+
+  /* Meta data.
+   * REVISIT: what about endianness ?
+   */
+
+  i = nxscope_put_meta(&buff[*buff_i], meta, mlen);
+  *buff_i += i;
+}
+
+/****************************************************************************
+ * Name: nxscope_sample_size
+ *
+ * Description:
+ *   Get the stream size of one sample of a given channel, channel ID
+ *   included
+ *
+ ****************************************************************************/
+
+size_t nxscope_sample_size(FAR struct nxscope_s *s, uint8_t ch)
+{
+  size_t type_size = 0;
+
+  DEBUGASSERT(s);
+
+#ifdef CONFIG_LOGGING_NXSCOPE_USERTYPES
+  if (s->chinfo[ch].type.s.dtype >= NXSCOPE_TYPE_USER)
+    {
+      type_size = 1;
+    }
+  else
+#endif
+    {
+      type_size = g_type_size[s->chinfo[ch].type.s.dtype];
+    }
+
+  return 1 + type_size * s->chinfo[ch].vdim + s->chinfo[ch].mlen;
+}
+
+#if defined(CONFIG_LOGGING_NXSCOPE_DECIMATE) || \
+    defined(CONFIG_LOGGING_NXSCOPE_TRIGGER)
+/****************************************************************************
+ * Name: nxscope_val_isnum
+ ****************************************************************************/
+
+bool nxscope_val_isnum(uint8_t type)
+{
+  return (type >= NXSCOPE_TYPE_UINT8 && type <= NXSCOPE_TYPE_B32);
+}
+
+/****************************************************************************
+ * Name: nxscope_val_get
+ ****************************************************************************/
+
+double nxscope_val_get(uint8_t type, FAR const void *val, uint8_t i)
+{
+  switch (type)
+    {
+      case NXSCOPE_TYPE_UINT8:
+        return ((FAR const uint8_t *)val)[i];
+
+      case NXSCOPE_TYPE_INT8:
+        return ((FAR const int8_t *)val)[i];
+
+      case NXSCOPE_TYPE_UINT16:
+        return ((FAR const uint16_t *)val)[i];
+
+      case NXSCOPE_TYPE_INT16:
+        return ((FAR const int16_t *)val)[i];
+
+      case NXSCOPE_TYPE_UINT32:
+        return ((FAR const uint32_t *)val)[i];
+
+      case NXSCOPE_TYPE_INT32:
+        return ((FAR const int32_t *)val)[i];
+
+      case NXSCOPE_TYPE_UINT64:
+        return ((FAR const uint64_t *)val)[i];
+
+      case NXSCOPE_TYPE_INT64:
+        return ((FAR const int64_t *)val)[i];
+
+      case NXSCOPE_TYPE_FLOAT:
+        return ((FAR const float *)val)[i];
+
+      case NXSCOPE_TYPE_DOUBLE:
+        return ((FAR const double *)val)[i];
+
+      case NXSCOPE_TYPE_UB8:
+        return ((FAR const ub8_t *)val)[i] / 256.0;
+
+      case NXSCOPE_TYPE_B8:
+        return ((FAR const b8_t *)val)[i] / 256.0;
+
+      case NXSCOPE_TYPE_UB16:
+        return ((FAR const ub16_t *)val)[i] / 65536.0;
+
+      case NXSCOPE_TYPE_B16:
+        return ((FAR const b16_t *)val)[i] / 65536.0;
+
+      case NXSCOPE_TYPE_UB32:
+        return ((FAR const ub32_t *)val)[i] / 4294967296.0;
+
+      case NXSCOPE_TYPE_B32:
+        return ((FAR const b32_t *)val)[i] / 4294967296.0;
+
+      default:
+        {
+          DEBUGASSERT(0);
+          return 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxscope_val_set
+ ****************************************************************************/
+
+void nxscope_val_set(uint8_t type, FAR void *val, uint8_t i, double v)
+{
+  /* Round to nearest for integer and fixed-point types */
+
+  double r = 0;
+
+  switch (type)
+    {
+      case NXSCOPE_TYPE_UB8:
+      case NXSCOPE_TYPE_B8:
+        {
+          v *= 256.0;
+          break;
+        }
+
+      case NXSCOPE_TYPE_UB16:
+      case NXSCOPE_TYPE_B16:
+        {
+          v *= 65536.0;
+          break;
+        }
+
+      case NXSCOPE_TYPE_UB32:
+      case NXSCOPE_TYPE_B32:
+        {
+          v *= 4294967296.0;
+          break;
+        }
+
+      default:
+        {
+          break;
+        }
+    }
+
+  r = v < 0 ? v - 0.5 : v + 0.5;
+
+  switch (type)
+    {
+      case NXSCOPE_TYPE_UINT8:
+        ((FAR uint8_t *)val)[i] = r;
+        break;
+
+      case NXSCOPE_TYPE_INT8:
+        ((FAR int8_t *)val)[i] = r;
+        break;
+
+      case NXSCOPE_TYPE_UINT16:
+      case NXSCOPE_TYPE_UB8:
+        ((FAR uint16_t *)val)[i] = r;
+        break;
+
+      case NXSCOPE_TYPE_INT16:
+      case NXSCOPE_TYPE_B8:
+        ((FAR int16_t *)val)[i] = r;
+        break;
+
+      case NXSCOPE_TYPE_UINT32:
+      case NXSCOPE_TYPE_UB16:
+        ((FAR uint32_t *)val)[i] = r;
+        break;
+
+      case NXSCOPE_TYPE_INT32:
+      case NXSCOPE_TYPE_B16:
+        ((FAR int32_t *)val)[i] = r;
+        break;
+
+      case NXSCOPE_TYPE_UINT64:
+      case NXSCOPE_TYPE_UB32:
+        ((FAR uint64_t *)val)[i] = r;
+        break;
+
+      case NXSCOPE_TYPE_INT64:
+      case NXSCOPE_TYPE_B32:
+        ((FAR int64_t *)val)[i] = r;
+        break;
+
+      case NXSCOPE_TYPE_FLOAT:
+        ((FAR float *)val)[i] = v;
+        break;
+
+      case NXSCOPE_TYPE_DOUBLE:
+        ((FAR double *)val)[i] = v;
+        break;
+
+      default:
+        DEBUGASSERT(0);
+        break;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxscope_chan_init
  *
@@ -1344,6 +1762,76 @@ int nxscope_put_user_m(FAR struct nxscope_s *s, uint8_t ch,
 }
 #endif
 
+#ifdef CONFIG_LOGGING_NXSCOPE_BLOCK
+/****************************************************************************
+ * Name: nxscope_put_block_m
+ *
+ * Description:
+ *   Put n consecutive samples of a channel on the stream buffer
+ *
+ * Input Parameters:
+ *   s    - a pointer to a nxscope instance
+ *   ch   - a channel id
+ *   val  - a pointer to n sample data vectors
+ *   d    - a dimmention of sample data vector
+ *   meta - a pointer to n metadata (can be NULL if mlen is 0)
+ *   mlen - a length of metadata for one sample
+ *   n    - number of samples
+ *
+ ****************************************************************************/
+
+int nxscope_put_block_m(FAR struct nxscope_s *s, uint8_t ch,
+                        FAR void *val, uint8_t d,
+                        FAR uint8_t *meta, uint8_t mlen, size_t n)
+{
+  int ret = OK;
+
+  DEBUGASSERT(s);
+
+#ifndef CONFIG_LOGGING_NXSCOPE_DISABLE_PUTLOCK
+  nxscope_lock(s);
+#endif
+
+  /* Validate data once for the whole block */
+
+  ret = nxscope_block_validate(s, ch, d, mlen);
+  if (ret != OK)
+    {
+      goto errout;
+    }
+
+  ret = nxscope_block_put(s, ch, val, d, meta, mlen, n);
+
+errout:
+#ifndef CONFIG_LOGGING_NXSCOPE_DISABLE_PUTLOCK
+  nxscope_unlock(s);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxscope_put_block
+ *
+ * Description:
+ *   Put n consecutive samples of a channel on the stream buffer
+ *
+ * Input Parameters:
+ *   s   - a pointer to a nxscope instance
+ *   ch  - a channel id
+ *   val - a pointer to n sample data vectors
+ *   d   - a dimmention of sample data vector
+ *   n   - number of samples
+ *
+ ****************************************************************************/
+
+int nxscope_put_block(FAR struct nxscope_s *s, uint8_t ch,
+                      FAR void *val, uint8_t d, size_t n)
+{
+  return nxscope_put_block_m(s, ch, val, d, NULL, 0, n);
+}
+#endif
+
 /****************************************************************************
  * Name: nxscope_put_user_m
  *
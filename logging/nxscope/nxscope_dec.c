@@ -0,0 +1,236 @@
+/****************************************************************************
+ * apps/logging/nxscope/nxscope_dec.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <nuttx/debug.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <logging/nxscope/nxscope.h>
+
+#include "nxscope_internals.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_dec_free
+ ****************************************************************************/
+
+static void nxscope_dec_free(FAR struct nxscope_dec_s *dec)
+{
+  free(dec->acc);
+  free(dec->out);
+
+  dec->acc  = NULL;
+  dec->out  = NULL;
+  dec->mode = NXSCOPE_DEC_SKIP;
+  dec->n    = 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_chan_dec
+ *
+ * Description:
+ *   Configure decimation mode for a given channel
+ *
+ * Input Parameters:
+ *   s    - a pointer to a nxscope instance
+ *   ch   - a channel id
+ *   mode - decimation mode (enum nxscope_dec_mode_e)
+ *
+ ****************************************************************************/
+
+int nxscope_chan_dec(FAR struct nxscope_s *s, uint8_t ch, uint8_t mode)
+{
+  FAR struct nxscope_dec_s *dec   = NULL;
+  uint8_t                   type  = 0;
+  uint8_t                   vdim  = 0;
+  int                       ret   = OK;
+
+  DEBUGASSERT(s);
+
+  nxscope_lock(s);
+
+  if (ch >= s->cmninfo.chmax || mode > NXSCOPE_DEC_MINMAX)
+    {
+      _err("ERROR: invalid channel %d or mode %d\n", ch, mode);
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  _info("chan_dec=%d %d\n", ch, mode);
+
+  dec  = &s->dec[ch];
+  type = s->chinfo[ch].type.s.dtype;
+  vdim = s->chinfo[ch].vdim;
+
+  nxscope_dec_free(dec);
+
+  if (mode == NXSCOPE_DEC_SKIP)
+    {
+      goto errout;
+    }
+
+  /* Only numerical channels can be averaged */
+
+  if (!nxscope_val_isnum(type) || vdim == 0)
+    {
+      _err("ERROR: channel %d can't be decimated\n", ch);
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  dec->acc = zalloc(3 * vdim * sizeof(double));
+  dec->out = zalloc(2 * vdim * g_type_size[type]);
+  if (dec->acc == NULL || dec->out == NULL)
+    {
+      nxscope_dec_free(dec);
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  dec->mode = mode;
+
+errout:
+  nxscope_unlock(s);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxscope_dec_put
+ ****************************************************************************/
+
+int nxscope_dec_put(FAR struct nxscope_s *s, uint8_t type, uint8_t ch,
+                    FAR void *val, uint8_t d, FAR void **vec)
+{
+  FAR struct nxscope_dec_s *dec = &s->dec[ch];
+  FAR double               *sum = NULL;
+  FAR double               *min = NULL;
+  FAR double               *max = NULL;
+  size_t                    len = 0;
+  uint32_t                  n   = 0;
+  double                    v   = 0;
+  uint8_t                   i   = 0;
+
+  vec[0] = val;
+
+  if (dec->mode == NXSCOPE_DEC_SKIP)
+    {
+      return 1;
+    }
+
+  DEBUGASSERT(d == s->chinfo[ch].vdim);
+
+  n   = s->chinfo[ch].div + 1;
+  sum = dec->acc;
+  min = &dec->acc[d];
+  max = &dec->acc[2 * d];
+
+  /* Accumulate the window */
+
+  for (i = 0; i < d; i++)
+    {
+      v = nxscope_val_get(type, val, i);
+
+      if (dec->n == 0)
+        {
+          sum[i] = v;
+          min[i] = v;
+          max[i] = v;
+        }
+      else
+        {
+          sum[i] += v;
+          min[i]  = v < min[i] ? v : min[i];
+          max[i]  = v > max[i] ? v : max[i];
+        }
+    }
+
+  if (++dec->n < n)
+    {
+      return -EAGAIN;
+    }
+
+  /* Window complete */
+
+  dec->n = 0;
+  len    = g_type_size[type] * d;
+  vec[0] = dec->out;
+
+  if (dec->mode == NXSCOPE_DEC_AVERAGE)
+    {
+      for (i = 0; i < d; i++)
+        {
+          nxscope_val_set(type, dec->out, i, sum[i] / n);
+        }
+
+      return 1;
+    }
+
+  vec[1] = &dec->out[len];
+
+  for (i = 0; i < d; i++)
+    {
+      nxscope_val_set(type, vec[0], i, min[i]);
+      nxscope_val_set(type, vec[1], i, max[i]);
+    }
+
+  return 2;
+}
+
+/****************************************************************************
+ * Name: nxscope_dec_deinit
+ ****************************************************************************/
+
+void nxscope_dec_deinit(FAR struct nxscope_s *s)
+{
+  uint8_t i = 0;
+
+  DEBUGASSERT(s);
+
+  if (s->dec == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < s->cmninfo.chmax; i++)
+    {
+      nxscope_dec_free(&s->dec[i]);
+    }
+
+  free(s->dec);
+  s->dec = NULL;
+}
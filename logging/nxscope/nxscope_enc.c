@@ -0,0 +1,484 @@
+/****************************************************************************
+ * apps/logging/nxscope/nxscope_enc.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <nuttx/debug.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <logging/nxscope/nxscope.h>
+
+#include "nxscope_internals.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* LZ parameters */
+
+#define NXSCOPE_LZ_HASHBITS  (10)
+#define NXSCOPE_LZ_MINMATCH  (3)
+#define NXSCOPE_LZ_MAXMATCH  (NXSCOPE_LZ_MINMATCH + 0x7f)
+#define NXSCOPE_LZ_MAXLIT    (0x80)
+#define NXSCOPE_LZ_MAXDIST   (0xffff)
+#define NXSCOPE_LZ_HASHSIZE  (1 << NXSCOPE_LZ_HASHBITS)
+
+/* No previous sample of a channel in the frame */
+
+#define NXSCOPE_ENC_NOLAST   ((size_t)-1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_enc_isint
+ *
+ * Description:
+ *   Check if a data type is delta encoded and if it is signed
+ *
+ ****************************************************************************/
+
+static bool nxscope_enc_isint(uint8_t dtype, FAR bool *sign)
+{
+  switch (dtype)
+    {
+      case NXSCOPE_TYPE_UINT8:
+      case NXSCOPE_TYPE_UINT16:
+      case NXSCOPE_TYPE_UINT32:
+      case NXSCOPE_TYPE_UINT64:
+      case NXSCOPE_TYPE_UB8:
+      case NXSCOPE_TYPE_UB16:
+      case NXSCOPE_TYPE_UB32:
+        {
+          *sign = false;
+          return true;
+        }
+
+      case NXSCOPE_TYPE_INT8:
+      case NXSCOPE_TYPE_INT16:
+      case NXSCOPE_TYPE_INT32:
+      case NXSCOPE_TYPE_INT64:
+      case NXSCOPE_TYPE_B8:
+      case NXSCOPE_TYPE_B16:
+      case NXSCOPE_TYPE_B32:
+        {
+          *sign = true;
+          return true;
+        }
+
+      default:
+        {
+          return false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxscope_enc_get
+ *
+ * Description:
+ *   Get a little-endian integer, sign extended if needed
+ *
+ ****************************************************************************/
+
+static uint64_t nxscope_enc_get(FAR const uint8_t *buff, size_t size,
+                                bool sign)
+{
+  uint64_t val = 0;
+  size_t   i   = 0;
+
+  for (i = 0; i < size; i++)
+    {
+      val |= (uint64_t)buff[i] << (8 * i);
+    }
+
+  if (sign && size < sizeof(uint64_t) && (buff[size - 1] & 0x80))
+    {
+      val |= UINT64_MAX << (8 * size);
+    }
+
+  return val;
+}
+
+/****************************************************************************
+ * Name: nxscope_delta_encode
+ *
+ * Description:
+ *   Delta and zigzag varint encoding of samples data.
+ *
+ *   Each sample starts with a channel ID, except for the samples of block
+ *   entries that follow the entry header.
+ *
+ *   Returns the encoded length or a negated errno value if the output
+ *   doesn't fit in outlen bytes.
+ *
+ ****************************************************************************/
+
+static ssize_t nxscope_delta_encode(FAR struct nxscope_s *s,
+                                    FAR const uint8_t *in, size_t len,
+                                    FAR uint8_t *out, size_t outlen)
+{
+  FAR const uint8_t *prev  = NULL;
+  FAR size_t        *last  = NULL;
+  size_t             tsize = 0;
+  size_t             ssize = 0;
+  size_t             cnt   = 0;
+  size_t             i     = 0;
+  size_t             o     = 0;
+  size_t             j     = 0;
+  uint64_t           delta = 0;
+  uint8_t            ch    = 0;
+  bool               sign  = false;
+
+  for (j = 0; j < s->cmninfo.chmax; j++)
+    {
+      s->enclast[j] = NXSCOPE_ENC_NOLAST;
+    }
+
+  while (i < len)
+    {
+      /* Get sample channel */
+
+      if (cnt == 0 && in[i] == NXSCOPE_BLOCK_ID)
+        {
+          /* Block entry header: ID, channel and 16-bit count */
+
+          if (i + 4 > len || o + 4 > outlen)
+            {
+              return -EINVAL;
+            }
+
+          ch  = in[i + 1];
+          cnt = in[i + 2] | (in[i + 3] << 8);
+          if (ch >= s->cmninfo.chmax || cnt == 0)
+            {
+              return -EINVAL;
+            }
+
+          memcpy(&out[o], &in[i], 4);
+          o += 4;
+          i += 4;
+        }
+      else if (cnt == 0)
+        {
+          ch = in[i];
+          if (ch >= s->cmninfo.chmax || o >= outlen)
+            {
+              return -EINVAL;
+            }
+
+          out[o++] = in[i++];
+          cnt      = 1;
+        }
+
+      last = &s->enclast[ch];
+      cnt -= 1;
+
+      ssize = nxscope_sample_size(s, ch) - 1;
+      if (i + ssize > len)
+        {
+          return -EINVAL;
+        }
+
+      /* Data types not delta encoded are copied with metadata */
+
+      if (!nxscope_enc_isint(s->chinfo[ch].type.s.dtype, &sign))
+        {
+          if (o + ssize > outlen)
+            {
+              return -ENOBUFS;
+            }
+
+          memcpy(&out[o], &in[i], ssize);
+          o += ssize;
+          i += ssize;
+          continue;
+        }
+
+      tsize = g_type_size[s->chinfo[ch].type.s.dtype];
+      prev  = *last != NXSCOPE_ENC_NOLAST ? &in[*last] : NULL;
+      *last = i;
+
+      for (j = 0; j < s->chinfo[ch].vdim; j++)
+        {
+          delta = nxscope_enc_get(&in[i + j * tsize], tsize, sign);
+          if (prev != NULL)
+            {
+              delta -= nxscope_enc_get(&prev[j * tsize], tsize, sign);
+            }
+
+          /* Zigzag */
+
+          delta = (delta << 1) ^ (uint64_t)((int64_t)delta >> 63);
+
+          /* Varint */
+
+          do
+            {
+              if (o >= outlen)
+                {
+                  return -ENOBUFS;
+                }
+
+              out[o++] = (delta & 0x7f) | (delta > 0x7f ? 0x80 : 0);
+              delta >>= 7;
+            }
+          while (delta != 0);
+        }
+
+      i += tsize * s->chinfo[ch].vdim;
+
+      /* Metadata */
+
+      j = s->chinfo[ch].mlen;
+      if (o + j > outlen)
+        {
+          return -ENOBUFS;
+        }
+
+      memcpy(&out[o], &in[i], j);
+      o += j;
+      i += j;
+    }
+
+  return o;
+}
+
+/****************************************************************************
+ * Name: nxscope_lz_literal
+ ****************************************************************************/
+
+static ssize_t nxscope_lz_literal(FAR const uint8_t *in, size_t len,
+                                  FAR uint8_t *out, size_t o, size_t outlen)
+{
+  size_t n = 0;
+
+  while (len > 0)
+    {
+      n = len > NXSCOPE_LZ_MAXLIT ? NXSCOPE_LZ_MAXLIT : len;
+      if (o + 1 + n > outlen)
+        {
+          return -ENOBUFS;
+        }
+
+      out[o++] = n - 1;
+      memcpy(&out[o], in, n);
+      o   += n;
+      in  += n;
+      len -= n;
+    }
+
+  return o;
+}
+
+/****************************************************************************
+ * Name: nxscope_lz_encode
+ *
+ * Description:
+ *   Greedy LZ77 with a single entry hash table.
+ *
+ *   Returns the encoded length or a negated errno value if the output
+ *   doesn't fit in outlen bytes.
+ *
+ ****************************************************************************/
+
+static ssize_t nxscope_lz_encode(FAR struct nxscope_s *s,
+                                 FAR const uint8_t *in, size_t len,
+                                 FAR uint8_t *out, size_t outlen)
+{
+  ssize_t  o     = 0;
+  size_t   lit   = 0;
+  size_t   i     = 0;
+  size_t   m     = 0;
+  size_t   l     = 0;
+  uint32_t h     = 0;
+
+  /* Positions are stored as uint16_t + 1 */
+
+  if (len >= NXSCOPE_LZ_MAXDIST)
+    {
+      return -E2BIG;
+    }
+
+  memset(s->lzhash, 0, NXSCOPE_LZ_HASHSIZE * sizeof(uint16_t));
+
+  while (i + NXSCOPE_LZ_MINMATCH <= len)
+    {
+      h = ((uint32_t)in[i] | (uint32_t)in[i + 1] << 8 |
+           (uint32_t)in[i + 2] << 16) * 2654435761u;
+      h >>= 32 - NXSCOPE_LZ_HASHBITS;
+
+      m = s->lzhash[h];
+      s->lzhash[h] = i + 1;
+
+      if (m == 0 || memcmp(&in[m - 1], &in[i], NXSCOPE_LZ_MINMATCH) != 0)
+        {
+          i++;
+          continue;
+        }
+
+      m -= 1;
+      l  = NXSCOPE_LZ_MINMATCH;
+      while (i + l < len && l < NXSCOPE_LZ_MAXMATCH && in[m + l] == in[i + l])
+        {
+          l++;
+        }
+
+      o = nxscope_lz_literal(&in[lit], i - lit, out, o, outlen);
+      if (o < 0 || (size_t)o + 3 > outlen)
+        {
+          return -ENOBUFS;
+        }
+
+      out[o++] = 0x80 | (l - NXSCOPE_LZ_MINMATCH);
+      out[o++] = (i - m) & 0xff;
+      out[o++] = ((i - m) >> 8) & 0xff;
+
+      i  += l;
+      lit = i;
+    }
+
+  return nxscope_lz_literal(&in[lit], len - lit, out, o, outlen);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_encode_init
+ ****************************************************************************/
+
+int nxscope_encode_init(FAR struct nxscope_s *s)
+{
+  DEBUGASSERT(s);
+
+  s->encbuf = zalloc(s->streambuf_len);
+  if (s->encbuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  s->enclast = zalloc(s->cmninfo.chmax * sizeof(size_t));
+  if (s->enclast == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  s->lzhash = zalloc(NXSCOPE_LZ_HASHSIZE * sizeof(uint16_t));
+  if (s->lzhash == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  s->cmninfo.flags |= (NXSCOPE_FLAGS_DELTA_SUPPORT |
+                       NXSCOPE_FLAGS_LZ_SUPPORT);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxscope_encode_deinit
+ ****************************************************************************/
+
+void nxscope_encode_deinit(FAR struct nxscope_s *s)
+{
+  DEBUGASSERT(s);
+
+  free(s->encbuf);
+  free(s->enclast);
+  free(s->lzhash);
+}
+
+/****************************************************************************
+ * Name: nxscope_encode
+ ****************************************************************************/
+
+void nxscope_encode(FAR struct nxscope_s *s, FAR uint8_t *buff,
+                    FAR size_t *buff_i, size_t off)
+{
+  FAR uint8_t *data   = &buff[off];
+  FAR uint8_t *enc    = data;
+  FAR uint8_t *out    = NULL;
+  size_t       len    = *buff_i - off;
+  size_t       enclen = len;
+  size_t       outlen = 0;
+  uint8_t      flags  = 0;
+  ssize_t      ret    = 0;
+
+  DEBUGASSERT(s);
+
+  if (s->encode == 0 || len < 2)
+    {
+      return;
+    }
+
+  /* Keep the encoding only if the frame gets shorter */
+
+  if (s->encode & NXSCOPE_START_DELTA)
+    {
+      outlen = len - 1 < s->streambuf_len ? len - 1 : s->streambuf_len;
+      ret = nxscope_delta_encode(s, data, len, s->encbuf, outlen);
+      if (ret > 0)
+        {
+          enc     = s->encbuf;
+          enclen  = ret;
+          flags  |= NXSCOPE_STREAM_FLAGS_DELTA;
+        }
+    }
+
+  if (s->encode & NXSCOPE_START_LZ)
+    {
+      /* Raw data is not needed once it's delta encoded */
+
+      out    = enc == data ? s->encbuf : data;
+      outlen = enclen - 1;
+      if (out == s->encbuf && outlen > s->streambuf_len)
+        {
+          outlen = s->streambuf_len;
+        }
+
+      ret = nxscope_lz_encode(s, enc, enclen, out, outlen);
+      if (ret > 0)
+        {
+          enc     = out;
+          enclen  = ret;
+          flags  |= NXSCOPE_STREAM_FLAGS_LZ;
+        }
+    }
+
+  if (enc != data)
+    {
+      memcpy(data, enc, enclen);
+    }
+
+  buff[s->proto_stream->hdrlen] |= flags;
+  *buff_i = off + enclen;
+}
@@ -84,11 +84,12 @@ static int nxscope_dummy_send(FAR struct nxscope_intf_s *intf,
 
   priv = (FAR struct nxscope_intf_dummy_s *)intf->priv;
 
-  UNUSED(priv);
-
   /* Dump send buffer */
 
-  lib_dumpbuffer("nxscope_dummy_send", buff, len);
+  if (!priv->cfg->nodump)
+    {
+      lib_dumpbuffer("nxscope_dummy_send", buff, len);
+    }
 
   return OK;
 }
@@ -111,11 +112,12 @@ static int nxscope_dummy_recv(FAR struct nxscope_intf_s *intf,
 
   priv = (FAR struct nxscope_intf_dummy_s *)intf->priv;
 
-  UNUSED(priv);
-
   /* Dump recv buffer */
 
-  lib_dumpbuffer("nxscope_dummy_recv", buff, len);
+  if (!priv->cfg->nodump)
+    {
+      lib_dumpbuffer("nxscope_dummy_recv", buff, len);
+    }
 
   return OK;
 }
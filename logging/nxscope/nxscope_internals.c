@@ -65,6 +65,12 @@ int nxscope_stream_send(FAR struct nxscope_s *s, FAR uint8_t *buff,
 
   if (!s->stream_retry)
     {
+#ifdef CONFIG_LOGGING_NXSCOPE_ENCODE
+      /* Encode samples data */
+
+      nxscope_encode(s, buff, buff_i, s->proto_stream->hdrlen + 1);
+#endif
+
       ret = PROTO_FRAME_FINAL(s, s->proto_stream,
                               NXSCOPE_HDRID_STREAM, buff, buff_i);
       if (ret < 0)
@@ -90,3 +96,62 @@ int nxscope_stream_send(FAR struct nxscope_s *s, FAR uint8_t *buff,
 errout:
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxscope_stream_reset
+ *
+ * NOTE: This function assumes that we have exclusive access to the nxscope
+ *       instance
+ *
+ ****************************************************************************/
+
+void nxscope_stream_reset(FAR struct nxscope_s *s)
+{
+  DEBUGASSERT(s);
+
+  /* Offset for hdr + 1 byte for flags */
+
+  s->stream_i = s->proto_stream->hdrlen + 1;
+
+  /* Reset flags */
+
+  s->streambuf[s->proto_stream->hdrlen] = 0;
+}
+
+/****************************************************************************
+ * Name: nxscope_stream_empty
+ *
+ * NOTE: This function assumes that we have exclusive access to the nxscope
+ *       instance
+ *
+ ****************************************************************************/
+
+bool nxscope_stream_empty(FAR struct nxscope_s *s)
+{
+  DEBUGASSERT(s);
+
+  if (s->stream_i > s->proto_stream->hdrlen + 1)
+    {
+      return false;
+    }
+  else
+    {
+      return true;
+    }
+}
+
+/****************************************************************************
+ * Name: nxscope_stream_overflow
+ *
+ * NOTE: This function assumes that we have exclusive access to the nxscope
+ *       instance
+ *
+ ****************************************************************************/
+
+void nxscope_stream_overflow(FAR struct nxscope_s *s, uint32_t lost)
+{
+  DEBUGASSERT(s);
+
+  s->streambuf[s->proto_stream->hdrlen] |= NXSCOPE_STREAM_FLAGS_OVERFLOW;
+  s->stream_ovf += lost;
+}
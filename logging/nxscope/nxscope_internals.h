@@ -51,6 +51,14 @@
 #define INTF_RECV(s, intf, buff, i)             \
   (s)->intf_stream->ops->recv(intf, buff, i)
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Size of the channel data types */
+
+extern int g_type_size[];
+
 /****************************************************************************
  * Public Function Puttypes
  ****************************************************************************/
@@ -71,4 +79,277 @@
 int nxscope_stream_send(FAR struct nxscope_s *s, FAR uint8_t *buff,
                         FAR size_t *buff_i);
 
+/****************************************************************************
+ * Name: nxscope_stream_reset
+ *
+ * Description:
+ *   Reset stream buffer
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+void nxscope_stream_reset(FAR struct nxscope_s *s);
+
+/****************************************************************************
+ * Name: nxscope_stream_empty
+ *
+ * Description:
+ *   Check if stream buffer is empty
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+bool nxscope_stream_empty(FAR struct nxscope_s *s);
+
+/****************************************************************************
+ * Name: nxscope_stream_overflow
+ *
+ * Description:
+ *   Mark the current stream frame as overflowed and count lost samples
+ *
+ * Input Parameters:
+ *   s    - a pointer to a nxscope instance
+ *   lost - number of lost samples
+ *
+ ****************************************************************************/
+
+void nxscope_stream_overflow(FAR struct nxscope_s *s, uint32_t lost);
+
+/****************************************************************************
+ * Name: nxscope_put_sample
+ *
+ * Description:
+ *   Pack a sample (channel ID, data and metadata) in a given buffer
+ *
+ * Input Parameters:
+ *   buff   - buffer to write
+ *   buff_i - buffer cursor
+ *   type   - a channel data type
+ *   ch     - a channel id
+ *   val    - a pointer to a sample data vector
+ *   d      - a dimmention of sample data vector
+ *   meta   - a pointer to metadata
+ *   mlen   - a length of metadata
+ *
+ ****************************************************************************/
+
+void nxscope_put_sample(FAR uint8_t *buff, FAR size_t *buff_i,
+                        uint8_t type, uint8_t ch, FAR void *val,
+                        uint8_t d, FAR uint8_t *meta, uint8_t mlen);
+
+/****************************************************************************
+ * Name: nxscope_sample_size
+ *
+ * Description:
+ *   Get the stream size of one sample of a given channel, channel ID
+ *   included
+ *
+ * Input Parameters:
+ *   s  - a pointer to a nxscope instance
+ *   ch - a channel id
+ *
+ ****************************************************************************/
+
+size_t nxscope_sample_size(FAR struct nxscope_s *s, uint8_t ch);
+
+#ifdef CONFIG_LOGGING_NXSCOPE_STAGE
+/****************************************************************************
+ * Name: nxscope_stage_merge
+ *
+ * Description:
+ *   Move the samples waiting in the producers staging buffers to the
+ *   stream buffer.
+ *
+ *   NOTE: This function assumes that we have exclusive access to the
+ *         nxscope instance
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+void nxscope_stage_merge(FAR struct nxscope_s *s);
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_ENCODE
+/****************************************************************************
+ * Name: nxscope_encode_init
+ *
+ * Description:
+ *   Allocate stream encoding data and advertise the supported encodings
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+int nxscope_encode_init(FAR struct nxscope_s *s);
+
+/****************************************************************************
+ * Name: nxscope_encode_deinit
+ *
+ * Description:
+ *   Free stream encoding data
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+void nxscope_encode_deinit(FAR struct nxscope_s *s);
+
+/****************************************************************************
+ * Name: nxscope_encode
+ *
+ * Description:
+ *   Encode samples data of a frame in place with the encodings requested
+ *   by the client. An encoding is used only if it makes the frame
+ *   shorter, the applied encodings are set in the frame flags.
+ *
+ *   NOTE: This function assumes that we have exclusive access to the
+ *         nxscope instance
+ *
+ * Input Parameters:
+ *   s      - a pointer to a nxscope instance
+ *   buff   - frame buffer
+ *   buff_i - frame buffer cursor
+ *   off    - offset of the samples data in the frame buffer
+ *
+ ****************************************************************************/
+
+void nxscope_encode(FAR struct nxscope_s *s, FAR uint8_t *buff,
+                    FAR size_t *buff_i, size_t off);
+#endif
+
+#if defined(CONFIG_LOGGING_NXSCOPE_DECIMATE) || \
+    defined(CONFIG_LOGGING_NXSCOPE_TRIGGER)
+/****************************************************************************
+ * Name: nxscope_val_isnum
+ *
+ * Description:
+ *   Check if a data type is numerical (supported by nxscope_val_get/set)
+ *
+ ****************************************************************************/
+
+bool nxscope_val_isnum(uint8_t type);
+
+/****************************************************************************
+ * Name: nxscope_val_get
+ *
+ * Description:
+ *   Get a vector element as a real value
+ *
+ * Input Parameters:
+ *   type - a channel data type
+ *   val  - a pointer to a sample data vector
+ *   i    - element index
+ *
+ ****************************************************************************/
+
+double nxscope_val_get(uint8_t type, FAR const void *val, uint8_t i);
+
+/****************************************************************************
+ * Name: nxscope_val_set
+ *
+ * Description:
+ *   Set a vector element from a real value
+ *
+ * Input Parameters:
+ *   type - a channel data type
+ *   val  - a pointer to a sample data vector
+ *   i    - element index
+ *   v    - value
+ *
+ ****************************************************************************/
+
+void nxscope_val_set(uint8_t type, FAR void *val, uint8_t i, double v);
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_DECIMATE
+/****************************************************************************
+ * Name: nxscope_dec_put
+ *
+ * Description:
+ *   Feed a sample to the channel decimation.
+ *
+ *   NOTE: This function assumes that we have exclusive access to the
+ *         nxscope instance
+ *
+ * Input Parameters:
+ *   s    - a pointer to a nxscope instance
+ *   type - a channel data type
+ *   ch   - a channel id
+ *   val  - a pointer to a sample data vector
+ *   d    - a dimmention of sample data vector
+ *   vec  - returned decimated vectors (2 elements)
+ *
+ * Returned Value:
+ *   Number of vectors to put on the stream or -EAGAIN if the decimation
+ *   window is not complete.
+ *
+ ****************************************************************************/
+
+int nxscope_dec_put(FAR struct nxscope_s *s, uint8_t type, uint8_t ch,
+                    FAR void *val, uint8_t d, FAR void **vec);
+
+/****************************************************************************
+ * Name: nxscope_dec_deinit
+ *
+ * Description:
+ *   Free decimation data
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+void nxscope_dec_deinit(FAR struct nxscope_s *s);
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_TRIGGER
+/****************************************************************************
+ * Name: nxscope_trig_put
+ *
+ * Description:
+ *   Put a sample on the trigger buffer and update the trigger state.
+ *
+ *   NOTE: This function assumes that we have exclusive access to the
+ *         nxscope instance
+ *
+ * Input Parameters:
+ *   s    - a pointer to a nxscope instance
+ *   type - a channel data type
+ *   ch   - a channel id
+ *   val  - a pointer to a sample data vector
+ *   d    - a dimmention of sample data vector
+ *   meta - a pointer to metadata
+ *   mlen - a length of metadata
+ *
+ ****************************************************************************/
+
+int nxscope_trig_put(FAR struct nxscope_s *s, uint8_t type, uint8_t ch,
+                     FAR void *val, uint8_t d,
+                     FAR uint8_t *meta, uint8_t mlen);
+
+/****************************************************************************
+ * Name: nxscope_trig_merge
+ *
+ * Description:
+ *   Move the captured samples to the stream buffer.
+ *
+ *   NOTE: This function assumes that we have exclusive access to the
+ *         nxscope instance
+ *
+ * Input Parameters:
+ *   s - a pointer to a nxscope instance
+ *
+ ****************************************************************************/
+
+void nxscope_trig_merge(FAR struct nxscope_s *s);
+#endif
+
 #endif  /* __APPS_LOGGING_NXSCOPE_NXSCOPE_INTERNALS_H */
@@ -0,0 +1,486 @@
+/****************************************************************************
+ * apps/logging/nxscope/nxscope_iring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <nuttx/debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <logging/nxscope/nxscope.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each frame in the ring is preceded by its 2B little-endian length */
+
+#define NXSCOPE_RING_HDRLEN  (2)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nxscope_intf_ring_s
+{
+  FAR struct nxscope_ring_cfg_s *cfg;
+  FAR uint8_t                   *buf;      /* RAM ring */
+  size_t                         head;     /* Write offset */
+  size_t                         tail;     /* Oldest frame offset */
+  size_t                         used;     /* Bytes used in the ring */
+  size_t                         post;     /* Bytes stored after trigger */
+  uint8_t                        state;    /* enum nxscope_ring_state_e */
+  volatile bool                  trigger;  /* Trigger request */
+  pthread_mutex_t                lock;
+};
+
+/****************************************************************************
+ * Private Function Protototypes
+ ****************************************************************************/
+
+static int nxscope_ring_send(FAR struct nxscope_intf_s *intf,
+                             FAR uint8_t *buff, int len);
+static int nxscope_ring_recv(FAR struct nxscope_intf_s *intf,
+                             FAR uint8_t *buff, int len);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct nxscope_intf_ops_s g_nxscope_ring_ops =
+{
+  nxscope_ring_send,
+  nxscope_ring_recv
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_ring_put
+ ****************************************************************************/
+
+static void nxscope_ring_put(FAR struct nxscope_intf_ring_s *priv,
+                             FAR const uint8_t *data, size_t len)
+{
+  size_t n = 0;
+
+  n = priv->cfg->len - priv->head;
+  if (n > len)
+    {
+      n = len;
+    }
+
+  memcpy(&priv->buf[priv->head], data, n);
+  memcpy(priv->buf, &data[n], len - n);
+
+  priv->head  = (priv->head + len) % priv->cfg->len;
+  priv->used += len;
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_byte
+ ****************************************************************************/
+
+static uint8_t nxscope_ring_byte(FAR struct nxscope_intf_ring_s *priv,
+                                 size_t off)
+{
+  return priv->buf[off % priv->cfg->len];
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_framelen
+ *
+ * Description:
+ *   Get the length of the frame at a given ring offset (header included)
+ *
+ ****************************************************************************/
+
+static size_t nxscope_ring_framelen(FAR struct nxscope_intf_ring_s *priv,
+                                    size_t off)
+{
+  return NXSCOPE_RING_HDRLEN + (nxscope_ring_byte(priv, off) |
+                                nxscope_ring_byte(priv, off + 1) << 8);
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_drop
+ *
+ * Description:
+ *   Drop the oldest frame
+ *
+ ****************************************************************************/
+
+static void nxscope_ring_drop(FAR struct nxscope_intf_ring_s *priv)
+{
+  size_t len = nxscope_ring_framelen(priv, priv->tail);
+
+  priv->tail  = (priv->tail + len) % priv->cfg->len;
+  priv->used -= len;
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_reset
+ ****************************************************************************/
+
+static void nxscope_ring_reset(FAR struct nxscope_intf_ring_s *priv)
+{
+  priv->head    = 0;
+  priv->tail    = 0;
+  priv->used    = 0;
+  priv->post    = 0;
+  priv->trigger = false;
+  priv->state   = NXSCOPE_RING_ARMED;
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_send
+ ****************************************************************************/
+
+static int nxscope_ring_send(FAR struct nxscope_intf_s *intf,
+                             FAR uint8_t *buff, int len)
+{
+  FAR struct nxscope_intf_ring_s *priv = NULL;
+  uint8_t                         hdr[NXSCOPE_RING_HDRLEN];
+  size_t                          rec  = 0;
+
+  DEBUGASSERT(intf);
+  DEBUGASSERT(intf->priv);
+
+  /* Get priv data */
+
+  priv = (FAR struct nxscope_intf_ring_s *)intf->priv;
+
+  rec = NXSCOPE_RING_HDRLEN + len;
+  if (len > UINT16_MAX || rec > priv->cfg->len)
+    {
+      return -E2BIG;
+    }
+
+  pthread_mutex_lock(&priv->lock);
+
+  if (priv->state == NXSCOPE_RING_ARMED && priv->trigger)
+    {
+      priv->state = NXSCOPE_RING_TRIGGERED;
+    }
+
+  if (priv->state == NXSCOPE_RING_ARMED)
+    {
+      /* Keep only the newest pre-trigger frames */
+
+      while (priv->used > 0 && priv->used + rec > priv->cfg->pretrig)
+        {
+          nxscope_ring_drop(priv);
+        }
+
+      if (rec > priv->cfg->pretrig)
+        {
+          goto out;
+        }
+    }
+  else if (priv->state == NXSCOPE_RING_TRIGGERED)
+    {
+      /* The rest of the ring is for post-trigger frames */
+
+      if (priv->post + rec > priv->cfg->len - priv->cfg->pretrig)
+        {
+          priv->state = NXSCOPE_RING_DONE;
+          goto out;
+        }
+
+      priv->post += rec;
+    }
+  else
+    {
+      /* Capture done, drop frames until re-armed */
+
+      goto out;
+    }
+
+  hdr[0] = len & 0xff;
+  hdr[1] = (len >> 8) & 0xff;
+
+  nxscope_ring_put(priv, hdr, NXSCOPE_RING_HDRLEN);
+  nxscope_ring_put(priv, buff, len);
+
+out:
+  pthread_mutex_unlock(&priv->lock);
+
+  /* Dropped frames are not an error, there is nobody to retry for */
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_recv
+ ****************************************************************************/
+
+static int nxscope_ring_recv(FAR struct nxscope_intf_s *intf,
+                             FAR uint8_t *buff, int len)
+{
+  UNUSED(intf);
+  UNUSED(buff);
+  UNUSED(len);
+
+  /* No host connected, nothing to receive */
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_ring_init
+ ****************************************************************************/
+
+int nxscope_ring_init(FAR struct nxscope_intf_s *intf,
+                      FAR struct nxscope_ring_cfg_s *cfg)
+{
+  FAR struct nxscope_intf_ring_s *priv = NULL;
+  int                             ret  = OK;
+
+  DEBUGASSERT(intf);
+  DEBUGASSERT(cfg);
+
+  if (cfg->len <= NXSCOPE_RING_HDRLEN || cfg->pretrig > cfg->len)
+    {
+      return -EINVAL;
+    }
+
+  /* Allocate priv data */
+
+  intf->priv = zalloc(sizeof(struct nxscope_intf_ring_s));
+  if (intf->priv == NULL)
+    {
+      _err("ERROR: intf->priv alloc failed %d\n", errno);
+      ret = -errno;
+      goto errout;
+    }
+
+  /* Get priv data */
+
+  priv = (FAR struct nxscope_intf_ring_s *)intf->priv;
+
+  /* Connect configuration */
+
+  priv->cfg = cfg;
+
+  /* Allocate the ring up front, nothing is allocated when capturing */
+
+  priv->buf = zalloc(cfg->len);
+  if (priv->buf == NULL)
+    {
+      _err("ERROR: ring alloc failed %d\n", errno);
+      ret = -errno;
+      goto errout;
+    }
+
+  pthread_mutex_init(&priv->lock, NULL);
+  nxscope_ring_reset(priv);
+
+  /* Connect ops */
+
+  intf->ops = &g_nxscope_ring_ops;
+
+  /* Initialized */
+
+  intf->initialized = true;
+  return OK;
+
+errout:
+  if (priv != NULL)
+    {
+      free(priv);
+      intf->priv = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_deinit
+ ****************************************************************************/
+
+void nxscope_ring_deinit(FAR struct nxscope_intf_s *intf)
+{
+  FAR struct nxscope_intf_ring_s *priv = NULL;
+
+  DEBUGASSERT(intf);
+
+  /* Get priv data */
+
+  priv = (FAR struct nxscope_intf_ring_s *)intf->priv;
+
+  if (priv != NULL)
+    {
+      pthread_mutex_destroy(&priv->lock);
+      free(priv->buf);
+      free(priv);
+    }
+
+  /* Reset structure */
+
+  memset(intf, 0, sizeof(struct nxscope_intf_s));
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_arm
+ ****************************************************************************/
+
+void nxscope_ring_arm(FAR struct nxscope_intf_s *intf)
+{
+  FAR struct nxscope_intf_ring_s *priv = NULL;
+
+  DEBUGASSERT(intf);
+  DEBUGASSERT(intf->priv);
+
+  priv = (FAR struct nxscope_intf_ring_s *)intf->priv;
+
+  pthread_mutex_lock(&priv->lock);
+  nxscope_ring_reset(priv);
+  pthread_mutex_unlock(&priv->lock);
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_trigger
+ ****************************************************************************/
+
+void nxscope_ring_trigger(FAR struct nxscope_intf_s *intf)
+{
+  FAR struct nxscope_intf_ring_s *priv = NULL;
+
+  DEBUGASSERT(intf);
+  DEBUGASSERT(intf->priv);
+
+  priv = (FAR struct nxscope_intf_ring_s *)intf->priv;
+
+  /* No lock here, the request is handled with the next frame */
+
+  priv->trigger = true;
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_state
+ ****************************************************************************/
+
+int nxscope_ring_state(FAR struct nxscope_intf_s *intf)
+{
+  FAR struct nxscope_intf_ring_s *priv = NULL;
+
+  DEBUGASSERT(intf);
+  DEBUGASSERT(intf->priv);
+
+  priv = (FAR struct nxscope_intf_ring_s *)intf->priv;
+
+  return priv->state;
+}
+
+/****************************************************************************
+ * Name: nxscope_ring_flush
+ ****************************************************************************/
+
+ssize_t nxscope_ring_flush(FAR struct nxscope_intf_s *intf,
+                           FAR const char *path)
+{
+  FAR struct nxscope_intf_ring_s *priv = NULL;
+  ssize_t                         ret  = 0;
+  size_t                          off  = 0;
+  size_t                          left = 0;
+  size_t                          flen = 0;
+  size_t                          n    = 0;
+  int                             fd   = -1;
+
+  DEBUGASSERT(intf);
+  DEBUGASSERT(intf->priv);
+
+  priv = (FAR struct nxscope_intf_ring_s *)intf->priv;
+
+  if (path == NULL)
+    {
+      path = priv->cfg->path;
+    }
+
+  if (path == NULL)
+    {
+      return -EINVAL;
+    }
+
+  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0)
+    {
+      _err("ERROR: failed to open %s %d\n", path, errno);
+      return -errno;
+    }
+
+  pthread_mutex_lock(&priv->lock);
+
+  /* Write frames from the oldest one, without the ring headers */
+
+  off  = priv->tail;
+  left = priv->used;
+
+  while (left > 0)
+    {
+      flen  = nxscope_ring_framelen(priv, off);
+      left -= flen;
+      off   = (off + NXSCOPE_RING_HDRLEN) % priv->cfg->len;
+      flen -= NXSCOPE_RING_HDRLEN;
+
+      while (flen > 0)
+        {
+          n = priv->cfg->len - off;
+          if (n > flen)
+            {
+              n = flen;
+            }
+
+          if (write(fd, &priv->buf[off], n) != (ssize_t)n)
+            {
+              _err("ERROR: failed to write %s %d\n", path, errno);
+              ret = -errno;
+              goto errout;
+            }
+
+          ret  += n;
+          flen -= n;
+          off   = (off + n) % priv->cfg->len;
+        }
+    }
+
+errout:
+  pthread_mutex_unlock(&priv->lock);
+  close(fd);
+
+  return ret;
+}
@@ -0,0 +1,377 @@
+/****************************************************************************
+ * apps/logging/nxscope/nxscope_stage.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <nuttx/debug.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <logging/nxscope/nxscope.h>
+
+#include "nxscope_internals.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Marker of the unused space at the end of the ring. Channel IDs are
+ * limited to 254 (chmax is uint8_t), so it never starts a sample.
+ */
+
+#define NXSCOPE_STAGE_WRAP (0xff)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_stage_validate
+ ****************************************************************************/
+
+static int nxscope_stage_validate(FAR struct nxscope_s *s, uint8_t ch,
+                                  uint8_t d, uint8_t mlen)
+{
+  /* Do nothing if stream not started or channel not enabled.
+   * No lock here, a stale value only delays or drops one sample.
+   */
+
+  if (!s->start || s->chinfo[ch].enable != 1)
+    {
+      return -EAGAIN;
+    }
+
+#ifdef CONFIG_DEBUG_FEATURES
+  /* Validate channel */
+
+  if (ch > s->cmninfo.chmax)
+    {
+      _err("ERROR: invalid channel %d\n", ch);
+      return -EINVAL;
+    }
+
+  /* Validate channel vdim */
+
+  if (s->chinfo[ch].vdim != d)
+    {
+      _err("ERROR: invalid channel dim %d\n", d);
+      return -EINVAL;
+    }
+
+  /* Validate channel metadata size */
+
+  if (s->chinfo[ch].mlen != mlen)
+    {
+      _err("ERROR: invalid channel mlen %d\n", mlen);
+      return -EINVAL;
+    }
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_CRICHANNELS
+  /* Critical channels are sent without buffering */
+
+  if (s->chinfo[ch].type.s.cri)
+    {
+      return -EINVAL;
+    }
+#endif
+
+#ifdef CONFIG_LOGGING_NXSCOPE_DIVIDER
+  /* Handle sample rate divider. The channel has only one producer, so the
+   * counter is not shared.
+   */
+
+  s->cntr[ch] += 1;
+  if (s->cntr[ch] % (s->chinfo[ch].div + 1) != 0)
+    {
+      return -EAGAIN;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxscope_stage_merge_one
+ *
+ * NOTE: This function assumes that we have exclusive access to the nxscope
+ *       instance
+ *
+ ****************************************************************************/
+
+static void nxscope_stage_merge_one(FAR struct nxscope_s *s,
+                                    FAR struct nxscope_stage_s *stage)
+{
+  unsigned int overflow = 0;
+  size_t       mask     = stage->len - 1;
+  size_t       head     = 0;
+  size_t       tail     = 0;
+  size_t       size     = 0;
+  size_t       idx      = 0;
+
+  tail = atomic_load_explicit(&stage->tail, memory_order_relaxed);
+  head = atomic_load_explicit(&stage->head, memory_order_acquire);
+
+  while (tail != head)
+    {
+      idx = tail & mask;
+
+      if (stage->buf[idx] == NXSCOPE_STAGE_WRAP)
+        {
+          tail += stage->len - idx;
+          continue;
+        }
+
+      size = nxscope_sample_size(s, stage->buf[idx]);
+
+      /* Leave the rest for the next stream frame */
+
+      if (s->stream_i + size + s->proto_stream->footlen > s->streambuf_len)
+        {
+          break;
+        }
+
+      memcpy(&s->streambuf[s->stream_i], &stage->buf[idx], size);
+      s->stream_i += size;
+      tail        += size;
+    }
+
+  atomic_store_explicit(&stage->tail, tail, memory_order_release);
+
+  /* Report samples dropped by the producer */
+
+  overflow = atomic_load_explicit(&stage->overflow, memory_order_relaxed);
+  if (overflow != stage->overflow_seen)
+    {
+      nxscope_stream_overflow(s, overflow - stage->overflow_seen);
+      stage->overflow_seen = overflow;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_stage_merge
+ *
+ * Description:
+ *   Move the samples waiting in the producers staging buffers to the
+ *   stream buffer.
+ *
+ *   NOTE: This function assumes that we have exclusive access to the
+ *         nxscope instance
+ *
+ ****************************************************************************/
+
+void nxscope_stage_merge(FAR struct nxscope_s *s)
+{
+  FAR struct nxscope_stage_s *stage = NULL;
+
+  DEBUGASSERT(s);
+
+  for (stage = s->stage; stage != NULL; stage = stage->next)
+    {
+      nxscope_stage_merge_one(s, stage);
+    }
+}
+
+/****************************************************************************
+ * Name: nxscope_stage_init
+ *
+ * Description:
+ *   Initialize a producer staging buffer and attach it to a nxscope
+ *   instance.
+ *
+ ****************************************************************************/
+
+int nxscope_stage_init(FAR struct nxscope_s *s,
+                       FAR struct nxscope_stage_s *stage, size_t len)
+{
+  size_t ring = 1;
+
+  DEBUGASSERT(s);
+  DEBUGASSERT(stage);
+
+  if (len == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Power of two, so that the free-running counters can wrap */
+
+  while (ring < len)
+    {
+      ring <<= 1;
+    }
+
+  memset(stage, 0, sizeof(struct nxscope_stage_s));
+
+  stage->buf = zalloc(ring);
+  if (stage->buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  stage->s   = s;
+  stage->len = ring;
+  atomic_init(&stage->head, 0);
+  atomic_init(&stage->tail, 0);
+  atomic_init(&stage->overflow, 0);
+
+  nxscope_lock(s);
+  stage->next = s->stage;
+  s->stage    = stage;
+  nxscope_unlock(s);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxscope_stage_deinit
+ *
+ * Description:
+ *   Detach a staging buffer from its nxscope instance and free it.
+ *
+ ****************************************************************************/
+
+void nxscope_stage_deinit(FAR struct nxscope_stage_s *stage)
+{
+  FAR struct nxscope_stage_s **prev = NULL;
+  FAR struct nxscope_s        *s    = NULL;
+
+  DEBUGASSERT(stage);
+
+  s = stage->s;
+  if (s == NULL)
+    {
+      return;
+    }
+
+  nxscope_lock(s);
+
+  for (prev = &s->stage; *prev != NULL; prev = &(*prev)->next)
+    {
+      if (*prev == stage)
+        {
+          *prev = stage->next;
+          break;
+        }
+    }
+
+  nxscope_unlock(s);
+
+  free(stage->buf);
+  memset(stage, 0, sizeof(struct nxscope_stage_s));
+}
+
+/****************************************************************************
+ * Name: nxscope_stage_put_m
+ *
+ * Description:
+ *   Put a sample with metadata on a staging buffer. Never blocks.
+ *
+ ****************************************************************************/
+
+int nxscope_stage_put_m(FAR struct nxscope_stage_s *stage, uint8_t ch,
+                        FAR void *val, uint8_t d,
+                        FAR uint8_t *meta, uint8_t mlen)
+{
+  FAR struct nxscope_s *s     = NULL;
+  size_t                mask  = 0;
+  size_t                head  = 0;
+  size_t                tail  = 0;
+  size_t                size  = 0;
+  size_t                skip  = 0;
+  size_t                idx   = 0;
+  uint8_t               type  = 0;
+  int                   ret   = OK;
+
+  DEBUGASSERT(stage);
+  DEBUGASSERT(stage->s);
+
+  s = stage->s;
+
+  ret = nxscope_stage_validate(s, ch, d, mlen);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  mask = stage->len - 1;
+  size = nxscope_sample_size(s, ch);
+  head = atomic_load_explicit(&stage->head, memory_order_relaxed);
+  tail = atomic_load_explicit(&stage->tail, memory_order_acquire);
+  idx  = head & mask;
+
+  /* Samples are contiguous, skip the end of the ring if needed */
+
+  if (idx + size > stage->len)
+    {
+      skip = stage->len - idx;
+    }
+
+  if (stage->len - (head - tail) < skip + size)
+    {
+      atomic_fetch_add_explicit(&stage->overflow, 1, memory_order_relaxed);
+      return -ENOBUFS;
+    }
+
+  if (skip > 0)
+    {
+      stage->buf[idx] = NXSCOPE_STAGE_WRAP;
+      head           += skip;
+      idx             = 0;
+    }
+
+  type = s->chinfo[ch].type.s.dtype;
+#ifdef CONFIG_LOGGING_NXSCOPE_USERTYPES
+  if (type >= NXSCOPE_TYPE_USER)
+    {
+      type = NXSCOPE_TYPE_USER;
+    }
+#endif
+
+  nxscope_put_sample(stage->buf, &idx, type, ch, val, d, meta, mlen);
+
+  /* Publish the sample */
+
+  atomic_store_explicit(&stage->head, head + size, memory_order_release);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxscope_stage_put
+ ****************************************************************************/
+
+int nxscope_stage_put(FAR struct nxscope_stage_s *stage, uint8_t ch,
+                      FAR void *val, uint8_t d)
+{
+  return nxscope_stage_put_m(stage, ch, val, d, NULL, 0);
+}
@@ -0,0 +1,426 @@
+/****************************************************************************
+ * apps/logging/nxscope/nxscope_trig.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <nuttx/debug.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <logging/nxscope/nxscope.h>
+
+#include "nxscope_internals.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Marker of the unused space at the end of the trigger buffer. Channel IDs
+ * are limited to 254 (chmax is uint8_t), so it never starts a sample.
+ */
+
+#define NXSCOPE_TRIG_WRAP (0xff)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_trig_reset
+ ****************************************************************************/
+
+static void nxscope_trig_reset(FAR struct nxscope_trig_s *trig)
+{
+  trig->state      = NXSCOPE_TRIG_ARMED;
+  trig->fired      = false;
+  trig->prev_valid = false;
+  trig->pre        = 0;
+  trig->post       = 0;
+  trig->head       = 0;
+  trig->tail       = 0;
+  trig->used       = 0;
+}
+
+/****************************************************************************
+ * Name: nxscope_trig_check
+ *
+ * Description:
+ *   Check the trigger condition for a new source value
+ *
+ ****************************************************************************/
+
+static bool nxscope_trig_check(FAR struct nxscope_trig_s *trig, float v)
+{
+  FAR struct nxscope_trig_cfg_s *cfg  = &trig->cfg;
+  float                          prev = trig->prev;
+  bool                           edge = trig->prev_valid;
+
+  switch (cfg->mode)
+    {
+      case NXSCOPE_TRIG_RISING:
+        return edge && prev < cfg->level && v >= cfg->level;
+
+      case NXSCOPE_TRIG_FALLING:
+        return edge && prev > cfg->level && v <= cfg->level;
+
+      case NXSCOPE_TRIG_EDGE:
+        return edge && ((prev < cfg->level && v >= cfg->level) ||
+                        (prev > cfg->level && v <= cfg->level));
+
+      case NXSCOPE_TRIG_ABOVE:
+        return v > cfg->level;
+
+      case NXSCOPE_TRIG_BELOW:
+        return v < cfg->level;
+
+      case NXSCOPE_TRIG_INSIDE:
+        return v >= cfg->level && v <= cfg->level2;
+
+      case NXSCOPE_TRIG_OUTSIDE:
+        return v < cfg->level || v > cfg->level2;
+
+      default:
+        return false;
+    }
+}
+
+/****************************************************************************
+ * Name: nxscope_trig_pop
+ *
+ * Description:
+ *   Remove the oldest sample from the trigger buffer and return its
+ *   offset and size.
+ *
+ ****************************************************************************/
+
+static size_t nxscope_trig_pop(FAR struct nxscope_s *s, FAR size_t *off)
+{
+  FAR struct nxscope_trig_s *trig = &s->trig;
+  size_t                     size = 0;
+
+  if (trig->buf[trig->tail] == NXSCOPE_TRIG_WRAP)
+    {
+      trig->used -= trig->len - trig->tail;
+      trig->tail  = 0;
+    }
+
+  size = nxscope_sample_size(s, trig->buf[trig->tail]);
+  *off = trig->tail;
+
+  trig->used -= size;
+  trig->tail += size;
+  if (trig->tail == trig->len || trig->used == 0)
+    {
+      trig->tail = trig->used == 0 ? trig->head : 0;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Name: nxscope_trig_drop
+ *
+ * Description:
+ *   Drop the oldest sample, keep the count of source samples
+ *
+ ****************************************************************************/
+
+static void nxscope_trig_drop(FAR struct nxscope_s *s)
+{
+  FAR struct nxscope_trig_s *trig = &s->trig;
+  size_t                     off  = 0;
+
+  nxscope_trig_pop(s, &off);
+  if (trig->buf[off] == trig->cfg.chan && trig->pre > 0)
+    {
+      trig->pre--;
+    }
+}
+
+/****************************************************************************
+ * Name: nxscope_trig_store
+ *
+ * Description:
+ *   Store a sample in the trigger buffer. Samples never wrap around the
+ *   buffer end.
+ *
+ ****************************************************************************/
+
+static int nxscope_trig_store(FAR struct nxscope_s *s, uint8_t type,
+                              uint8_t ch, FAR void *val, uint8_t d,
+                              FAR uint8_t *meta, uint8_t mlen)
+{
+  FAR struct nxscope_trig_s *trig = &s->trig;
+  size_t                     size = nxscope_sample_size(s, ch);
+  size_t                     skip = 0;
+
+  if (size > trig->len)
+    {
+      return -ENOBUFS;
+    }
+
+  skip = trig->head + size > trig->len ? trig->len - trig->head : 0;
+
+  /* Make room for pre-trigger samples, captured samples are never
+   * dropped.
+   */
+
+  while (trig->used + skip + size > trig->len)
+    {
+      if (trig->state != NXSCOPE_TRIG_ARMED || trig->used == 0)
+        {
+          return -ENOBUFS;
+        }
+
+      nxscope_trig_drop(s);
+      skip = trig->head + size > trig->len ? trig->len - trig->head : 0;
+    }
+
+  if (skip > 0)
+    {
+      trig->buf[trig->head] = NXSCOPE_TRIG_WRAP;
+      trig->used += skip;
+      trig->head  = 0;
+    }
+
+  nxscope_put_sample(trig->buf, &trig->head, type, ch, val, d, meta, mlen);
+  trig->used += size;
+
+  if (trig->head == trig->len)
+    {
+      trig->head = 0;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxscope_trig_put
+ ****************************************************************************/
+
+int nxscope_trig_put(FAR struct nxscope_s *s, uint8_t type, uint8_t ch,
+                     FAR void *val, uint8_t d,
+                     FAR uint8_t *meta, uint8_t mlen)
+{
+  FAR struct nxscope_trig_s *trig   = &s->trig;
+  bool                       src    = (ch == trig->cfg.chan);
+  bool                       fire   = false;
+  float                      v      = 0;
+  int                        ret    = OK;
+
+  /* Capture sent out or complete */
+
+  if (trig->state == NXSCOPE_TRIG_HOLD || trig->state == NXSCOPE_TRIG_DONE)
+    {
+      return -EAGAIN;
+    }
+
+  if (src)
+    {
+      v = nxscope_val_get(type, val, trig->cfg.idx);
+
+      if (trig->state == NXSCOPE_TRIG_ARMED)
+        {
+          fire = nxscope_trig_check(trig, v);
+        }
+
+      trig->prev       = v;
+      trig->prev_valid = true;
+    }
+
+  ret = nxscope_trig_store(s, type, ch, val, d, meta, mlen);
+  if (ret < 0)
+    {
+      /* Lost a captured sample */
+
+      nxscope_stream_overflow(s, 1);
+      return ret;
+    }
+
+  if (!src)
+    {
+      return OK;
+    }
+
+  if (trig->state == NXSCOPE_TRIG_ARMED)
+    {
+      if (fire)
+        {
+          trig->state = NXSCOPE_TRIG_TRIGGERED;
+          trig->post  = trig->cfg.post;
+          trig->fired = true;
+        }
+      else
+        {
+          /* Keep only the newest pre-trigger source samples */
+
+          trig->pre++;
+          while (trig->pre > trig->cfg.pre && trig->used > 0)
+            {
+              nxscope_trig_drop(s);
+            }
+
+          return OK;
+        }
+    }
+  else if (trig->post > 0)
+    {
+      trig->post--;
+    }
+
+  if (trig->post == 0)
+    {
+      trig->state = trig->cfg.single ? NXSCOPE_TRIG_DONE : NXSCOPE_TRIG_HOLD;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxscope_trig_merge
+ ****************************************************************************/
+
+void nxscope_trig_merge(FAR struct nxscope_s *s)
+{
+  FAR struct nxscope_trig_s *trig = &s->trig;
+  size_t                     size = 0;
+  size_t                     off  = 0;
+
+  DEBUGASSERT(s);
+
+  /* Nothing to send until triggered */
+
+  if (trig->cfg.mode == NXSCOPE_TRIG_OFF ||
+      trig->state == NXSCOPE_TRIG_ARMED)
+    {
+      return;
+    }
+
+  if (trig->fired)
+    {
+      s->streambuf[s->proto_stream->hdrlen] |= NXSCOPE_STREAM_FLAGS_TRIGGER;
+      trig->fired = false;
+    }
+
+  while (trig->used > 0)
+    {
+      /* Leave the rest for the next stream frame */
+
+      off = trig->buf[trig->tail] == NXSCOPE_TRIG_WRAP ? 0 : trig->tail;
+      size = nxscope_sample_size(s, trig->buf[off]);
+      if (s->stream_i + size + s->proto_stream->footlen > s->streambuf_len)
+        {
+          break;
+        }
+
+      nxscope_trig_pop(s, &off);
+      memcpy(&s->streambuf[s->stream_i], &trig->buf[off], size);
+      s->stream_i += size;
+    }
+
+  /* Re-arm when the capture is sent out */
+
+  if (trig->used == 0 && trig->state == NXSCOPE_TRIG_HOLD)
+    {
+      nxscope_trig_reset(trig);
+    }
+}
+
+/****************************************************************************
+ * Name: nxscope_trig_set
+ ****************************************************************************/
+
+int nxscope_trig_set(FAR struct nxscope_s *s,
+                     FAR const struct nxscope_trig_cfg_s *cfg)
+{
+  uint8_t type = 0;
+  int     ret  = OK;
+
+  DEBUGASSERT(s);
+  DEBUGASSERT(cfg);
+
+  nxscope_lock(s);
+
+  if (cfg->mode != NXSCOPE_TRIG_OFF)
+    {
+      if (s->trig.buf == NULL || cfg->mode > NXSCOPE_TRIG_OUTSIDE ||
+          cfg->chan >= s->cmninfo.chmax)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      type = s->chinfo[cfg->chan].type.s.dtype;
+      if (!nxscope_val_isnum(type) ||
+          cfg->idx >= s->chinfo[cfg->chan].vdim)
+        {
+          _err("ERROR: invalid trigger source %d[%d]\n", cfg->chan,
+               cfg->idx);
+          ret = -EINVAL;
+          goto errout;
+        }
+    }
+
+  s->trig.cfg = *cfg;
+  nxscope_trig_reset(&s->trig);
+
+errout:
+  nxscope_unlock(s);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxscope_trig_arm
+ ****************************************************************************/
+
+int nxscope_trig_arm(FAR struct nxscope_s *s)
+{
+  DEBUGASSERT(s);
+
+  nxscope_lock(s);
+  nxscope_trig_reset(&s->trig);
+  nxscope_unlock(s);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxscope_trig_state
+ ****************************************************************************/
+
+int nxscope_trig_state(FAR struct nxscope_s *s)
+{
+  DEBUGASSERT(s);
+
+  return s->trig.state;
+}
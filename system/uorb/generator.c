@@ -64,7 +64,9 @@ generator <command> [arguments...]\n\
   Commands:\n\
 \t<topics_name> The playback topic name.\n\
 \t[-h       ]  Listener commands help.\n\
-\t[-f <val> ]  File path to be played back(absolute path).\n\
+\t[-f <val> ]  File path to be played back(absolute path), text or\
+ binary (recorded by 'uorb_listener -S').\n\
+\t[-F       ]  Play back file as fast as possible, ignore timestamps.\n\
 \t[-n <val> ]  Number of playbacks(fake model), default: 1\n\
 \t[-r <val> ]  The rate for playing fake data is only valid\
  when parameter 's' is used. default:10hz.\n\
@@ -79,6 +81,9 @@ x:0.1,y:9.7,z:0.81,temperature:22.15\n\n\
 pressure:999.12,temperature:26.34\n\n\
 \t\tfiles - sensor_accel1\n\
 \t\t  uorb_generator -f /data/uorb/20240823061723/sensor_accel0.csv\
+ -t sensor_accel1\n\n\
+\t\tbinary files - sensor_accel1\n\
+\t\t  uorb_generator -F -f /data/uorb/20240823061723/sensor_accel0.bin\
  -t sensor_accel1\
 \t\t\n\
   ");
@@ -133,6 +138,96 @@ static int get_play_orb_id(FAR const char *filter,
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: replay_binary_worker
+ *
+ * Description:
+ *   Playback binary data files. The file position must be right after the
+ *   file header. Samples are published at their original (recorded) pace
+ *   unless fast is set, in which case they are published back to back.
+ *
+ * Input Parameters:
+ *   sensor_gen     Generator objects.
+ *   header         Binary file header.
+ *   fast           Ignore timestamps and publish as fast as possible.
+ *
+ * Returned Value:
+ *   0 on success, otherwise -1
+ ****************************************************************************/
+
+static int replay_binary_worker(FAR struct sensor_gen_info_s *sensor_gen,
+                                FAR const struct orb_log_header_s *header,
+                                bool fast)
+{
+  FAR const struct orb_metadata *meta = sensor_gen->obj.meta;
+  orb_abstime first_time = 0;
+  orb_abstime start_time = 0;
+  orb_abstime timestamp;
+  orb_abstime now;
+  FAR uint8_t *data;
+  int ret = OK;
+  int fd;
+
+  if (header->version != ORB_LOG_VERSION ||
+      header->size != meta->o_size ||
+      strncmp(header->name, meta->o_name, sizeof(header->name)) != 0)
+    {
+      uorbinfo_raw("Topic and file do not match!");
+      return -EINVAL;
+    }
+
+  data = zalloc(meta->o_size);
+  if (data == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  setvbuf(sensor_gen->file, NULL, _IOFBF, GENERATOR_CACHE_BUFF);
+
+  fd = orb_advertise_multi_queue_persist(meta, NULL,
+                                         &sensor_gen->obj.instance, 1);
+  if (fd < 0)
+    {
+      uorbinfo_raw("Playback orb advertise failed[%d]!", fd);
+      free(data);
+      return fd;
+    }
+
+  while (!g_gen_should_exit &&
+         fread(&timestamp, sizeof(timestamp), 1, sensor_gen->file) == 1 &&
+         fread(data, meta->o_size, 1, sensor_gen->file) == 1)
+    {
+      if (!fast)
+        {
+          /* Schedule against the first sample, so the sleep granularity
+           * does not accumulate into drift over long logs.
+           */
+
+          now = orb_absolute_time();
+          if (start_time == 0)
+            {
+              first_time = timestamp;
+              start_time = now;
+            }
+          else if (timestamp > first_time + (now - start_time))
+            {
+              nxsig_usleep(timestamp - first_time - (now - start_time));
+            }
+        }
+
+      if (OK != orb_publish(meta, fd, data))
+        {
+          uorbinfo_raw("Topic publish error!");
+          ret = ERROR;
+          break;
+        }
+    }
+
+  orb_unadvertise(fd);
+  free(data);
+  return ret;
+}
+
 /****************************************************************************
  * Name: replay_worker
  *
@@ -141,24 +236,37 @@ static int get_play_orb_id(FAR const char *filter,
  *
  * Input Parameters:
  *   sensor_gen     Generator objects.
+ *   fast           Ignore timestamps and publish as fast as possible.
  *
  * Returned Value:
  *   0 on success, otherwise -1
  ****************************************************************************/
 
-static int replay_worker(FAR struct sensor_gen_info_s *sensor_gen)
+static int replay_worker(FAR struct sensor_gen_info_s *sensor_gen,
+                         bool fast)
 {
+  struct orb_log_header_s header;
   struct lib_meminstream_s meminstream;
+  FAR struct orb_field_s *fields;
   bool is_first = true;
   uint64_t last_time;
   uint64_t tmp_time;
   FAR uint8_t *data;
   FAR char *line;
   int sleep_time;
+  int nfields = 0;
   int lastc;
   int ret;
   int fd;
 
+  if (fread(&header, sizeof(header), 1, sensor_gen->file) == 1 &&
+      memcmp(header.magic, ORB_LOG_MAGIC, sizeof(header.magic)) == 0)
+    {
+      return replay_binary_worker(sensor_gen, &header, fast);
+    }
+
+  rewind(sensor_gen->file);
+
   line = zalloc(GENERATOR_CACHE_BUFF);
   if (line == NULL)
     {
@@ -181,11 +289,22 @@ static int replay_worker(FAR struct sensor_gen_info_s *sensor_gen)
       goto out_line;
     }
 
+  /* Compile the format once instead of interpreting it for every line,
+   * formats the descriptors can't handle are still parsed by lib_bscanf.
+   */
+
+  fields = orb_fields_alloc(sensor_gen->obj.meta, &nfields);
+  if (fields == NULL && errno != EINVAL)
+    {
+      ret = -errno;
+      goto out_line;
+    }
+
   data = zalloc(sensor_gen->obj.meta->o_size);
   if (data == NULL)
     {
       ret = -ENOMEM;
-      goto out_line;
+      goto out_fields;
     }
 
   fd = orb_advertise_multi_queue_persist(sensor_gen->obj.meta,
@@ -200,9 +319,17 @@ static int replay_worker(FAR struct sensor_gen_info_s *sensor_gen)
   while (fgets(line, GENERATOR_CACHE_BUFF, sensor_gen->file) != NULL &&
          !g_gen_should_exit)
     {
-      lib_meminstream(&meminstream, line, GENERATOR_CACHE_BUFF);
-      ret = lib_bscanf(&meminstream.common, &lastc,
-                       sensor_gen->obj.meta->o_format, data);
+      if (fields != NULL)
+        {
+          ret = orb_fields_sscanf(line, fields, nfields, data);
+        }
+      else
+        {
+          lib_meminstream(&meminstream, line, GENERATOR_CACHE_BUFF);
+          ret = lib_bscanf(&meminstream.common, &lastc,
+                           sensor_gen->obj.meta->o_format, data);
+        }
+
       if (ret >= 0)
         {
           tmp_time = *(uint64_t *)data;
@@ -214,7 +341,7 @@ static int replay_worker(FAR struct sensor_gen_info_s *sensor_gen)
           else
             {
               sleep_time = tmp_time - last_time;
-              if (sleep_time > 0)
+              if (sleep_time > 0 && !fast)
                 {
                   nxsig_usleep(sleep_time);
                 }
@@ -240,6 +367,8 @@ static int replay_worker(FAR struct sensor_gen_info_s *sensor_gen)
 
 out_data:
   free(data);
+out_fields:
+  free(fields);
 out_line:
   free(line);
   return ret;
@@ -335,6 +464,7 @@ int main(int argc, FAR char *argv[])
   FAR char *path   = NULL;
   int nb_cycle     = 1;
   bool sim         = false;
+  bool fast        = false;
   int opt;
   int ret;
 
@@ -344,7 +474,7 @@ int main(int argc, FAR char *argv[])
       return 1;
     }
 
-  while ((opt = getopt(argc, argv, "f:t:r:n:sh")) != -1)
+  while ((opt = getopt(argc, argv, "f:Ft:r:n:sh")) != -1)
     {
       switch (opt)
         {
@@ -352,6 +482,10 @@ int main(int argc, FAR char *argv[])
             path = optarg;
             break;
 
+          case 'F':
+            fast = true;
+            break;
+
           case 't':
             topic = optarg;
             break;
@@ -406,7 +540,7 @@ int main(int argc, FAR char *argv[])
           return ERROR;
         }
 
-      ret = replay_worker(&sensor_tmp);
+      ret = replay_worker(&sensor_tmp, fast);
       fclose(sensor_tmp.file);
     }
 
@@ -48,6 +48,15 @@
 #define ORB_MAX_PRINT_NAME 32
 #define ORB_TOP_WAIT_TIME  1000
 #define ORB_DATA_DIR       "/data/uorb/"
+#define ORB_MAX_BATCH      16
+#define ORB_MAX_LINE       1024
+#define ORB_INDEX_BUCKETS  64    /* Topic index hash buckets, power of 2 */
+#define ORB_TOP_RESCAN     10    /* Refreshes between two full rescans */
+#define ORB_TOP_EVENTS     16    /* Topic creation event queue size */
+
+#ifndef CONFIG_UORB_LISTENER_RECORD_BUFSIZE
+#  define CONFIG_UORB_LISTENER_RECORD_BUFSIZE 8192
+#endif
 
 #if defined(CONFIG_DEBUG_UORB) && !defined(CONFIG_LIBC_FLOATINGPOINT)
 #error "Enable CONFIG_LIBC_FLOATINGPOINT, required to see debug output"
@@ -57,17 +66,48 @@
  * Private Types
  ****************************************************************************/
 
+enum listen_record_e
+{
+  LISTENER_RECORD_NONE = 0,  /* Print to the console */
+  LISTENER_RECORD_TEXT,      /* Record "name:value,..." lines */
+  LISTENER_RECORD_JSON,      /* Record one JSON object per line */
+  LISTENER_RECORD_BINARY,    /* Record raw samples */
+};
+
 struct listen_object_s
 {
   SLIST_ENTRY(listen_object_s) node; /* Node of object info list */
+  FAR struct listen_object_s *hnext; /* Next object in the index bucket */
+  unsigned int epoch;       /* Last scan the object was found in */
 
   struct orb_object object; /* Object id */
   orb_abstime timestamp;    /* Time of last generation */
   unsigned long generation; /* Latest generation */
   FAR FILE *file;
+  bool stamped;             /* Samples start with a 64-bit timestamp */
+#ifdef CONFIG_DEBUG_UORB
+  FAR struct orb_field_s *fields; /* Compiled o_format, NULL if unsupported */
+  int nfields;              /* Number of fields */
+#endif
+#ifdef CONFIG_UORB_STATS
+  int fd;                   /* Statistics subscriber */
+  struct orb_stats_s stats; /* Delivery statistics */
+#endif
 };
 
-SLIST_HEAD(listen_list_s, listen_object_s);
+SLIST_HEAD(listen_head_s, listen_object_s);
+
+/* Topic index: the object list plus a hash table on the node name, so that
+ * known topics are found without resolving their metadata again.
+ */
+
+struct listen_list_s
+{
+  struct listen_head_s head;  /* All objects */
+  size_t count;               /* Number of objects */
+  unsigned int epoch;         /* Current scan */
+  FAR struct listen_object_s *index[ORB_INDEX_BUCKETS];
+};
 
 /****************************************************************************
  * Private Function Prototypes
@@ -77,28 +117,41 @@ static int listener_get_state(FAR struct orb_object *object,
                               FAR struct orb_state *state);
 static int listener_add_object(FAR struct listen_list_s *objlist,
                                FAR struct orb_object *object);
+static void listener_delete_object(FAR struct listen_list_s *objlist,
+                                   FAR struct listen_object_s *obj);
 static void listener_delete_object_list(FAR struct listen_list_s *objlist);
 static int listener_generate_object_list(FAR struct listen_list_s *objlist,
                                          FAR const char *filter);
-static int listener_print(FAR const struct orb_metadata *meta, int fd);
+static int listener_print(FAR struct listen_object_s *obj, int fd,
+                          FAR void *buffer, int nb);
 static void listener_monitor(FAR struct listen_list_s *objlist,
                              int nb_objects, float topic_rate,
                              int topic_latency, int nb_msgs,
-                             int timeout, bool record, bool nonwakeup);
+                             int timeout, enum listen_record_e record,
+                             bool nonwakeup);
 static int listener_update(FAR struct listen_list_s *objlist,
                            FAR struct orb_object *object);
 static void listener_top(FAR struct listen_list_s *objlist,
                          FAR const char *filter,
                          bool only_once);
 static int listener_create_dir(FAR char *dir, size_t size);
-static int listener_record(FAR const struct orb_metadata *meta, int fd,
-                           FAR FILE *file);
+static int listener_record(FAR struct listen_object_s *obj, int fd,
+                           FAR void *buffer, int nb, bool json);
+static bool listener_record_stamped(FAR struct listen_object_s *obj);
+static int listener_record_binary(FAR struct listen_object_s *obj, int fd,
+                                  FAR void *buffer, int nb);
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 static bool g_should_exit = false;
+#ifdef CONFIG_DEBUG_UORB
+static char g_line[ORB_MAX_LINE];
+#endif
+#ifdef CONFIG_UORB_STATS
+static bool g_stats = false;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -131,6 +184,8 @@ listener <command> [arguments...]\n\
 \t<topics_name> Topic name. Multi name are separated by ','\n\
 \t[-h       ]  Listener commands help\n\
 \t[-s       ]  Record uorb data to file\n\
+\t[-S       ]  Record uorb data to binary file\n\
+\t[-J       ]  Record uorb data to JSON lines file\n\
 \t[-n <val> ]  Number of messages, default: 0\n\
 \t[-r <val> ]  Subscription rate (unlimited if 0), default: 0\n\
 \t[-b <val> ]  Subscription maximum report latency in us(unlimited if 0),\n\
@@ -141,6 +196,8 @@ listener <command> [arguments...]\n\
 \t[-i       ]  Get sensor device information based on topic.\n\
 \t[-f       ]  Flush sensor drive data.\n\
 \t[-u       ]  Subscribe in non-wakeup mode to save power.\n\
+\t[-d       ]  Delivery statistics (latency, lost samples), with -T\n\
+\t             every topic is subscribed.\n\
   ");
 }
 
@@ -242,11 +299,70 @@ static int listener_get_state(FAR struct orb_object *object,
   return ret;
 }
 
+/****************************************************************************
+ * Name: listener_hash
+ *
+ * Description:
+ *   Hash a topic node name, FNV-1a on the topic name and instance.
+ *
+ * Input Parameters:
+ *   name       Topic name.
+ *   instance   Topic instance.
+ *
+ * Returned Value:
+ *   Index bucket of the node.
+ ****************************************************************************/
+
+static unsigned int listener_hash(FAR const char *name, int instance)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  hash = (hash ^ (uint32_t)instance) * 16777619u;
+  return hash & (ORB_INDEX_BUCKETS - 1);
+}
+
+/****************************************************************************
+ * Name: listener_find_object
+ *
+ * Description:
+ *   Look an object up in the topic index.
+ *
+ * Input Parameters:
+ *   objlist    Topic index.
+ *   name       Topic name.
+ *   instance   Topic instance.
+ *
+ * Returned Value:
+ *   The object, NULL if not indexed.
+ ****************************************************************************/
+
+static FAR struct listen_object_s *
+listener_find_object(FAR struct listen_list_s *objlist,
+                     FAR const char *name, int instance)
+{
+  FAR struct listen_object_s *tmp;
+
+  tmp = objlist->index[listener_hash(name, instance)];
+  while (tmp != NULL && (tmp->object.instance != instance ||
+                         strcmp(tmp->object.meta->o_name, name) != 0))
+    {
+      tmp = tmp->hnext;
+    }
+
+  return tmp;
+}
+
 /****************************************************************************
  * Name: listener_add_object
  *
  * Description:
- *   Alloc object node and add to list.
+ *   Alloc object node and add to list. The object state is sampled on its
+ *   first refresh, so adding never opens the topic node.
  *
  * Input Parameters:
  *   object     Object to add.
@@ -260,8 +376,7 @@ static int listener_add_object(FAR struct listen_list_s *objlist,
                                FAR struct orb_object *object)
 {
   FAR struct listen_object_s *tmp;
-  struct orb_state state;
-  int ret;
+  unsigned int bucket;
 
   tmp = malloc(sizeof(struct listen_object_s));
   if (tmp == NULL)
@@ -269,98 +384,193 @@ static int listener_add_object(FAR struct listen_list_s *objlist,
       return -ENOMEM;
     }
 
-  ret = listener_get_state(object, &state);
   tmp->object.meta     = object->meta;
   tmp->object.instance = object->instance;
-  tmp->timestamp       = orb_absolute_time();
-  tmp->generation      = ret < 0 ? 0 : state.generation;
+  tmp->epoch           = objlist->epoch;
+  tmp->timestamp       = 0;
+  tmp->generation      = 0;
   tmp->file            = NULL;
-  SLIST_INSERT_HEAD(objlist, tmp, node);
+  tmp->stamped         = false;
+#ifdef CONFIG_DEBUG_UORB
+  tmp->fields          = NULL;
+  tmp->nfields         = 0;
+#endif
+#ifdef CONFIG_UORB_STATS
+  tmp->fd              = -1;
+#endif
+
+  bucket = listener_hash(object->meta->o_name, object->instance);
+  tmp->hnext = objlist->index[bucket];
+  objlist->index[bucket] = tmp;
+  SLIST_INSERT_HEAD(&objlist->head, tmp, node);
+  objlist->count++;
   return 0;
 }
 
 /****************************************************************************
- * Name: listener_update
+ * Name: listener_refresh_object
  *
  * Description:
- *   Update object list, print information if given object has new data.
+ *   Sample object state, print information if it has new data.
  *
  * Input Parameters:
- *   object     Object to check state.
- *   objlist    List to update.
+ *   obj        Object to refresh.
  *
  * Returned Value:
- *   0 on success.
+ *   0 on success, otherwise negative errno (the node is gone).
  ****************************************************************************/
 
-static int listener_update(FAR struct listen_list_s *objlist,
-                           FAR struct orb_object *object)
+static int listener_refresh_object(FAR struct listen_object_s *obj)
 {
-  FAR struct listen_object_s *old = NULL;
-  FAR struct listen_object_s *tmp;
+  FAR const struct orb_metadata *meta = obj->object.meta;
+  struct orb_state state;
+  orb_abstime now_time;
+  unsigned long delta_time;
+  unsigned long delta_generation;
   int ret;
 
-  /* Check whether object already exist in old list */
-
-  SLIST_FOREACH(tmp, objlist, node)
+  now_time = orb_absolute_time();
+  ret = listener_get_state(&obj->object, &state);
+  if (ret < 0)
     {
-      if (tmp->object.meta == object->meta &&
-          tmp->object.instance == object->instance)
-        {
-          old = tmp;
-          break;
-        }
+      return ret;
     }
 
-  if (old)
-    {
-      /* If object existed in old list, print and update. */
+  /* First sample, only take the reference */
 
-      struct orb_state state;
-      orb_abstime now_time;
-      unsigned long delta_time;
-      unsigned long delta_generation;
+  if (obj->timestamp == 0)
+    {
+      obj->generation = state.generation;
+      obj->timestamp  = now_time;
+      return 0;
+    }
 
-      now_time = orb_absolute_time();
-      ret = listener_get_state(object, &state);
-      if (ret < 0)
-        {
-          return ret;
-        }
+  delta_time       = now_time - obj->timestamp;
+  delta_generation = state.generation - obj->generation;
+  if (delta_generation && delta_time)
+    {
+      unsigned long frequency;
 
-      delta_time       = now_time - old->timestamp;
-      delta_generation = state.generation - old->generation;
-      if (delta_generation && delta_time)
+      frequency = (state.max_frequency ? state.max_frequency : 1000000)
+                  * delta_generation / delta_time;
+#ifdef CONFIG_UORB_STATS
+      if (g_stats && obj->fd >= 0)
         {
-          unsigned long frequency;
+          FAR struct orb_stats_s *stats = &obj->stats;
 
-          frequency = (state.max_frequency ? state.max_frequency : 1000000)
-                      * delta_generation / delta_time;
+          orb_stats_get(obj->fd, stats);
           uorbinfo_raw("\033[K" "%-*s %2u %4" PRIu32 " %4lu "
-                       "%2" PRIu32 " %4u",
+                       "%2" PRIu32 " %4u %5" PRIu64 " %7" PRIu64
+                       " %7" PRIu64 " %7" PRIu64,
                        ORB_MAX_PRINT_NAME,
-                       object->meta->o_name,
-                       object->instance,
+                       meta->o_name,
+                       obj->object.instance,
                        state.nsubscribers,
                        frequency,
                        state.queue_size,
-                       object->meta->o_size);
-          old->generation = state.generation;
-          old->timestamp  = now_time;
+                       meta->o_size,
+                       stats->lost,
+                       stats->received ?
+                       stats->latency_sum / stats->received : 0,
+                       orb_stats_percentile(stats, 99),
+                       stats->latency_max);
+          orb_stats_init(obj->fd, stats);
         }
+      else
+#endif
+      uorbinfo_raw("\033[K" "%-*s %2u %4" PRIu32 " %4lu "
+                   "%2" PRIu32 " %4u",
+                   ORB_MAX_PRINT_NAME,
+                   meta->o_name,
+                   obj->object.instance,
+                   state.nsubscribers,
+                   frequency,
+                   state.queue_size,
+                   meta->o_size);
+      obj->generation = state.generation;
+      obj->timestamp  = now_time;
     }
-  else
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: listener_update
+ *
+ * Description:
+ *   Update object list, print information if given object has new data.
+ *
+ * Input Parameters:
+ *   object     Object to check state.
+ *   objlist    List to update.
+ *
+ * Returned Value:
+ *   0 on success.
+ ****************************************************************************/
+
+static int listener_update(FAR struct listen_list_s *objlist,
+                           FAR struct orb_object *object)
+{
+  FAR struct listen_object_s *old;
+
+  /* Check whether object already exist in old list */
+
+  old = listener_find_object(objlist, object->meta->o_name,
+                             object->instance);
+  if (old)
     {
-      /* If object not existed in old list, alloc one */
+      /* If object existed in old list, print and update. */
 
-      ret = listener_add_object(objlist, object);
-      if (ret < 0)
-        {
-          return ret;
-        }
+      old->epoch = objlist->epoch;
+      return listener_refresh_object(old);
     }
 
-  return 0;
+  /* If object not existed in old list, alloc one */
+
+  return listener_add_object(objlist, object);
+}
+
+/****************************************************************************
+ * Name: listener_delete_object
+ *
+ * Description:
+ *   Remove an object from the list and free it.
+ *
+ * Input Parameters:
+ *   objlist    List to modify.
+ *   obj        Object to remove.
+ *
+ * Returned Value:
+ *   None.
+ ****************************************************************************/
+
+static void listener_delete_object(FAR struct listen_list_s *objlist,
+                                   FAR struct listen_object_s *obj)
+{
+  FAR struct listen_object_s **prev;
+
+  prev = &objlist->index[listener_hash(obj->object.meta->o_name,
+                                       obj->object.instance)];
+  while (*prev != obj)
+    {
+      prev = &(*prev)->hnext;
+    }
+
+  *prev = obj->hnext;
+  SLIST_REMOVE(&objlist->head, obj, listen_object_s, node);
+  objlist->count--;
+
+#ifdef CONFIG_UORB_STATS
+  if (obj->fd >= 0)
+    {
+      orb_unsubscribe(obj->fd);
+    }
+#endif
+
+#ifdef CONFIG_DEBUG_UORB
+  free(obj->fields);
+#endif
+  free(obj);
 }
 
 /****************************************************************************
@@ -378,16 +588,12 @@ static int listener_update(FAR struct listen_list_s *objlist,
 
 static void listener_delete_object_list(FAR struct listen_list_s *objlist)
 {
-  FAR struct listen_object_s *tmp;
-
-  while (!SLIST_EMPTY(objlist))
+  while (!SLIST_EMPTY(&objlist->head))
     {
-      tmp = SLIST_FIRST(objlist);
-      SLIST_REMOVE_HEAD(objlist, node);
-      free(tmp);
+      listener_delete_object(objlist, SLIST_FIRST(&objlist->head));
     }
 
-  SLIST_INIT(objlist);
+  memset(objlist, 0, sizeof(*objlist));
 }
 
 /****************************************************************************
@@ -408,6 +614,7 @@ static void listener_delete_object_list(FAR struct listen_list_s *objlist)
 static int listener_generate_object_list(FAR struct listen_list_s *objlist,
                                          FAR const char *filter)
 {
+  FAR struct listen_object_s *tmp;
   FAR struct dirent *entry;
   struct orb_object object;
   char name[ORB_PATH_MAX];
@@ -419,7 +626,7 @@ static int listener_generate_object_list(FAR struct listen_list_s *objlist,
 
   if (filter)
     {
-      FAR const char *tmp;
+      FAR const char *end;
       FAR const char *member = filter;
 
       do
@@ -429,15 +636,15 @@ static int listener_generate_object_list(FAR struct listen_list_s *objlist,
               member++;
             }
 
-          tmp = strchr(member, ',');
-          len = tmp ? tmp - member : strlen(member);
+          end = strchr(member, ',');
+          len = end ? end - member : strlen(member);
           if (!len)
             {
               return cnt;
             }
 
           strlcpy(name, member, len + 1);
-          member = tmp;
+          member = end;
           object.meta = orb_get_meta(name);
           if (object.meta)
             {
@@ -465,7 +672,7 @@ static int listener_generate_object_list(FAR struct listen_list_s *objlist,
                 }
             }
         }
-      while (tmp);
+      while (end);
 
       return cnt;
     }
@@ -478,6 +685,8 @@ static int listener_generate_object_list(FAR struct listen_list_s *objlist,
       return 0;
     }
 
+  objlist->epoch++;
+
   while ((entry = readdir(dir)))
     {
       /* Get meta data and instance number through file name */
@@ -510,6 +719,20 @@ static int listener_generate_object_list(FAR struct listen_list_s *objlist,
             }
         }
 
+      /* Known objects are refreshed without resolving the metadata */
+
+      tmp = listener_find_object(objlist, name, object.instance);
+      if (tmp != NULL)
+        {
+          tmp->epoch = objlist->epoch;
+          if (listener_refresh_object(tmp) >= 0)
+            {
+              cnt++;
+            }
+
+          continue;
+        }
+
       object.meta = orb_get_meta(entry->d_name);
       if (!object.meta)
         {
@@ -528,6 +751,22 @@ static int listener_generate_object_list(FAR struct listen_list_s *objlist,
     }
 
   closedir(dir);
+
+  /* Drop the objects whose node disappeared since the previous scan */
+
+  tmp = SLIST_FIRST(&objlist->head);
+  while (tmp != NULL)
+    {
+      FAR struct listen_object_s *next = SLIST_NEXT(tmp, node);
+
+      if (tmp->epoch != objlist->epoch)
+        {
+          listener_delete_object(objlist, tmp);
+        }
+
+      tmp = next;
+    }
+
   return cnt;
 }
 
@@ -535,26 +774,52 @@ static int listener_generate_object_list(FAR struct listen_list_s *objlist,
  * Name: listener_print
  *
  * Description:
- *   Print topic data by its print_message callback.
+ *   Print topic data with its compiled field descriptors.
  *
  * Input Parameters:
- *   meta         The uORB metadata.
+ *   obj          Printed object.
  *   fd           Subscriber handle.
+ *   buffer       Copy buffer, room for nb samples.
+ *   nb           Maximum number of samples to drain.
  *
  * Returned Value:
- *   0 on success copy, otherwise -1
+ *   Number of samples copied on success, otherwise -1
  ****************************************************************************/
 
-static int listener_print(FAR const struct orb_metadata *meta, int fd)
+static int listener_print(FAR struct listen_object_s *obj, int fd,
+                          FAR void *buffer, int nb)
 {
-  char buffer[meta->o_size];
+  FAR const struct orb_metadata *meta = obj->object.meta;
   int ret;
 
-  ret = orb_copy(meta, fd, buffer);
+  ret = orb_copy_batch(meta, fd, buffer, nb);
 #ifdef CONFIG_DEBUG_UORB
-  if (ret == OK && meta->o_format != NULL)
+  if (meta->o_format != NULL)
     {
-      orb_info(meta->o_format, meta->o_name, buffer);
+      FAR const uint8_t *data;
+      int i;
+
+      for (i = 0; i < ret; i++)
+        {
+          data = (FAR const uint8_t *)buffer + i * meta->o_size;
+
+          /* Fall back to the generic formatter for what the descriptors
+           * can't handle.
+           */
+
+          if (obj->fields == NULL ||
+              orb_fields_sprintf(g_line, sizeof(g_line), obj->fields,
+                                 obj->nfields, data,
+                                 ORB_FIELD_FMT_TEXT) >= sizeof(g_line))
+            {
+              orb_info(meta->o_format, meta->o_name, data);
+            }
+          else
+            {
+              printf("%s(now:%" PRIu64 "):%s\n", meta->o_name,
+                     orb_absolute_time(), g_line);
+            }
+        }
     }
 #endif
 
@@ -603,7 +868,7 @@ static void listener_flush_topic(FAR const struct listen_list_s *objlist,
 
   /* Prepare pollfd for all flush objects */
 
-  SLIST_FOREACH(tmp, objlist, node)
+  SLIST_FOREACH(tmp, &objlist->head, node)
     {
       int fd;
 
@@ -622,7 +887,7 @@ static void listener_flush_topic(FAR const struct listen_list_s *objlist,
     }
 
   i = 0;
-  SLIST_FOREACH(tmp, objlist, node)
+  SLIST_FOREACH(tmp, &objlist->head, node)
     {
       ret = orb_flush(fds[i].fd);
       if (ret < 0)
@@ -644,7 +909,7 @@ static void listener_flush_topic(FAR const struct listen_list_s *objlist,
       if (poll(&fds[0], nb_objects, timeout * 1000) > 0)
         {
           i = 0;
-          SLIST_FOREACH(tmp, objlist, node)
+          SLIST_FOREACH(tmp, &objlist->head, node)
             {
               if (fds[i].revents & POLLPRI)
                 {
@@ -672,7 +937,7 @@ static void listener_flush_topic(FAR const struct listen_list_s *objlist,
 
   i = 0;
   uorbinfo_raw("Result:");
-  SLIST_FOREACH(tmp, objlist, node)
+  SLIST_FOREACH(tmp, &objlist->head, node)
     {
       if (result[i] == 0)
         {
@@ -717,7 +982,7 @@ static void listener_print_info(FAR const struct listen_list_s *objlist,
   int ret;
   int fd;
 
-  SLIST_FOREACH(tmp, objlist, node)
+  SLIST_FOREACH(tmp, &objlist->head, node)
     {
       fd = listener_subscribe(tmp, nonwakeup);
       if (fd < 0)
@@ -756,36 +1021,177 @@ static void listener_print_info(FAR const struct listen_list_s *objlist,
  * Name: listener_record
  *
  * Description:
- *   record topic data.
+ *   Record topic data as text or JSON lines.
  *
  * Input Parameters:
- *   meta   The uORB metadata.
+ *   obj    Recorded object.
  *   fd     Subscriber handle.
- *   file   Save file handle.
+ *   buffer Copy buffer, room for nb samples.
+ *   nb     Maximum number of samples to drain.
+ *   json   Record JSON objects instead of "name:value" text.
  *
  * Returned Value:
- *   0 on success copy, otherwise -1
+ *   Number of samples copied on success, otherwise -1
  ****************************************************************************/
 
-static int listener_record(FAR const struct orb_metadata *meta, int fd,
-                           FAR FILE *file)
+static int listener_record(FAR struct listen_object_s *obj, int fd,
+                           FAR void *buffer, int nb, bool json)
 {
-  char buffer[meta->o_size];
+  FAR const struct orb_metadata *meta = obj->object.meta;
   int ret;
 
-  ret = orb_copy(meta, fd, buffer);
+  ret = orb_copy_batch(meta, fd, buffer, nb);
 #ifdef CONFIG_DEBUG_UORB
-  if (ret == OK && meta->o_format != NULL)
+  if (meta->o_format != NULL)
     {
-      ret = orb_fprintf(file, meta->o_format, buffer);
+      FAR const uint8_t *data;
+      int len;
+      int i;
+
+      for (i = 0; i < ret; i++)
+        {
+          data = (FAR const uint8_t *)buffer + i * meta->o_size;
+          len  = -1;
+
+          if (obj->fields != NULL)
+            {
+              len = orb_fields_sprintf(g_line, sizeof(g_line) - 1,
+                                       obj->fields, obj->nfields, data,
+                                       json ? ORB_FIELD_FMT_JSON :
+                                              ORB_FIELD_FMT_TEXT);
+            }
+
+          if (len >= 0 && len < sizeof(g_line) - 1)
+            {
+              g_line[len++] = '\n';
+              if (fwrite(g_line, len, 1, obj->file) != 1)
+                {
+                  return -1;
+                }
+            }
+          else if (json || orb_fprintf(obj->file, meta->o_format, data) < 0 ||
+                   fputc('\n', obj->file) == EOF)
+            {
+              return -1;
+            }
+        }
     }
 #else
-  (void)file;
+  (void)json;
 #endif
 
   return ret;
 }
 
+/****************************************************************************
+ * Name: listener_record_header
+ *
+ * Description:
+ *   Write binary record file header.
+ *
+ * Input Parameters:
+ *   object   Recorded object.
+ *   file     Save file handle.
+ *
+ * Returned Value:
+ *   0 on success, otherwise -1
+ ****************************************************************************/
+
+static int listener_record_header(FAR const struct orb_object *object,
+                                  FAR FILE *file)
+{
+  struct orb_log_header_s header;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, ORB_LOG_MAGIC, sizeof(header.magic));
+  header.version  = ORB_LOG_VERSION;
+  header.size     = object->meta->o_size;
+  header.instance = object->instance;
+  strlcpy(header.name, object->meta->o_name, sizeof(header.name));
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 ? 0 : -1;
+}
+
+/****************************************************************************
+ * Name: listener_record_stamped
+ *
+ * Description:
+ *   Check whether the samples of a topic start with their timestamp, i.e.
+ *   the first field of o_format is a 64-bit "timestamp".
+ *
+ * Input Parameters:
+ *   obj    Recorded object.
+ *
+ * Returned Value:
+ *   True if the first 8 bytes of a sample are its timestamp.
+ ****************************************************************************/
+
+static bool listener_record_stamped(FAR struct listen_object_s *obj)
+{
+#ifdef CONFIG_DEBUG_UORB
+  if (obj->fields != NULL)
+    {
+      return obj->fields[0].offset == 0 &&
+             obj->fields[0].size == sizeof(orb_abstime) &&
+             obj->fields[0].namelen == 9 &&
+             memcmp(obj->fields[0].name, "timestamp", 9) == 0;
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: listener_record_binary
+ *
+ * Description:
+ *   Record topic data as raw binary, each sample prefixed with its own
+ *   timestamp, or with the copy time for topics without one.
+ *
+ * Input Parameters:
+ *   obj    Recorded object.
+ *   fd     Subscriber handle.
+ *   buffer Copy buffer, room for nb samples.
+ *   nb     Maximum number of samples to drain.
+ *
+ * Returned Value:
+ *   Number of samples copied on success, otherwise -1
+ ****************************************************************************/
+
+static int listener_record_binary(FAR struct listen_object_s *obj, int fd,
+                                  FAR void *buffer, int nb)
+{
+  FAR const struct orb_metadata *meta = obj->object.meta;
+  FAR const uint8_t *sample = buffer;
+  orb_abstime timestamp;
+  int ret;
+  int i;
+
+  ret = orb_copy_batch(meta, fd, buffer, nb);
+
+  for (i = 0; i < ret; i++, sample += meta->o_size)
+    {
+      timestamp = 0;
+      if (obj->stamped)
+        {
+          memcpy(&timestamp, sample, sizeof(timestamp));
+        }
+
+      if (timestamp == 0)
+        {
+          timestamp = orb_absolute_time();
+        }
+
+      if (fwrite(&timestamp, sizeof(timestamp), 1, obj->file) != 1 ||
+          fwrite(sample, meta->o_size, 1, obj->file) != 1)
+        {
+          return -1;
+        }
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: listener_monitor
  *
@@ -799,6 +1205,8 @@ static int listener_record(FAR const struct orb_metadata *meta, int fd,
  *   topic_latency  Subscribe report latency.
  *   nb_msgs        Subscribe amount of messages.
  *   timeout        Maximum poll waiting time(microseconds).
+ *   record         Record to files instead of printing.
+ *   nonwakeup      The state of non wakeup
  *
  * Returned Value:
  *   None
@@ -807,13 +1215,21 @@ static int listener_record(FAR const struct orb_metadata *meta, int fd,
 static void listener_monitor(FAR struct listen_list_s *objlist,
                              int nb_objects, float topic_rate,
                              int topic_latency, int nb_msgs,
-                             int timeout, bool record, bool nonwakeup)
+                             int timeout, enum listen_record_e record,
+                             bool nonwakeup)
 {
+  static FAR const char *const suffix[] =
+    {
+      NULL, "csv", "json", "bin"
+    };
+
   FAR struct pollfd *fds;
   char path[PATH_MAX];
   FAR int *recv_msgs;
   float interval = topic_rate ? (1000000 / topic_rate) : 0;
   int nb_recv_msgs = 0;
+  FAR void *buffer;
+  size_t max_size = 0;
   FAR char *dir;
   int i = 0;
 
@@ -832,9 +1248,27 @@ static void listener_monitor(FAR struct listen_list_s *objlist,
       return;
     }
 
+  /* One copy buffer large enough to drain a batch of any object */
+
+  SLIST_FOREACH(tmp, &objlist->head, node)
+    {
+      if (tmp->object.meta->o_size > max_size)
+        {
+          max_size = tmp->object.meta->o_size;
+        }
+    }
+
+  buffer = malloc(max_size * ORB_MAX_BATCH);
+  if (!buffer)
+    {
+      free(recv_msgs);
+      free(fds);
+      return;
+    }
+
   /* Prepare pollfd for all objects */
 
-  SLIST_FOREACH(tmp, objlist, node)
+  SLIST_FOREACH(tmp, &objlist->head, node)
     {
       int fd;
 
@@ -851,6 +1285,20 @@ static void listener_monitor(FAR struct listen_list_s *objlist,
           fds[i].events = POLLIN;
         }
 
+#ifdef CONFIG_UORB_STATS
+      if (g_stats)
+        {
+          orb_stats_init(fd, &tmp->stats);
+        }
+#endif
+
+#ifdef CONFIG_DEBUG_UORB
+      if (tmp->fields == NULL && tmp->object.meta->o_format != NULL)
+        {
+          tmp->fields = orb_fields_alloc(tmp->object.meta, &tmp->nfields);
+        }
+#endif
+
       if (interval != 0)
         {
           orb_set_interval(fd, (unsigned)interval);
@@ -864,22 +1312,34 @@ static void listener_monitor(FAR struct listen_list_s *objlist,
       i++;
     }
 
-  if (record)
+  if (record != LISTENER_RECORD_NONE)
     {
       listener_create_dir(path, sizeof(path));
       dir = path + strlen(path);
 
-      SLIST_FOREACH(tmp, objlist, node)
+      SLIST_FOREACH(tmp, &objlist->head, node)
         {
-          sprintf(dir, "%s%d.csv", tmp->object.meta->o_name,
-                  tmp->object.instance);
+          sprintf(dir, "%s%d.%s", tmp->object.meta->o_name,
+                  tmp->object.instance, suffix[record]);
           tmp->file = fopen(path, "w");
           if (tmp->file != NULL)
             {
+              setvbuf(tmp->file, NULL, _IOFBF,
+                      CONFIG_UORB_LISTENER_RECORD_BUFSIZE);
+
+              if (record == LISTENER_RECORD_BINARY)
+                {
+                  listener_record_header(&tmp->object, tmp->file);
+                  tmp->stamped = listener_record_stamped(tmp);
+                }
 #ifdef CONFIG_DEBUG_UORB
-              fprintf(tmp->file, "%s,%d,%d,%s\n", tmp->object.meta->o_format,
-                      tmp->object.meta->o_size, tmp->object.instance,
-                      tmp->object.meta->o_name);
+              else if (record == LISTENER_RECORD_TEXT)
+                {
+                  fprintf(tmp->file, "%s,%d,%d,%s\n",
+                          tmp->object.meta->o_format,
+                          tmp->object.meta->o_size, tmp->object.instance,
+                          tmp->object.meta->o_name);
+                }
 #endif
 
               uorbinfo_raw("creat file:[%s]", path);
@@ -899,17 +1359,33 @@ static void listener_monitor(FAR struct listen_list_s *objlist,
       if (poll(&fds[0], nb_objects, timeout * 1000) > 0)
         {
           i = 0;
-          SLIST_FOREACH(tmp, objlist, node)
+          SLIST_FOREACH(tmp, &objlist->head, node)
             {
               if (fds[i].revents & POLLIN)
                 {
-                  nb_recv_msgs++;
-                  recv_msgs[i]++;
+                  int nb = ORB_MAX_BATCH;
+                  int ret;
+
+                  if (nb_msgs && nb_msgs - nb_recv_msgs < nb)
+                    {
+                      nb = nb_msgs - nb_recv_msgs;
+                    }
 
                   if (tmp->file != NULL)
                     {
-                      if (listener_record(tmp->object.meta, fds[i].fd,
-                                          tmp->file) < 0)
+                      if (record == LISTENER_RECORD_BINARY)
+                        {
+                          ret = listener_record_binary(tmp, fds[i].fd,
+                                                       buffer, nb);
+                        }
+                      else
+                        {
+                          ret = listener_record(tmp, fds[i].fd, buffer, nb,
+                                                record ==
+                                                LISTENER_RECORD_JSON);
+                        }
+
+                      if (ret < 0)
                         {
                           uorberr("Listener record %s data failed!",
                                   tmp->object.meta->o_name);
@@ -917,12 +1393,26 @@ static void listener_monitor(FAR struct listen_list_s *objlist,
                     }
                   else
                     {
-                      if (listener_print(tmp->object.meta, fds[i].fd) != 0)
+                      ret = listener_print(tmp, fds[i].fd, buffer, nb);
+                      if (ret < 0)
                         {
                           uorberr("Listener callback failed");
                         }
                     }
 
+                  if (ret > 0)
+                    {
+                      nb_recv_msgs += ret;
+                      recv_msgs[i] += ret;
+#ifdef CONFIG_UORB_STATS
+                      if (g_stats)
+                        {
+                          orb_stats_record(&tmp->stats, buffer,
+                                           tmp->object.meta->o_size, ret);
+                        }
+#endif
+                    }
+
                   if (nb_msgs && nb_recv_msgs >= nb_msgs)
                     {
                       break;
@@ -941,7 +1431,7 @@ static void listener_monitor(FAR struct listen_list_s *objlist,
     }
 
   i = 0;
-  SLIST_FOREACH(tmp, objlist, node)
+  SLIST_FOREACH(tmp, &objlist->head, node)
     {
       if (fds[i].fd < 0)
         {
@@ -955,6 +1445,27 @@ static void listener_monitor(FAR struct listen_list_s *objlist,
               orb_set_batch_interval(fds[i].fd, 0);
             }
 
+#ifdef CONFIG_UORB_STATS
+          if (g_stats)
+            {
+              FAR struct orb_stats_s *stats = &tmp->stats;
+
+              orb_stats_get(fds[i].fd, stats);
+              uorbinfo_raw("Object name:%s%d, published:%" PRIu64
+                           ", rate:%" PRIu32 "Hz, lost:%" PRIu64
+                           ", latency(us) min:%" PRIu64 " avg:%" PRIu64
+                           " p50:%" PRIu64 " p99:%" PRIu64 " max:%" PRIu64,
+                           tmp->object.meta->o_name, tmp->object.instance,
+                           stats->published, stats->rate, stats->lost,
+                           stats->received ? stats->latency_min : 0,
+                           stats->received ?
+                           stats->latency_sum / stats->received : 0,
+                           orb_stats_percentile(stats, 50),
+                           orb_stats_percentile(stats, 99),
+                           stats->latency_max);
+            }
+#endif
+
           orb_unsubscribe(fds[i].fd);
           uorbinfo_raw("Object name:%s%d, received:%d",
                        tmp->object.meta->o_name, tmp->object.instance,
@@ -972,64 +1483,302 @@ static void listener_monitor(FAR struct listen_list_s *objlist,
 
   uorbinfo_raw("Total number of received Message:%d/%d",
                nb_recv_msgs, nb_msgs ? nb_msgs : nb_recv_msgs);
+  free(buffer);
   free(fds);
   free(recv_msgs);
 }
 
+#ifdef CONFIG_UORB_TOPIC_EVENTS
 /****************************************************************************
- * Name: listener_top
+ * Name: listener_top_events
  *
  * Description:
- *   Continuously print updating objects, like the unix 'top' command.
- *   Exited when the user presses the enter key.
+ *   Index the topics created since the last call, as reported by the
+ *   orb_topic_event topic.
+ *
+ * Input Parameters:
+ *   objlist    List of objects.
+ *   fd         orb_topic_event subscriber.
+ *   generation Event generation already consumed, updated.
+ *
+ * Returned Value:
+ *   0 on success, -EAGAIN if events were lost and a rescan is needed.
+ ****************************************************************************/
+
+static int listener_top_events(FAR struct listen_list_s *objlist, int fd,
+                               FAR uint64_t *generation)
+{
+  struct orb_topic_event_s events[ORB_TOP_EVENTS];
+  struct orb_object object;
+  struct orb_state state;
+  uint64_t count = 0;
+  size_t len;
+  int ret;
+  int i;
+
+  while ((ret = orb_copy_batch(ORB_ID(orb_topic_event), fd, events,
+                               ORB_TOP_EVENTS)) > 0)
+    {
+      count += ret;
+      for (i = 0; i < ret; i++)
+        {
+          len = strnlen(events[i].name, sizeof(events[i].name));
+          if (len == 0 || len == sizeof(events[i].name))
+            {
+              continue;
+            }
+
+          object.instance = events[i].name[len - 1] - '0';
+          object.meta = orb_get_meta(events[i].name);
+          if (object.meta != NULL &&
+              listener_find_object(objlist, object.meta->o_name,
+                                   object.instance) == NULL)
+            {
+              listener_add_object(objlist, &object);
+            }
+        }
+    }
+
+  /* The queue overflowed if fewer events were read than published */
+
+  if (orb_get_state(fd, &state) < 0 ||
+      state.generation - *generation != count)
+    {
+      *generation = state.generation;
+      return -EAGAIN;
+    }
+
+  *generation = state.generation;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: listener_top_refresh
+ *
+ * Description:
+ *   Refresh the indexed objects without scanning ORB_SENSOR_PATH, drop the
+ *   ones whose node disappeared.
  *
  * Input Parameters:
  *   objlist    List of objects.
- *   filter     Specific topic names.
- *   only_once  Print only once, then exit.
  *
  * Returned Value:
  *   None.
  ****************************************************************************/
 
-static size_t listen_length(FAR struct listen_list_s *objlist)
+static void listener_top_refresh(FAR struct listen_list_s *objlist)
+{
+  FAR struct listen_object_s *tmp;
+  FAR struct listen_object_s *next;
+
+  for (tmp = SLIST_FIRST(&objlist->head); tmp != NULL; tmp = next)
+    {
+      next = SLIST_NEXT(tmp, node);
+      if (listener_refresh_object(tmp) < 0)
+        {
+          listener_delete_object(objlist, tmp);
+        }
+    }
+}
+#endif
+
+#ifdef CONFIG_UORB_STATS
+/****************************************************************************
+ * Name: listener_top_stats_wait
+ *
+ * Description:
+ *   Subscribe objects not yet subscribed, then drain their samples into
+ *   the delivery statistics for one top period.
+ *
+ * Input Parameters:
+ *   objlist    List of objects.
+ *
+ * Returned Value:
+ *   true if the user pressed a key, false otherwise.
+ ****************************************************************************/
+
+static bool listener_top_stats_wait(FAR struct listen_list_s *objlist)
 {
-  struct listen_object_s *tmp;
-  size_t count = 0;
+  FAR struct listen_object_s *tmp;
+  FAR struct pollfd *fds;
+  orb_abstime deadline;
+  orb_abstime now;
+  FAR void *buffer;
+  size_t max_size = 0;
+  bool quit = false;
+  int nfds = 1;
+  int i;
 
-  SLIST_FOREACH(tmp, objlist, node)
+  SLIST_FOREACH(tmp, &objlist->head, node)
     {
-      count++;
+      if (tmp->fd < 0)
+        {
+          tmp->fd = listener_subscribe(tmp, false);
+          if (tmp->fd >= 0)
+            {
+              fcntl(tmp->fd, F_SETFL, fcntl(tmp->fd, F_GETFL) | O_NONBLOCK);
+              orb_stats_init(tmp->fd, &tmp->stats);
+            }
+        }
+
+      if (tmp->object.meta->o_size > max_size)
+        {
+          max_size = tmp->object.meta->o_size;
+        }
+
+      nfds++;
     }
 
-  return count;
+  fds = malloc(nfds * sizeof(struct pollfd));
+  buffer = malloc(max_size * ORB_MAX_BATCH);
+  if (fds == NULL || buffer == NULL)
+    {
+      free(fds);
+      free(buffer);
+      usleep(ORB_TOP_WAIT_TIME * 1000);
+      return false;
+    }
+
+  fds[0].fd     = STDIN_FILENO;
+  fds[0].events = POLLIN;
+
+  i = 1;
+  SLIST_FOREACH(tmp, &objlist->head, node)
+    {
+      fds[i].fd     = tmp->fd;
+      fds[i].events = POLLIN;
+      i++;
+    }
+
+  deadline = orb_absolute_time() + ORB_TOP_WAIT_TIME * 1000;
+  while (!quit && (now = orb_absolute_time()) < deadline)
+    {
+      if (poll(fds, nfds, (deadline - now + 999) / 1000) <= 0)
+        {
+          continue;
+        }
+
+      if (fds[0].revents & POLLIN)
+        {
+          char c;
+
+          quit = read(STDIN_FILENO, &c, 1) > 0;
+        }
+
+      i = 1;
+      SLIST_FOREACH(tmp, &objlist->head, node)
+        {
+          if (fds[i].revents & POLLIN)
+            {
+              int ret;
+
+              ret = orb_copy_batch(tmp->object.meta, tmp->fd, buffer,
+                                   ORB_MAX_BATCH);
+              if (ret > 0)
+                {
+                  orb_stats_record(&tmp->stats, buffer,
+                                   tmp->object.meta->o_size, ret);
+                }
+            }
+
+          i++;
+        }
+    }
+
+  free(fds);
+  free(buffer);
+  return quit;
 }
+#endif
+
+/****************************************************************************
+ * Name: listener_top
+ *
+ * Description:
+ *   Continuously print updating objects, like the unix 'top' command.
+ *   Exited when the user presses the enter key.
+ *
+ * Input Parameters:
+ *   objlist    List of objects.
+ *   filter     Specific topic names.
+ *   only_once  Print only once, then exit.
+ *
+ * Returned Value:
+ *   None.
+ ****************************************************************************/
 
 static void listener_top(FAR struct listen_list_s *objlist,
                          FAR const char *filter,
                          bool only_once)
 {
+  FAR struct listen_object_s *tmp;
   bool quit = false;
   struct pollfd fds;
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+  unsigned int refresh = 0;
+  uint64_t generation = 0;
+  int instance = 0;
+  int evadv = -1;
+  int evfd = -1;
+#endif
 
   fds.fd     = STDIN_FILENO;
   fds.events = POLLIN;
 
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+  /* Without a filter, learn about new topics from creation events and
+   * only rescan ORB_SENSOR_PATH from time to time, for the nodes that
+   * were not created through the uORB library and to drop stale ones.
+   */
+
+  if (filter == NULL && !only_once)
+    {
+      struct orb_state state;
+
+      evadv = orb_advertise_multi_queue(ORB_ID(orb_topic_event), NULL,
+                                        &instance, ORB_TOP_EVENTS);
+      evfd = orb_subscribe(ORB_ID(orb_topic_event));
+      if (evfd >= 0)
+        {
+          fcntl(evfd, F_SETFL, fcntl(evfd, F_GETFL) | O_NONBLOCK);
+          if (orb_get_state(evfd, &state) >= 0)
+            {
+              generation = state.generation;
+            }
+        }
+    }
+#endif
+
+  /* Take the reference state of the objects found so far */
+
+  SLIST_FOREACH(tmp, &objlist->head, node)
+    {
+      listener_refresh_object(tmp);
+    }
+
   uorbinfo_raw("\033[2J\n"); /* clear screen */
 
   do
     {
       /* Wait a while, quit if user input some thing */
 
+#ifdef CONFIG_UORB_STATS
+      if (g_stats)
+        {
+          quit = listener_top_stats_wait(objlist);
+        }
+      else
+#endif
       if (poll(&fds, 1, ORB_TOP_WAIT_TIME) > 0)
         {
           char c;
 
-          if (read(STDIN_FILENO, &c, 1) > 0)
-            {
-              quit = true;
-              break;
-            }
+          quit = read(STDIN_FILENO, &c, 1) > 0;
+        }
+
+      if (quit)
+        {
+          break;
         }
 
       /* Then Update object list and print changes. */
@@ -1039,14 +1788,31 @@ static void listener_top(FAR struct listen_list_s *objlist,
           uorbinfo_raw("\033[H"); /* move cursor to top left corner */
         }
 
-      uorbinfo_raw("\033[K" "current objects: %zu", listen_length(objlist));
+      uorbinfo_raw("\033[K" "current objects: %zu", objlist->count);
+#ifdef CONFIG_UORB_STATS
+      if (g_stats)
+        {
+          uorbinfo_raw("\033[K" "%-*s INST #SUB RATE #Q SIZE  LOST "
+                       "LAT_AVG LAT_P99 LAT_MAX",
+                       ORB_MAX_PRINT_NAME - 2, "NAME");
+        }
+      else
+#endif
       uorbinfo_raw("\033[K" "%-*s INST #SUB RATE #Q SIZE",
                    ORB_MAX_PRINT_NAME - 2, "NAME");
 
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+      if (evfd >= 0 && refresh++ % ORB_TOP_RESCAN != 0 &&
+          listener_top_events(objlist, evfd, &generation) >= 0)
+        {
+          listener_top_refresh(objlist);
+        }
+      else
+#endif
       if (listener_generate_object_list(objlist, filter) < 0)
         {
           uorberr("Failed to update object list");
-          return;
+          break;
         }
 
       if (!only_once)
@@ -1055,6 +1821,18 @@ static void listener_top(FAR struct listen_list_s *objlist,
         }
     }
   while (!quit && !only_once);
+
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+  if (evfd >= 0)
+    {
+      orb_unsubscribe(evfd);
+    }
+
+  if (evadv >= 0)
+    {
+      orb_unadvertise(evadv);
+    }
+#endif
 }
 
 static void exit_handler(int signo)
@@ -1078,7 +1856,7 @@ int main(int argc, FAR char *argv[])
   bool top          = false;
   bool info         = false;
   bool flush        = false;
-  bool record       = false;
+  enum listen_record_e record = LISTENER_RECORD_NONE;
   bool nonwakeup    = false;
   bool only_once    = false;
   FAR char *filter  = NULL;
@@ -1086,6 +1864,10 @@ int main(int argc, FAR char *argv[])
   int ch;
 
   g_should_exit = false;
+#ifdef CONFIG_UORB_STATS
+  g_stats = false;
+#endif
+
   if (signal(SIGINT, exit_handler) == SIG_ERR)
     {
       return 1;
@@ -1093,7 +1875,7 @@ int main(int argc, FAR char *argv[])
 
   /* Pasrse Argument */
 
-  while ((ch = getopt(argc, argv, "r:b:n:t:Tfslhiu")) != EOF)
+  while ((ch = getopt(argc, argv, "r:b:n:t:TfsSJlhiud")) != EOF)
     {
       switch (ch)
       {
@@ -1131,10 +1913,18 @@ int main(int argc, FAR char *argv[])
 
 #ifdef CONFIG_DEBUG_UORB
         case 's':
-          record = true;
+          record = LISTENER_RECORD_TEXT;
+          break;
+
+        case 'J':
+          record = LISTENER_RECORD_JSON;
           break;
 #endif
 
+        case 'S':
+          record = LISTENER_RECORD_BINARY;
+          break;
+
         case 'f':
           flush = true;
           break;
@@ -1155,6 +1945,12 @@ int main(int argc, FAR char *argv[])
           nonwakeup = true;
           break;
 
+#ifdef CONFIG_UORB_STATS
+        case 'd':
+          g_stats = true;
+          break;
+#endif
+
         case 'h':
         default:
           goto error;
@@ -1168,7 +1964,7 @@ int main(int argc, FAR char *argv[])
 
   /* Alloc list and exec command */
 
-  SLIST_INIT(&objlist);
+  memset(&objlist, 0, sizeof(objlist));
   ret = listener_generate_object_list(&objlist, filter);
   if (ret <= 0)
     {
@@ -1194,7 +1990,7 @@ int main(int argc, FAR char *argv[])
   else
     {
       uorbinfo_raw("\nMonitor objects num:%d", ret);
-      SLIST_FOREACH(tmp, &objlist, node)
+      SLIST_FOREACH(tmp, &objlist.head, node)
         {
           uorbinfo_raw("object_name:%s, object_instance:%d",
                        tmp->object.meta->o_name,
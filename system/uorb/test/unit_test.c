@@ -34,6 +34,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <sched.h>
+#include <stddef.h>
 #include <pthread.h>
 
 #include "utility.h"
@@ -799,6 +800,7 @@ int test_queue(void)
 {
   const int queue_size  = 16;
   const int overflow_by = 3;
+  struct orb_test_medium_s batch[16];
   struct orb_test_medium_s sample;
   struct orb_test_medium_s sub_sample;
   bool updated;
@@ -940,6 +942,38 @@ int test_queue(void)
   CHECK_UPDATED(-1);
   CHECK_COPY(sub_sample.val, sample.val);
 
+  test_note("  Testing batch copy...");
+
+  for (i = 0; i < queue_size - 2; ++i)
+    {
+      sample.val = i;
+      orb_publish(ORB_ID(orb_test_medium_queue), ptopic, &sample);
+    }
+
+  ret = orb_copy_batch(ORB_ID(orb_test_medium_queue), sfd, batch,
+                       queue_size);
+  if (ret != queue_size - 2)
+    {
+      test_fail("batch copy got %d elements, should be %d",
+                ret, queue_size - 2);
+      ret = ERROR;
+      goto out;
+    }
+
+  for (i = 0; i < queue_size - 2; ++i)
+    {
+      if (batch[i].val != i)
+        {
+          test_fail("got wrong element from the batch (got %i,"
+                    "should be %i)", batch[i].val, i);
+          ret = ERROR;
+          goto out;
+        }
+    }
+
+  ret = ERROR;
+  CHECK_NOT_UPDATED(queue_size);
+
 #undef CHECK_COPY
 #undef CHECK_UPDATED
 #undef CHECK_NOT_UPDATED
@@ -1103,6 +1137,219 @@ static int test_queue_poll_notify(void)
   return OK;
 }
 
+#ifdef CONFIG_DEBUG_UORB
+static int test_fields(void)
+{
+  struct orb_test_s sample;
+  struct orb_test_s parsed;
+  FAR struct orb_field_s *fields;
+  char line[64];
+  int nfields;
+  int ret;
+
+  test_note("try compiled field descriptors");
+
+  fields = orb_fields_alloc(ORB_ID(orb_test), &nfields);
+  if (fields == NULL || nfields != 2 ||
+      fields[1].offset != offsetof(struct orb_test_s, val))
+    {
+      free(fields);
+      return test_fail("orb_fields_alloc failed");
+    }
+
+  sample.timestamp = 1234567;
+  sample.val       = -42;
+  orb_fields_sprintf(line, sizeof(line), fields, nfields, &sample,
+                     ORB_FIELD_FMT_TEXT);
+  if (strcmp(line, "timestamp:1234567,val:-42") != 0)
+    {
+      free(fields);
+      return test_fail("orb_fields_sprintf wrong output: %s", line);
+    }
+
+  memset(&parsed, 0, sizeof(parsed));
+  ret = orb_fields_sscanf(line, fields, nfields, &parsed);
+  free(fields);
+  if (ret != nfields || parsed.timestamp != sample.timestamp ||
+      parsed.val != sample.val)
+    {
+      return test_fail("orb_fields_sscanf mismatch");
+    }
+
+  return test_note("PASS compiled field descriptors");
+}
+#endif
+
+#ifdef CONFIG_UORB_SHM
+static int test_shm(void)
+{
+  const int queue_size = 8;
+  static struct orb_test_shm_s sample;
+  FAR const struct orb_test_shm_s *sub_sample;
+  struct orb_shm_s pub;
+  struct orb_shm_s sub;
+  uint32_t seq;
+  int ret = ERROR;
+  int lost;
+  int i;
+
+  test_note("Testing orb shared memory topic");
+
+  if (orb_shm_advertise(&pub, ORB_ID(orb_test_shm), 0, queue_size) < 0)
+    {
+      return test_fail("shm advertise failed");
+    }
+
+  if (orb_shm_subscribe(&sub, ORB_ID(orb_test_shm), 0) < 0)
+    {
+      orb_shm_close(&pub);
+      return test_fail("shm subscribe failed");
+    }
+
+  if (orb_shm_borrow(&sub, (FAR const void **)&sub_sample, NULL) != -EAGAIN)
+    {
+      test_fail("spurious shm sample");
+      goto out;
+    }
+
+  /* Publish in place and read back without copy */
+
+  for (i = 0; i < queue_size / 2; i++)
+    {
+      FAR struct orb_test_shm_s *slot = orb_shm_reserve(&pub);
+
+      slot->timestamp = orb_absolute_time();
+      slot->val       = i;
+      if (orb_shm_commit(&pub) != OK)
+        {
+          test_fail("shm commit failed: %d", errno);
+          goto out;
+        }
+    }
+
+  for (i = 0; i < queue_size / 2; i++)
+    {
+      if (orb_shm_borrow(&sub, (FAR const void **)&sub_sample, &seq) != 0)
+        {
+          test_fail("shm borrow(%d) failed", i);
+          goto out;
+        }
+
+      if (sub_sample->val != i || seq != i)
+        {
+          test_fail("shm borrow mismatch: %d/%" PRIu32 " expected %d",
+                    sub_sample->val, seq, i);
+          goto out;
+        }
+
+      orb_shm_release(&sub);
+    }
+
+  /* Overrun the subscriber, the oldest intact sample must be returned
+   * with the right number of lost samples.
+   */
+
+  for (i = 0; i < queue_size * 2; i++)
+    {
+      sample.val = i;
+      orb_shm_publish(&pub, &sample);
+    }
+
+  lost = orb_shm_borrow(&sub, (FAR const void **)&sub_sample, NULL);
+  if (lost != queue_size + 1 || sub_sample->val != queue_size + 1)
+    {
+      test_fail("shm overrun mismatch: lost %d val %d", lost,
+                sub_sample->val);
+      goto out;
+    }
+
+  orb_shm_release(&sub);
+  ret = OK;
+
+out:
+  orb_shm_close(&sub);
+  orb_shm_close(&pub);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: shm_bench
+ *
+ * Description:
+ *   Compare the cost of passing large samples through the regular
+ *   publish/copy path and through the shared memory borrow path.
+ ****************************************************************************/
+
+static int shm_bench(int count)
+{
+  static struct orb_test_shm_s sample;
+  static struct orb_test_shm_s sub_sample;
+  FAR const struct orb_test_shm_s *ptr;
+  struct orb_shm_s pub;
+  struct orb_shm_s sub;
+  orb_abstime start;
+  orb_abstime copy_time;
+  orb_abstime shm_time;
+  int32_t sum = 0;
+  int instance = 0;
+  int afd;
+  int sfd;
+  int i;
+
+  test_note("---------------- SHM BENCHMARK ------------------");
+
+  afd = orb_advertise_multi_queue(ORB_ID(orb_test_shm), NULL, &instance, 1);
+  sfd = orb_subscribe(ORB_ID(orb_test_shm));
+  if (afd < 0 || sfd < 0)
+    {
+      return test_fail("advertise/subscribe failed: %d", errno);
+    }
+
+  start = orb_absolute_time();
+  for (i = 0; i < count; i++)
+    {
+      sample.val = i;
+      orb_publish(ORB_ID(orb_test_shm), afd, &sample);
+      orb_copy(ORB_ID(orb_test_shm), sfd, &sub_sample);
+      sum += sub_sample.val;
+    }
+
+  copy_time = orb_elapsed_time(&start);
+  orb_unsubscribe(sfd);
+  orb_unadvertise(afd);
+
+  if (orb_shm_advertise(&pub, ORB_ID(orb_test_shm), 1, 4) < 0 ||
+      orb_shm_subscribe(&sub, ORB_ID(orb_test_shm), 1) < 0)
+    {
+      return test_fail("shm advertise/subscribe failed");
+    }
+
+  start = orb_absolute_time();
+  for (i = 0; i < count; i++)
+    {
+      FAR struct orb_test_shm_s *slot = orb_shm_reserve(&pub);
+
+      slot->val = i;
+      orb_shm_commit(&pub);
+      orb_shm_borrow(&sub, (FAR const void **)&ptr, NULL);
+      sum -= ptr->val;
+      orb_shm_release(&sub);
+    }
+
+  shm_time = orb_elapsed_time(&start);
+  orb_shm_close(&sub);
+  orb_shm_close(&pub);
+
+  printf("%d samples of %zu bytes\n", count, sizeof(sample));
+  printf("copy: %" PRIu64 " us total, %" PRIu64 " ns/sample\n",
+         copy_time, copy_time * 1000 / count);
+  printf("shm:  %" PRIu64 " us total, %" PRIu64 " ns/sample\n",
+         shm_time, shm_time * 1000 / count);
+
+  return sum == 0 ? OK : test_fail("shm benchmark data mismatch");
+}
+#endif
+
 static int test(void)
 {
   int afds[4];
@@ -1151,7 +1398,26 @@ static int test(void)
       return ret;
     }
 
-  return test_queue_poll_notify();
+  ret = test_queue_poll_notify();
+#ifdef CONFIG_DEBUG_UORB
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  ret = test_fields();
+#endif
+
+#ifdef CONFIG_UORB_SHM
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  ret = test_shm();
+#endif
+
+  return ret;
 }
 
 int main(int argc, FAR char *argv[])
@@ -1179,6 +1445,17 @@ int main(int argc, FAR char *argv[])
       return latency_test(true);
     }
 
+#ifdef CONFIG_UORB_SHM
+  /* Compare copy and shared memory paths. */
+
+  if (argc > 1 && !strcmp(argv[1], "shm_bench"))
+    {
+      return shm_bench(argc > 2 ? atoi(argv[2]) : 10000);
+    }
+
+  printf("Usage: uorb_tests [latency_test|shm_bench [count]]\n");
+#else
   printf("Usage: uorb_tests [latency_test]\n");
+#endif
   return -EINVAL;
 }
@@ -52,6 +52,7 @@ ORB_DEFINE(orb_test_medium_queue, struct orb_test_medium_s, orb_test_format);
 ORB_DEFINE(orb_test_medium_queue_poll, struct orb_test_medium_s,
            orb_test_format);
 ORB_DEFINE(orb_test_large, struct orb_test_large_s, orb_test_format);
+ORB_DEFINE(orb_test_shm, struct orb_test_shm_s, orb_test_format);
 
 /****************************************************************************
  * Public Functions
@@ -51,6 +51,13 @@ struct orb_test_large_s
   int32_t val;
 };
 
+struct orb_test_shm_s
+{
+  uint64_t timestamp;
+  int32_t val;
+  uint8_t payload[1024];
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -65,6 +72,7 @@ ORB_DECLARE(orb_test_medium_multi);
 ORB_DECLARE(orb_test_medium_wrap_around);
 ORB_DECLARE(orb_test_medium_queue);
 ORB_DECLARE(orb_test_medium_queue_poll);
+ORB_DECLARE(orb_test_shm);
 
 /****************************************************************************
  * Public Function Prototypes
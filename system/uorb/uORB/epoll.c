@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <errno.h>
+#include <limits.h>
 #include <unistd.h>
 #include <sys/epoll.h>
 
@@ -56,6 +57,41 @@ const struct orb_loop_ops_s g_orb_loop_epoll_ops =
  * Private Functions
  ****************************************************************************/
 
+static inline int orb_loop_epoll_priority(FAR struct epoll_event *et)
+{
+  FAR struct orb_handle_s *handle = et->data.ptr;
+
+  return handle != NULL ? handle->priority : INT_MIN;
+}
+
+/****************************************************************************
+ * Name: orb_loop_epoll_sort
+ *
+ * Description:
+ *   Order ready events by decreasing handle priority. Insertion sort: the
+ *   array is at most CONFIG_UORB_LOOP_MAX_EVENTS long and usually already
+ *   sorted, and it keeps the backend order for equal priorities.
+ ****************************************************************************/
+
+static void orb_loop_epoll_sort(FAR struct epoll_event *et, int nfds)
+{
+  struct epoll_event tmp;
+  int i;
+  int j;
+
+  for (i = 1; i < nfds; i++)
+    {
+      tmp = et[i];
+      for (j = i; j > 0 && orb_loop_epoll_priority(&et[j - 1]) <
+                           orb_loop_epoll_priority(&tmp); j--)
+        {
+          et[j] = et[j - 1];
+        }
+
+      et[j] = tmp;
+    }
+}
+
 static int orb_loop_epoll_init(FAR struct orb_loop_s *loop)
 {
   loop->fd = epoll_create1(EPOLL_CLOEXEC);
@@ -82,6 +118,8 @@ static int orb_loop_epoll_run(FAR struct orb_loop_s *loop)
           return -errno;
         }
 
+      orb_loop_epoll_sort(et, nfds);
+
       for (i = 0; i < nfds; i++)
         {
           handle = et[i].data.ptr;
@@ -96,6 +134,17 @@ static int orb_loop_epoll_run(FAR struct orb_loop_s *loop)
 
           if (et[i].events & EPOLLIN)
             {
+              /* Timer and event handles own a counter fd, consume it so
+               * the callback sees the number of expirations / events.
+               */
+
+              if (handle->type != ORB_HANDLE_TOPIC &&
+                  read(handle->fd, &handle->count,
+                       sizeof(handle->count)) < 0)
+                {
+                  continue;
+                }
+
               if (handle->datain_cb != NULL)
                 {
                   handle->datain_cb(handle, handle->arg);
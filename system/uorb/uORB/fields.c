@@ -0,0 +1,550 @@
+/****************************************************************************
+ * apps/system/uorb/uORB/fields.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <uORB/uORB.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Alignment of a member of the given type inside a structure, which is
+ * what the topic layout (and o_format) follows.
+ */
+
+#define ORB_FIELD_ALIGNOF(type) offsetof(struct { char c; type v; }, v)
+
+/* Floats up to this magnitude are printed with the fixed point fast path */
+
+#define ORB_FIELD_FIXED_MAX     9e12
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct orb_field_out_s
+{
+  FAR char *buf;                /* Output buffer */
+  size_t    size;               /* Output buffer size */
+  size_t    len;                /* Length that would have been written */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static size_t orb_field_align(size_t size, bool real)
+{
+  if (real)
+    {
+      return size == sizeof(float) ? ORB_FIELD_ALIGNOF(float) :
+                                     ORB_FIELD_ALIGNOF(double);
+    }
+
+  switch (size)
+    {
+      case 1:
+        return 1;
+
+      case 2:
+        return ORB_FIELD_ALIGNOF(int16_t);
+
+      case 4:
+        return ORB_FIELD_ALIGNOF(int32_t);
+
+      default:
+        return ORB_FIELD_ALIGNOF(int64_t);
+    }
+}
+
+static void orb_field_putc(FAR struct orb_field_out_s *out, char c)
+{
+  if (out->len + 1 < out->size)
+    {
+      out->buf[out->len] = c;
+    }
+
+  out->len++;
+}
+
+static void orb_field_puts(FAR struct orb_field_out_s *out,
+                           FAR const char *str, size_t len)
+{
+  while (len-- > 0)
+    {
+      orb_field_putc(out, *str++);
+    }
+}
+
+static void orb_field_putu(FAR struct orb_field_out_s *out, uint64_t value,
+                           unsigned int base, int width)
+{
+  char digits[24];
+  int i = 0;
+
+  do
+    {
+      digits[i++] = "0123456789abcdef"[value % base];
+      value /= base;
+    }
+  while (value != 0 || i < width);
+
+  while (i > 0)
+    {
+      orb_field_putc(out, digits[--i]);
+    }
+}
+
+static void orb_field_putf(FAR struct orb_field_out_s *out, double value,
+                           bool json)
+{
+  uint64_t scaled;
+
+  if (value != value || value > ORB_FIELD_FIXED_MAX ||
+      value < -ORB_FIELD_FIXED_MAX)
+    {
+      char tmp[32];
+
+      /* NaN, infinities and huge values: not worth a fast path */
+
+      if (json && (value != value || value - value != 0))
+        {
+          orb_field_puts(out, "null", 4);
+        }
+      else
+        {
+          orb_field_puts(out, tmp, snprintf(tmp, sizeof(tmp), "%g", value));
+        }
+
+      return;
+    }
+
+  if (value < 0)
+    {
+      orb_field_putc(out, '-');
+      value = -value;
+    }
+
+  /* Same precision as the default "%f" used by o_format */
+
+  scaled = (uint64_t)(value * 1000000.0 + 0.5);
+  orb_field_putu(out, scaled / 1000000, 10, 1);
+  orb_field_putc(out, '.');
+  orb_field_putu(out, scaled % 1000000, 10, 6);
+}
+
+static void orb_field_put(FAR struct orb_field_out_s *out,
+                          FAR const struct orb_field_s *field,
+                          FAR const uint8_t *data, bool json)
+{
+  union
+    {
+      int8_t   i8;
+      int16_t  i16;
+      int32_t  i32;
+      int64_t  i64;
+      float    f;
+      double   d;
+    } u;
+
+  uint64_t value;
+
+  memcpy(&u, data + field->offset, field->size);
+
+  if (field->type == ORB_FIELD_FLOAT)
+    {
+      orb_field_putf(out, field->size == sizeof(float) ? u.f : u.d, json);
+      return;
+    }
+
+  switch (field->size)
+    {
+      case 1:
+        value = field->type == ORB_FIELD_INT ? (uint64_t)u.i8 :
+                                                (uint8_t)u.i8;
+        break;
+
+      case 2:
+        value = field->type == ORB_FIELD_INT ? (uint64_t)u.i16 :
+                                                (uint16_t)u.i16;
+        break;
+
+      case 4:
+        value = field->type == ORB_FIELD_INT ? (uint64_t)u.i32 :
+                                                (uint32_t)u.i32;
+        break;
+
+      default:
+        value = u.i64;
+        break;
+    }
+
+  if (field->type == ORB_FIELD_INT && (int64_t)value < 0)
+    {
+      orb_field_putc(out, '-');
+      value = -value;
+    }
+
+  if (field->type == ORB_FIELD_HEX)
+    {
+      /* JSON has no hexadecimal numbers, quote them */
+
+      if (json)
+        {
+          orb_field_putc(out, '"');
+        }
+
+      orb_field_puts(out, "0x", 2);
+      orb_field_putu(out, value, 16, 1);
+      if (json)
+        {
+          orb_field_putc(out, '"');
+        }
+    }
+  else
+    {
+      orb_field_putu(out, value, 10, 1);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int orb_fields_parse(FAR const char *format, FAR struct orb_field_s *fields,
+                     int nfields)
+{
+  FAR const char *segment = format;
+  FAR const char *colon;
+  size_t offset = 0;
+  int count = 0;
+
+  if (format == NULL)
+    {
+      return -EINVAL;
+    }
+
+  while ((format = strchr(format, '%')) != NULL)
+    {
+      struct orb_field_s field;
+      size_t size = sizeof(int);
+      size_t align;
+      bool half = false;
+
+      format++;
+      if (*format == '%')
+        {
+          format++;
+          continue;
+        }
+
+      /* Length modifier */
+
+      switch (*format)
+        {
+          case 'h':
+            half = true;
+            size = sizeof(short);
+            if (*++format == 'h')
+              {
+                size = sizeof(char);
+                format++;
+              }
+            break;
+
+          case 'l':
+            size = sizeof(long);
+            if (*++format == 'l')
+              {
+                size = sizeof(long long);
+                format++;
+              }
+            break;
+
+          case 'j':
+            size = sizeof(intmax_t);
+            format++;
+            break;
+
+          case 'z':
+            size = sizeof(size_t);
+            format++;
+            break;
+
+          default:
+            break;
+        }
+
+      /* Conversion, "%hf" is a float and "%f" a double, as in o_format */
+
+      switch (*format)
+        {
+          case 'd':
+          case 'i':
+            field.type = ORB_FIELD_INT;
+            break;
+
+          case 'u':
+          case 'o':
+            field.type = ORB_FIELD_UINT;
+            break;
+
+          case 'x':
+          case 'X':
+            field.type = ORB_FIELD_HEX;
+            break;
+
+          case 'f':
+          case 'e':
+          case 'g':
+            field.type = ORB_FIELD_FLOAT;
+            size = half ? sizeof(float) : sizeof(double);
+            break;
+
+          default:
+            return -EINVAL;
+        }
+
+      format++;
+
+      /* The name is what precedes ':' in this comma separated segment */
+
+      while (*segment == ',')
+        {
+          segment++;
+        }
+
+      colon = memchr(segment, ':', format - segment);
+      field.name    = segment;
+      field.namelen = colon != NULL ? colon - segment : 0;
+      segment       = format;
+
+      align         = orb_field_align(size, field.type == ORB_FIELD_FLOAT);
+      offset        = (offset + align - 1) & ~(align - 1);
+      field.size    = size;
+      field.offset  = offset;
+      offset       += size;
+
+      if (fields != NULL)
+        {
+          if (count >= nfields)
+            {
+              return -ENOSPC;
+            }
+
+          fields[count] = field;
+        }
+
+      count++;
+    }
+
+  return count;
+}
+
+FAR struct orb_field_s *orb_fields_alloc(FAR const struct orb_metadata *meta,
+                                         FAR int *nfields)
+{
+  FAR struct orb_field_s *fields;
+  int ret;
+
+  ret = orb_fields_parse(meta->o_format, NULL, 0);
+  if (ret <= 0)
+    {
+      errno = ret < 0 ? -ret : EINVAL;
+      return NULL;
+    }
+
+  fields = malloc(ret * sizeof(struct orb_field_s));
+  if (fields == NULL)
+    {
+      errno = ENOMEM;
+      return NULL;
+    }
+
+  *nfields = orb_fields_parse(meta->o_format, fields, ret);
+
+  /* A format that doesn't match the structure would read past the end of
+   * the sample.
+   */
+
+  if (fields[ret - 1].offset + fields[ret - 1].size > meta->o_size)
+    {
+      free(fields);
+      errno = EINVAL;
+      return NULL;
+    }
+
+  return fields;
+}
+
+int orb_fields_sprintf(FAR char *buf, size_t size,
+                       FAR const struct orb_field_s *fields, int nfields,
+                       FAR const void *data, enum orb_field_fmt_e fmt)
+{
+  struct orb_field_out_s out;
+  bool json = fmt == ORB_FIELD_FMT_JSON;
+  int i;
+
+  out.buf  = buf;
+  out.size = size;
+  out.len  = 0;
+
+  if (json)
+    {
+      orb_field_putc(&out, '{');
+    }
+
+  for (i = 0; i < nfields; i++)
+    {
+      if (i > 0)
+        {
+          orb_field_putc(&out, ',');
+        }
+
+      if (json)
+        {
+          orb_field_putc(&out, '"');
+          orb_field_puts(&out, fields[i].name, fields[i].namelen);
+          orb_field_puts(&out, "\":", 2);
+        }
+      else if (fmt == ORB_FIELD_FMT_TEXT)
+        {
+          orb_field_puts(&out, fields[i].name, fields[i].namelen);
+          orb_field_putc(&out, ':');
+        }
+
+      orb_field_put(&out, &fields[i], data, json);
+    }
+
+  if (json)
+    {
+      orb_field_putc(&out, '}');
+    }
+
+  if (size > 0)
+    {
+      buf[out.len < size ? out.len : size - 1] = '\0';
+    }
+
+  return out.len;
+}
+
+int orb_fields_sscanf(FAR const char *buf,
+                      FAR const struct orb_field_s *fields, int nfields,
+                      FAR void *data)
+{
+  FAR uint8_t *out = data;
+  FAR const char *sep;
+  FAR char *end;
+  int i;
+
+  for (i = 0; i < nfields; i++)
+    {
+      union
+        {
+          int8_t   i8;
+          int16_t  i16;
+          int32_t  i32;
+          int64_t  i64;
+          float    f;
+          double   d;
+        } u;
+
+      /* Skip the optional "name:" prefix of the value */
+
+      sep = strpbrk(buf, ":,");
+      if (sep != NULL && *sep == ':')
+        {
+          buf = sep + 1;
+        }
+
+      if (fields[i].type == ORB_FIELD_FLOAT)
+        {
+          double value = strtod(buf, &end);
+
+          if (fields[i].size == sizeof(float))
+            {
+              u.f = value;
+            }
+          else
+            {
+              u.d = value;
+            }
+        }
+      else
+        {
+          int64_t value;
+
+          if (fields[i].type == ORB_FIELD_INT)
+            {
+              value = strtoll(buf, &end, 10);
+            }
+          else
+            {
+              value = strtoull(buf, &end,
+                               fields[i].type == ORB_FIELD_HEX ? 16 : 10);
+            }
+
+          switch (fields[i].size)
+            {
+              case 1:
+                u.i8 = value;
+                break;
+
+              case 2:
+                u.i16 = value;
+                break;
+
+              case 4:
+                u.i32 = value;
+                break;
+
+              default:
+                u.i64 = value;
+                break;
+            }
+        }
+
+      if (end == buf)
+        {
+          return i > 0 ? i : -EINVAL;
+        }
+
+      memcpy(out + fields[i].offset, &u, fields[i].size);
+
+      buf = end;
+      while (*buf == ',' || *buf == ' ')
+        {
+          buf++;
+        }
+    }
+
+  return i;
+}
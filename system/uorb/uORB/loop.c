@@ -28,6 +28,9 @@
 #include <sys/poll.h>
 #include <unistd.h>
 #include <sys/eventfd.h>
+#ifdef CONFIG_TIMER_FD
+#include <sys/timerfd.h>
+#endif
 #include <sys/wait.h>
 #include <sys/types.h>
 
@@ -150,6 +153,9 @@ int orb_handle_init(FAR struct orb_handle_s *handle, int fd, int events,
   handle->fd = fd;
   handle->arg    = arg;
   handle->events = events;
+  handle->type   = ORB_HANDLE_TOPIC;
+  handle->count  = 0;
+  handle->priority    = 0;
   handle->eventpri_cb = pri_cb;
   handle->eventerr_cb = err_cb;
   handle->datain_cb   = datain_cb;
@@ -169,3 +175,128 @@ int orb_handle_stop(FAR struct orb_loop_s *loop,
 {
   return loop->ops->enable(loop, handle, false);
 }
+
+int orb_handle_set_priority(FAR struct orb_handle_s *handle, int priority)
+{
+  if (handle == NULL)
+    {
+      return -EINVAL;
+    }
+
+  handle->priority = priority;
+  return OK;
+}
+
+#ifdef CONFIG_TIMER_FD
+int orb_handle_timer_init(FAR struct orb_handle_s *handle,
+                          unsigned int interval, FAR void *arg,
+                          orb_datain_cb_t timer_cb)
+{
+  int ret;
+  int fd;
+
+  fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  ret = orb_handle_init(handle, fd, POLLIN, arg, timer_cb,
+                        NULL, NULL, NULL);
+  if (ret < 0)
+    {
+      close(fd);
+      return ret;
+    }
+
+  handle->type = ORB_HANDLE_TIMER;
+
+  ret = orb_handle_timer_set(handle, interval);
+  if (ret < 0)
+    {
+      close(fd);
+      handle->fd = -1;
+    }
+
+  return ret;
+}
+
+int orb_handle_timer_set(FAR struct orb_handle_s *handle,
+                         unsigned int interval)
+{
+  struct itimerspec its;
+
+  if (handle == NULL || handle->type != ORB_HANDLE_TIMER)
+    {
+      return -EINVAL;
+    }
+
+  its.it_interval.tv_sec  = interval / 1000000;
+  its.it_interval.tv_nsec = (interval % 1000000) * 1000;
+  its.it_value            = its.it_interval;
+
+  if (timerfd_settime(handle->fd, 0, &its, NULL) < 0)
+    {
+      return -errno;
+    }
+
+  return OK;
+}
+#endif
+
+int orb_handle_event_init(FAR struct orb_handle_s *handle, FAR void *arg,
+                          orb_datain_cb_t event_cb)
+{
+  int ret;
+  int fd;
+
+  fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  ret = orb_handle_init(handle, fd, POLLIN, arg, event_cb,
+                        NULL, NULL, NULL);
+  if (ret < 0)
+    {
+      close(fd);
+      return ret;
+    }
+
+  handle->type = ORB_HANDLE_EVENT;
+  return OK;
+}
+
+int orb_handle_event_notify(FAR struct orb_handle_s *handle)
+{
+  eventfd_t event = 1;
+
+  if (handle == NULL || handle->type != ORB_HANDLE_EVENT)
+    {
+      return -EINVAL;
+    }
+
+  if (write(handle->fd, &event, sizeof(event)) < 0)
+    {
+      return -errno;
+    }
+
+  return OK;
+}
+
+int orb_handle_deinit(FAR struct orb_handle_s *handle)
+{
+  if (handle == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (handle->type != ORB_HANDLE_TOPIC && handle->fd >= 0)
+    {
+      close(handle->fd);
+      handle->fd = -1;
+    }
+
+  return OK;
+}
@@ -0,0 +1,419 @@
+/****************************************************************************
+ * apps/system/uorb/uORB/shm.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <uORB/uORB.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ORB_SHM_MAGIC          0x4d48534f /* "OSHM" */
+#define ORB_SHM_ALIGN(x)       (((x) + 7) & ~7)
+#define ORB_SHM_HDR_SIZE       ORB_SHM_ALIGN(sizeof(struct orb_shm_ring_s))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Ring header placed at the beginning of the shared memory object,
+ * followed by nbuffer slots of stride bytes each.
+ *
+ * Sample sequence s lives in slot (s & (nbuffer - 1)). head is the number
+ * of samples published so far, so the sample being written (if any) is
+ * always sequence head. A sample t is therefore intact as long as
+ * head - t < nbuffer; all comparisons use modular 32-bit arithmetic.
+ */
+
+struct orb_shm_ring_s
+{
+  uint32_t    magic;    /* ORB_SHM_MAGIC once the ring is initialized */
+  uint32_t    esize;    /* Sample size */
+  uint32_t    stride;   /* Slot size */
+  uint32_t    nbuffer;  /* Number of slots, power of two */
+  atomic_uint head;     /* Number of published samples */
+};
+
+/* Sample written to the notification node after every publish */
+
+struct orb_shm_notify_s
+{
+  uint64_t timestamp;   /* Publish time */
+  uint32_t seq;         /* Sequence of the published sample */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_UORB
+static const char orb_shm_notify_format[] =
+  "timestamp:%" PRIu64 ",seq:%" PRIu32 "";
+#endif
+
+static FAR uint8_t *orb_shm_slot(FAR struct orb_shm_ring_s *ring,
+                                 uint32_t seq)
+{
+  return (FAR uint8_t *)ring + ORB_SHM_HDR_SIZE +
+         (size_t)(seq & (ring->nbuffer - 1)) * ring->stride;
+}
+
+/****************************************************************************
+ * Name: orb_shm_path
+ *
+ * Description:
+ *   Build the shared memory object name of a topic instance.
+ ****************************************************************************/
+
+static void orb_shm_path(FAR const struct orb_metadata *meta, int instance,
+                         FAR char *path, size_t size)
+{
+  snprintf(path, size, "uorb_%s%d", meta->o_name, instance);
+}
+
+/****************************************************************************
+ * Name: orb_shm_init
+ *
+ * Description:
+ *   Fill the handle, shared memory object name and notification meta.
+ ****************************************************************************/
+
+static void orb_shm_init(FAR struct orb_shm_s *shm,
+                         FAR const struct orb_metadata *meta, int instance,
+                         FAR char *path, size_t size)
+{
+  memset(shm, 0, sizeof(*shm));
+  shm->meta     = meta;
+  shm->instance = instance;
+  shm->fd       = -1;
+
+  snprintf(shm->name, sizeof(shm->name), "%s_shm", meta->o_name);
+  shm->nmeta.o_name   = shm->name;
+  shm->nmeta.o_size   = sizeof(struct orb_shm_notify_s);
+#ifdef CONFIG_DEBUG_UORB
+  shm->nmeta.o_format = orb_shm_notify_format;
+#endif
+
+  orb_shm_path(meta, instance, path, size);
+}
+
+/****************************************************************************
+ * Name: orb_shm_map
+ *
+ * Description:
+ *   Map the shared memory object of a topic.
+ ****************************************************************************/
+
+static int orb_shm_map(FAR struct orb_shm_s *shm, FAR const char *path,
+                       int oflags, size_t len)
+{
+  int prot = oflags == O_RDONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+  FAR void *addr;
+  int ret = OK;
+  int fd;
+
+  fd = shm_open(path, oflags, 0666);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  if ((oflags & O_CREAT) && ftruncate(fd, len) < 0)
+    {
+      ret = -errno;
+      goto out;
+    }
+
+  addr = mmap(NULL, len, prot, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED)
+    {
+      ret = -errno;
+      goto out;
+    }
+
+  shm->ring = addr;
+  shm->len  = len;
+
+out:
+  close(fd);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int orb_shm_advertise(FAR struct orb_shm_s *shm,
+                      FAR const struct orb_metadata *meta, int instance,
+                      unsigned int queue_size)
+{
+  FAR struct orb_shm_ring_s *ring;
+  char path[ORB_PATH_MAX];
+  unsigned int nbuffer = 2;
+  uint32_t stride;
+  int ret;
+
+  if (shm == NULL || meta == NULL || queue_size > UINT16_MAX)
+    {
+      return -EINVAL;
+    }
+
+  orb_shm_init(shm, meta, instance, path, sizeof(path));
+
+  /* Round the queue up to a power of two, so that the slot index stays
+   * continuous when the sequence counter wraps around. One slot is always
+   * reserved for the writer, so at least two are needed.
+   */
+
+  while (nbuffer < queue_size)
+    {
+      nbuffer <<= 1;
+    }
+
+  stride = ORB_SHM_ALIGN(meta->o_size);
+  shm->owner = true;
+  ret = orb_shm_map(shm, path, O_RDWR | O_CREAT,
+                    ORB_SHM_HDR_SIZE + (size_t)nbuffer * stride);
+  if (ret < 0)
+    {
+      uorberr("%s shm map failed (%d)", meta->o_name, ret);
+      orb_shm_close(shm);
+      return ret;
+    }
+
+  ring = shm->ring;
+  ring->esize   = meta->o_size;
+  ring->stride  = stride;
+  ring->nbuffer = nbuffer;
+  atomic_init(&ring->head, 0);
+  atomic_thread_fence(memory_order_release);
+  ring->magic   = ORB_SHM_MAGIC;
+
+  shm->fd = orb_advertise_multi_queue_info(&shm->nmeta, NULL,
+                                           &shm->instance, 1, NULL);
+  if (shm->fd < 0)
+    {
+      ret = -errno;
+      orb_shm_close(shm);
+      return ret;
+    }
+
+  return OK;
+}
+
+int orb_shm_subscribe(FAR struct orb_shm_s *shm,
+                      FAR const struct orb_metadata *meta, int instance)
+{
+  struct orb_shm_ring_s hdr;
+  char path[ORB_PATH_MAX];
+  int ret;
+
+  if (shm == NULL || meta == NULL)
+    {
+      return -EINVAL;
+    }
+
+  orb_shm_init(shm, meta, instance, path, sizeof(path));
+
+  /* Map the header first to learn the ring geometry */
+
+  ret = orb_shm_map(shm, path, O_RDONLY, sizeof(hdr));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(&hdr, shm->ring, offsetof(struct orb_shm_ring_s, head));
+  munmap(shm->ring, shm->len);
+  shm->ring = NULL;
+
+  if (hdr.magic != ORB_SHM_MAGIC || hdr.esize != meta->o_size)
+    {
+      return -EAGAIN;
+    }
+
+  ret = orb_shm_map(shm, path, O_RDONLY,
+                    ORB_SHM_HDR_SIZE + (size_t)hdr.nbuffer * hdr.stride);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  shm->fd = orb_subscribe_multi(&shm->nmeta, shm->instance);
+  if (shm->fd < 0)
+    {
+      ret = -errno;
+      orb_shm_close(shm);
+      return ret;
+    }
+
+  fcntl(shm->fd, F_SETFL, fcntl(shm->fd, F_GETFL) | O_NONBLOCK);
+
+  /* Start with the newest sample, like a regular subscriber does */
+
+  shm->seq = atomic_load_explicit(&shm->ring->head, memory_order_acquire);
+  if (shm->seq != 0)
+    {
+      shm->seq--;
+    }
+
+  return OK;
+}
+
+int orb_shm_close(FAR struct orb_shm_s *shm)
+{
+  char path[ORB_PATH_MAX];
+
+  if (shm->fd >= 0)
+    {
+      orb_close(shm->fd);
+      shm->fd = -1;
+    }
+
+  if (shm->ring != NULL)
+    {
+      munmap(shm->ring, shm->len);
+      shm->ring = NULL;
+    }
+
+  /* The object stays mapped by the subscribers until they close */
+
+  if (shm->owner)
+    {
+      orb_shm_path(shm->meta, shm->instance, path, sizeof(path));
+      shm_unlink(path);
+      shm->owner = false;
+    }
+
+  return OK;
+}
+
+FAR void *orb_shm_reserve(FAR struct orb_shm_s *shm)
+{
+  FAR struct orb_shm_ring_s *ring = shm->ring;
+  uint32_t head;
+
+  head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+  /* Make the head store of the previous publish visible before any
+   * write to the slot it may still share with a lagging reader.
+   */
+
+  atomic_thread_fence(memory_order_seq_cst);
+  return orb_shm_slot(ring, head);
+}
+
+int orb_shm_commit(FAR struct orb_shm_s *shm)
+{
+  FAR struct orb_shm_ring_s *ring = shm->ring;
+  struct orb_shm_notify_s notify;
+
+  notify.seq = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  atomic_store_explicit(&ring->head, notify.seq + 1, memory_order_release);
+
+  /* Only a small notification goes through the driver to wake up
+   * pollers, the sample itself stays in the ring.
+   */
+
+  notify.timestamp = orb_absolute_time();
+  return orb_publish(&shm->nmeta, shm->fd, &notify);
+}
+
+int orb_shm_publish(FAR struct orb_shm_s *shm, FAR const void *data)
+{
+  memcpy(orb_shm_reserve(shm), data, shm->ring->esize);
+  return orb_shm_commit(shm);
+}
+
+int orb_shm_borrow(FAR struct orb_shm_s *shm, FAR const void **data,
+                   FAR uint32_t *seq)
+{
+  FAR struct orb_shm_ring_s *ring = shm->ring;
+  struct orb_shm_notify_s notify;
+  uint32_t lost = 0;
+  uint32_t head;
+
+  head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  if (head == shm->seq)
+    {
+      /* Drained, consume the pending wakeup and check again so that a
+       * publish racing with the read is not lost.
+       */
+
+      orb_copy_multi(shm->fd, &notify, sizeof(notify));
+      head = atomic_load_explicit(&ring->head, memory_order_acquire);
+      if (head == shm->seq)
+        {
+          return -EAGAIN;
+        }
+    }
+
+  /* The oldest intact sample is head - (nbuffer - 1), the slot of head
+   * itself may be under write.
+   */
+
+  if (head - shm->seq >= ring->nbuffer)
+    {
+      lost     = head - shm->seq - (ring->nbuffer - 1);
+      shm->seq = head - (ring->nbuffer - 1);
+    }
+
+  *data = orb_shm_slot(ring, shm->seq);
+  if (seq != NULL)
+    {
+      *seq = shm->seq;
+    }
+
+  shm->lost += lost;
+  return lost;
+}
+
+int orb_shm_release(FAR struct orb_shm_s *shm)
+{
+  FAR struct orb_shm_ring_s *ring = shm->ring;
+  uint32_t head;
+
+  atomic_thread_fence(memory_order_acquire);
+  head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+  /* Whatever happened, move on. An overwritten sample shows up as lost
+   * samples on the next borrow.
+   */
+
+  if (head - shm->seq++ >= ring->nbuffer)
+    {
+      return -ESTALE;
+    }
+
+  return OK;
+}
@@ -35,10 +35,65 @@
 #include <nuttx/streams.h>
 #include <uORB/uORB.h>
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(CONFIG_UORB_TOPIC_EVENTS) && defined(CONFIG_DEBUG_UORB)
+static const char orb_topic_event_format[] = "timestamp:%" PRIu64 "";
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+ORB_DEFINE(orb_topic_event, struct orb_topic_event_s,
+           orb_topic_event_format);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+/****************************************************************************
+ * Name: orb_topic_notify
+ *
+ * Description:
+ *   Publish the creation of a topic node to orb_topic_event. Nothing is
+ *   registered when no one listens, so this costs one failed open then.
+ *
+ * Input Parameters:
+ *   meta         The uORB metadata of the created node.
+ *   path         The created node path.
+ ****************************************************************************/
+
+static void orb_topic_notify(FAR const struct orb_metadata *meta,
+                             FAR const char *path)
+{
+  struct orb_topic_event_s event;
+  int fd;
+
+  if (meta == ORB_ID(orb_topic_event))
+    {
+      return;
+    }
+
+  fd = orb_open((ORB_ID(orb_topic_event))->o_name, 0, O_WRONLY);
+  if (fd < 0)
+    {
+      return;
+    }
+
+  event.timestamp = orb_absolute_time();
+  strlcpy(event.name, path + sizeof(ORB_SENSOR_PATH) - 1,
+          sizeof(event.name));
+  write(fd, &event, sizeof(event));
+  close(fd);
+}
+#endif
+
 /****************************************************************************
  * Name: orb_advsub_open
  *
@@ -114,6 +169,9 @@ static int orb_advsub_open(FAR const struct orb_metadata *meta, int flags,
       if (err != EEXIST)
         {
           ioctl(fd, SNIOC_SET_USERPRIV, (unsigned long)(uintptr_t)meta);
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+          orb_topic_notify(meta, path);
+#endif
         }
     }
 
@@ -372,6 +430,134 @@ int orb_group_count(FAR const struct orb_metadata *meta)
   return instance;
 }
 
+#ifdef CONFIG_UORB_STATS
+int orb_stats_init(int fd, FAR struct orb_stats_s *stats)
+{
+  struct sensor_ustate_s ustate;
+  struct sensor_state_s state;
+  int ret;
+
+  ret = ioctl(fd, SNIOC_GET_STATE, (unsigned long)(uintptr_t)&state);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = ioctl(fd, SNIOC_GET_USTATE, (unsigned long)(uintptr_t)&ustate);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(stats, 0, sizeof(*stats));
+  stats->start       = orb_absolute_time();
+  stats->now         = stats->start;
+  stats->generation  = state.generation;
+  stats->ugeneration = ustate.generation;
+  stats->latency_min = UINT64_MAX;
+
+  return ret;
+}
+
+void orb_stats_record(FAR struct orb_stats_s *stats, FAR const void *data,
+                      size_t size, int nb)
+{
+  FAR const uint8_t *sample = data;
+  orb_abstime now = orb_absolute_time();
+  orb_abstime timestamp;
+  orb_abstime latency;
+  int bucket;
+
+  for (; nb > 0; nb--, sample += size)
+    {
+      memcpy(&timestamp, sample, sizeof(timestamp));
+      latency = now > timestamp ? now - timestamp : 0;
+
+      bucket = 0;
+      while (bucket < ORB_STATS_BUCKETS - 1 && (latency >> (bucket + 1)))
+        {
+          bucket++;
+        }
+
+      stats->histogram[bucket]++;
+      stats->latency_sum += latency;
+      stats->received++;
+
+      if (latency < stats->latency_min)
+        {
+          stats->latency_min = latency;
+        }
+
+      if (latency > stats->latency_max)
+        {
+          stats->latency_max = latency;
+        }
+    }
+}
+
+int orb_stats_get(int fd, FAR struct orb_stats_s *stats)
+{
+  struct sensor_ustate_s ustate;
+  struct sensor_state_s state;
+  uint64_t consumed;
+  int ret;
+
+  ret = ioctl(fd, SNIOC_GET_STATE, (unsigned long)(uintptr_t)&state);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = ioctl(fd, SNIOC_GET_USTATE, (unsigned long)(uintptr_t)&ustate);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Everything the subscriber moved past without recording it was
+   * overwritten in the queue before it could be copied.
+   */
+
+  stats->now       = orb_absolute_time();
+  stats->published = state.generation - stats->generation;
+  consumed         = ustate.generation - stats->ugeneration;
+  stats->lost      = consumed > stats->received ?
+                     consumed - stats->received : 0;
+  stats->rate      = stats->now > stats->start ?
+                     stats->published * 1000000 /
+                     (stats->now - stats->start) : 0;
+
+  return ret;
+}
+
+orb_abstime orb_stats_percentile(FAR const struct orb_stats_s *stats,
+                                 int percent)
+{
+  uint64_t threshold;
+  uint64_t count = 0;
+  orb_abstime bound;
+  int i;
+
+  if (stats->received == 0)
+    {
+      return 0;
+    }
+
+  threshold = (stats->received * percent + 99) / 100;
+  for (i = 0; i < ORB_STATS_BUCKETS - 1; i++)
+    {
+      count += stats->histogram[i];
+      if (count >= threshold)
+        {
+          break;
+        }
+    }
+
+  bound = ((orb_abstime)2 << i) - 1;
+  return bound < stats->latency_max ? bound : stats->latency_max;
+}
+#endif
+
 #ifdef CONFIG_DEBUG_UORB
 int orb_sscanf(FAR const char *buf, FAR const char *format, FAR void *data)
 {
@@ -34,6 +34,7 @@
 #endif
 
 #include <sys/time.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -49,6 +50,12 @@
 #  define CONFIG_UORB_LOOP_MAX_EVENTS 0
 #endif
 
+#define ORB_STATS_BUCKETS      24
+
+#define ORB_LOG_MAGIC          "uORBLOG"
+#define ORB_LOG_VERSION        1
+#define ORB_LOG_NAME_MAX       32
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -86,6 +93,35 @@ struct orb_object
 typedef uint64_t orb_abstime;
 typedef struct sensor_device_info_s orb_info_t;
 
+/* Binary topic log layout, shared by the listener recorder and the
+ * generator replayer. The file starts with one orb_log_header_s followed
+ * by records, each made of the orb_abstime timestamp of the sample
+ * immediately followed by o_size bytes of raw topic data.
+ */
+
+struct orb_log_header_s
+{
+  char     magic[8];                  /* ORB_LOG_MAGIC */
+  uint16_t version;                   /* ORB_LOG_VERSION */
+  uint16_t size;                      /* Topic size (o_size) */
+  uint16_t instance;                  /* Topic instance */
+  uint16_t reserved;                  /* Reserved, must be zero */
+  char     name[ORB_LOG_NAME_MAX];    /* Topic name (o_name) */
+};
+
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+/* Sample of the orb_topic_event topic, published every time a topic node
+ * is created through this library, so that tools can discover topics
+ * without rescanning ORB_SENSOR_PATH.
+ */
+
+struct orb_topic_event_s
+{
+  uint64_t timestamp;                 /* Creation time */
+  char     name[NAME_MAX];            /* Node name, o_name and instance */
+};
+#endif
+
 struct orb_handle_s;
 
 typedef CODE int (*orb_datain_cb_t)(FAR struct orb_handle_s *handle,
@@ -97,16 +133,98 @@ typedef CODE int (*orb_eventpri_cb_t)(FAR struct orb_handle_s *handle,
 typedef CODE int (*orb_eventerr_cb_t)(FAR struct orb_handle_s *handle,
                                       FAR void *arg);
 
+#ifdef CONFIG_DEBUG_UORB
+/* Field of a topic structure, compiled once per topic from
+ * metadata.o_format so that samples can be serialized without parsing the
+ * format string again. o_format is the only layout description the topic
+ * metadata carries, so the descriptors share its CONFIG_DEBUG_UORB
+ * dependency. Some format names differ from the structure members
+ * ("heart beat", the GNSS satellite arrays), which is why the table is not
+ * built with offsetof() from nuttx/uorb.h.
+ */
+
+enum orb_field_type_e
+{
+  ORB_FIELD_INT = 0,            /* Signed integer, printed in decimal */
+  ORB_FIELD_UINT,               /* Unsigned integer, printed in decimal */
+  ORB_FIELD_HEX,                /* Unsigned integer, printed in hex */
+  ORB_FIELD_FLOAT,              /* float or double */
+};
+
+enum orb_field_fmt_e
+{
+  ORB_FIELD_FMT_TEXT = 0,       /* "name:value,...", as orb_info prints */
+  ORB_FIELD_FMT_JSON,           /* {"name":value,...} */
+};
+
+struct orb_field_s
+{
+  FAR const char *name;         /* Field name, not NUL terminated */
+  uint8_t         namelen;      /* Field name length */
+  uint8_t         type;         /* enum orb_field_type_e */
+  uint8_t         size;         /* Field size in bytes */
+  uint16_t        offset;       /* Field offset in the topic structure */
+};
+#endif
+
+#ifdef CONFIG_UORB_STATS
+struct orb_stats_s
+{
+  orb_abstime start;            /* Start of the statistics window */
+  orb_abstime now;              /* Time of the last orb_stats_get */
+  uint64_t    generation;       /* Topic generation at window start */
+  uint64_t    ugeneration;      /* Subscriber generation at window start */
+  uint64_t    published;        /* Samples published in the window */
+  uint64_t    received;         /* Samples recorded in the window */
+  uint64_t    lost;             /* Samples overwritten before being copied */
+  uint32_t    rate;             /* Average publish rate in the window, Hz */
+  orb_abstime latency_min;      /* Minimum delivery latency, us */
+  orb_abstime latency_max;      /* Maximum delivery latency, us */
+  orb_abstime latency_sum;      /* Sum of delivery latencies, us */
+  uint32_t    histogram[ORB_STATS_BUCKETS]; /* Latency histogram, bucket
+                                             * i counts [2^i, 2^(i+1)) us,
+                                             * bucket 0 also counts 0 us. */
+};
+#endif
+
+#ifdef CONFIG_UORB_SHM
+struct orb_shm_ring_s;
+struct orb_shm_s
+{
+  FAR struct orb_shm_ring_s     *ring;           /* Mapped sample ring. */
+  size_t                         len;            /* Mapped length. */
+  FAR const struct orb_metadata *meta;           /* Topic metadata. */
+  struct orb_metadata            nmeta;          /* Notification metadata. */
+  char                           name[NAME_MAX]; /* Notification name. */
+  int                            instance;       /* Topic instance. */
+  int                            fd;             /* Notification fd. */
+  uint32_t                       seq;            /* Next sequence to read. */
+  uint32_t                       lost;           /* Overrun sample count. */
+  bool                           owner;          /* Created the ring. */
+};
+#endif
+
 #if CONFIG_UORB_LOOP_MAX_EVENTS
 enum orb_loop_type_e
 {
   ORB_EPOLL_TYPE = 0,
 };
 
+enum orb_handle_type_e
+{
+  ORB_HANDLE_TOPIC = 0,           /* User fd, e.g. topic from orb_subscribe */
+  ORB_HANDLE_TIMER,               /* Periodic timer, owns a timerfd */
+  ORB_HANDLE_EVENT,               /* User event, owns an eventfd */
+};
+
 struct orb_handle_s
 {
   int                events;      /* Events of interest. */
   int                fd;          /* Topic fd. */
+  int                type;        /* Handle type, see orb_handle_type_e. */
+  int                priority;    /* Dispatch priority, higher goes first. */
+  uint64_t           count;       /* Timer expirations / events counted
+                                   * before the last datain_cb call. */
   FAR void          *arg;         /* Callback parameter. */
   orb_datain_cb_t    datain_cb;   /* User EPOLLIN callback function. */
   orb_dataout_cb_t   dataout_cb;  /* User EPOLLOUT callback function. */
@@ -229,6 +347,14 @@ extern "C"
 {
 #endif
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_UORB_TOPIC_EVENTS
+ORB_DECLARE(orb_topic_event);
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -574,6 +700,37 @@ static inline int orb_copy(FAR const struct orb_metadata *meta,
   return ret == meta->o_size ? 0 : -1;
 }
 
+/****************************************************************************
+ * Name: orb_copy_batch
+ *
+ * Description:
+ *   Drain up to count queued samples of a topic in one call.
+ *
+ *   For topics advertised with a queue_size greater than 1, all samples
+ *   queued for this subscriber since the last copy are returned in order,
+ *   oldest first, with a single syscall instead of one orb_copy() each.
+ *
+ * Input Parameters:
+ *   meta     The uORB metadata (usually from the ORB_ID() macro)
+ *   fd       A fd returned from orb_subscribe.
+ *   buffer   Pointer to an array of at least count samples.
+ *   count    Maximum number of samples to copy.
+ *
+ * Returned Value:
+ *   The number of samples copied on success, -1 otherwise with errno set
+ *   accordingly (EAGAIN if nothing is queued on a non-blocking fd).
+ ****************************************************************************/
+
+static inline int orb_copy_batch(FAR const struct orb_metadata *meta,
+                                 int fd, FAR void *buffer,
+                                 unsigned int count)
+{
+  ssize_t ret;
+
+  ret = orb_copy_multi(fd, buffer, (size_t)meta->o_size * count);
+  return ret < 0 ? -1 : ret / meta->o_size;
+}
+
 /****************************************************************************
  * Name: orb_get_state
  *
@@ -951,6 +1108,299 @@ void orb_info(FAR const char *format, FAR const char *name,
 
 int orb_fprintf(FAR FILE *stream, FAR const char *format,
                 FAR const void *data);
+
+/****************************************************************************
+ * Name: orb_fields_parse
+ *
+ * Description:
+ *   Compile a metadata.o_format string into field descriptors. Offsets
+ *   follow the natural alignment of the field types, as the topic
+ *   structure does.
+ *
+ * Input Parameters:
+ *   format  The uORB metadata.o_format.
+ *   fields  Descriptor array, may be NULL to only count the fields.
+ *   nfields Descriptor array capacity.
+ *
+ * Returned Value:
+ *   Number of fields on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_fields_parse(FAR const char *format, FAR struct orb_field_s *fields,
+                     int nfields);
+
+/****************************************************************************
+ * Name: orb_fields_alloc
+ *
+ * Description:
+ *   Allocate and compile the field descriptors of a topic.
+ *
+ * Input Parameters:
+ *   meta    The uORB metadata.
+ *   nfields Where to return the number of fields.
+ *
+ * Returned Value:
+ *   Descriptor array to release with free() on success, NULL on failure
+ *   with errno set: EINVAL if the format can't be described by fields
+ *   or its fields don't fit in o_size, ENOMEM if out of memory.
+ ****************************************************************************/
+
+FAR struct orb_field_s *orb_fields_alloc(FAR const struct orb_metadata *meta,
+                                         FAR int *nfields);
+
+/****************************************************************************
+ * Name: orb_fields_sprintf
+ *
+ * Description:
+ *   Format one sample with compiled field descriptors.
+ *
+ * Input Parameters:
+ *   buf     Output buffer.
+ *   size    Output buffer size.
+ *   fields  Field descriptors.
+ *   nfields Number of fields.
+ *   data    Topic data.
+ *   fmt     Output format.
+ *
+ * Returned Value:
+ *   Length of the full string, like snprintf.
+ ****************************************************************************/
+
+int orb_fields_sprintf(FAR char *buf, size_t size,
+                       FAR const struct orb_field_s *fields, int nfields,
+                       FAR const void *data, enum orb_field_fmt_e fmt);
+
+/****************************************************************************
+ * Name: orb_fields_sscanf
+ *
+ * Description:
+ *   Parse one text sample with compiled field descriptors. The "name:"
+ *   prefix of each value is optional.
+ *
+ * Input Parameters:
+ *   buf     Input string.
+ *   fields  Field descriptors.
+ *   nfields Number of fields.
+ *   data    Topic data.
+ *
+ * Returned Value:
+ *   Number of fields parsed on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_fields_sscanf(FAR const char *buf,
+                      FAR const struct orb_field_s *fields, int nfields,
+                      FAR void *data);
+#endif
+
+#ifdef CONFIG_UORB_STATS
+/****************************************************************************
+ * Name: orb_stats_init
+ *
+ * Description:
+ *   Start a new delivery statistics window for a subscriber.
+ *
+ * Input Parameters:
+ *   fd       A fd returned from orb_subscribe.
+ *   stats    The statistics to reset.
+ *
+ * Returned Value:
+ *   0 on success, -1 otherwise with errno set accordingly.
+ ****************************************************************************/
+
+int orb_stats_init(int fd, FAR struct orb_stats_s *stats);
+
+/****************************************************************************
+ * Name: orb_stats_record
+ *
+ * Description:
+ *   Account samples just copied from the topic. The delivery latency of
+ *   each sample is the time elapsed since its timestamp, which must be the
+ *   first member of the topic structure and come from orb_absolute_time().
+ *
+ * Input Parameters:
+ *   stats    The subscriber statistics.
+ *   data     The copied samples.
+ *   size     The size of one sample (o_size).
+ *   nb       The number of samples.
+ ****************************************************************************/
+
+void orb_stats_record(FAR struct orb_stats_s *stats, FAR const void *data,
+                      size_t size, int nb);
+
+/****************************************************************************
+ * Name: orb_stats_get
+ *
+ * Description:
+ *   Refresh the publish count, publish rate and lost samples of the window
+ *   from the topic driver.
+ *
+ * Input Parameters:
+ *   fd       The fd stats was initialized with.
+ *   stats    The subscriber statistics.
+ *
+ * Returned Value:
+ *   0 on success, -1 otherwise with errno set accordingly.
+ ****************************************************************************/
+
+int orb_stats_get(int fd, FAR struct orb_stats_s *stats);
+
+/****************************************************************************
+ * Name: orb_stats_percentile
+ *
+ * Description:
+ *   Estimate a delivery latency percentile from the histogram.
+ *
+ * Input Parameters:
+ *   stats    The subscriber statistics.
+ *   percent  The percentile, 0 - 100.
+ *
+ * Returned Value:
+ *   The upper bound of the histogram bucket holding the percentile in us,
+ *   clamped to latency_max; 0 if nothing was recorded.
+ ****************************************************************************/
+
+orb_abstime orb_stats_percentile(FAR const struct orb_stats_s *stats,
+                                 int percent);
+#endif
+
+#ifdef CONFIG_UORB_SHM
+/****************************************************************************
+ * Name: orb_shm_advertise
+ *
+ * Description:
+ *   Advertise a topic instance whose queue lives in a shared memory ring.
+ *
+ *   This is an opt-in zero-copy path for large topics: samples are written
+ *   in place into the ring and subscribers borrow pointers into it, only a
+ *   small notification sample goes through the driver node
+ *   "<name>_shm<instance>", whose fd (shm->fd) can be polled for POLLIN.
+ *
+ * Input Parameters:
+ *   shm          The handle to initialize.
+ *   meta         The uORB metadata (usually from the ORB_ID() macro)
+ *   instance     Instance number to advertise.
+ *   queue_size   Number of ring slots, rounded up to a power of two (>= 2).
+ *                A subscriber may lag up to queue_size - 1 samples. At
+ *                most UINT16_MAX, larger values return -EINVAL.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_shm_advertise(FAR struct orb_shm_s *shm,
+                      FAR const struct orb_metadata *meta, int instance,
+                      unsigned int queue_size);
+
+/****************************************************************************
+ * Name: orb_shm_subscribe
+ *
+ * Description:
+ *   Subscribe to a shared memory topic instance. The topic must have been
+ *   advertised with orb_shm_advertise() first. The first borrow returns the
+ *   newest sample, if any.
+ *
+ * Input Parameters:
+ *   shm          The handle to initialize.
+ *   meta         The uORB metadata (usually from the ORB_ID() macro)
+ *   instance     Instance number to subscribe.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure, -EAGAIN if
+ *   the ring is not yet initialized by the advertiser.
+ ****************************************************************************/
+
+int orb_shm_subscribe(FAR struct orb_shm_s *shm,
+                      FAR const struct orb_metadata *meta, int instance);
+
+/****************************************************************************
+ * Name: orb_shm_close
+ *
+ * Description:
+ *   Release a shared memory topic handle (advertiser or subscriber). The
+ *   advertiser also unlinks the shared memory object, subscribers that
+ *   still have it mapped keep reading it until they close.
+ *
+ * Input Parameters:
+ *   shm          The handle to release.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.
+ ****************************************************************************/
+
+int orb_shm_close(FAR struct orb_shm_s *shm);
+
+/****************************************************************************
+ * Name: orb_shm_reserve / orb_shm_commit
+ *
+ * Description:
+ *   Zero-copy publish: orb_shm_reserve() returns the ring slot of the next
+ *   sample, the advertiser fills it in place and orb_shm_commit() makes it
+ *   visible to subscribers and wakes them up.
+ *
+ * Input Parameters:
+ *   shm          The advertiser handle.
+ *
+ * Returned Value:
+ *   orb_shm_reserve: pointer to o_size bytes to fill.
+ *   orb_shm_commit: 0 on success, -1 otherwise with errno set accordingly.
+ ****************************************************************************/
+
+FAR void *orb_shm_reserve(FAR struct orb_shm_s *shm);
+int orb_shm_commit(FAR struct orb_shm_s *shm);
+
+/****************************************************************************
+ * Name: orb_shm_publish
+ *
+ * Description:
+ *   Copy one sample into the ring and commit it.
+ *
+ * Input Parameters:
+ *   shm          The advertiser handle.
+ *   data         A pointer to the data to be published.
+ *
+ * Returned Value:
+ *   0 on success, -1 otherwise with errno set accordingly.
+ ****************************************************************************/
+
+int orb_shm_publish(FAR struct orb_shm_s *shm, FAR const void *data);
+
+/****************************************************************************
+ * Name: orb_shm_borrow
+ *
+ * Description:
+ *   Borrow a pointer to the next unread sample, without copying it. The
+ *   pointer stays valid until orb_shm_release(), which must be called
+ *   before the next borrow. When the ring is drained, the pending poll
+ *   notification is consumed.
+ *
+ * Input Parameters:
+ *   shm          The subscriber handle.
+ *   data         Returned pointer to the sample.
+ *   seq          Returned sample sequence number, may be NULL.
+ *
+ * Returned Value:
+ *   The number of samples lost to overrun since the previous borrow (>= 0)
+ *   on success; -EAGAIN if there is no new sample.
+ ****************************************************************************/
+
+int orb_shm_borrow(FAR struct orb_shm_s *shm, FAR const void **data,
+                   FAR uint32_t *seq);
+
+/****************************************************************************
+ * Name: orb_shm_release
+ *
+ * Description:
+ *   Give back the sample borrowed by orb_shm_borrow().
+ *
+ * Input Parameters:
+ *   shm          The subscriber handle.
+ *
+ * Returned Value:
+ *   Zero (OK) if the sample stayed intact while borrowed; -ESTALE if the
+ *   advertiser overran it, in which case its content must be discarded.
+ ****************************************************************************/
+
+int orb_shm_release(FAR struct orb_shm_s *shm);
 #endif
 
 #if CONFIG_UORB_LOOP_MAX_EVENTS
@@ -1076,6 +1526,120 @@ int orb_handle_start(FAR struct orb_loop_s *loop,
 
 int orb_handle_stop(FAR struct orb_loop_s *loop,
                     FAR struct orb_handle_s *handle);
+
+/****************************************************************************
+ * Name: orb_handle_set_priority
+ *
+ * Description:
+ *   Set the dispatch priority of the handle. When several handles of a
+ *   loop are ready at once, their callbacks run in decreasing priority
+ *   order; handles of equal priority keep the order reported by the
+ *   backend. The default priority is 0.
+ *
+ * Input Parameters:
+ *   handle     orb loop handle.
+ *   priority   Dispatch priority, higher goes first.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_handle_set_priority(FAR struct orb_handle_s *handle, int priority);
+
+#ifdef CONFIG_TIMER_FD
+/****************************************************************************
+ * Name: orb_handle_timer_init
+ *
+ * Description:
+ *   Initialize a periodic timer handle. The loop calls timer_cb each time
+ *   the timer expires, with handle->count set to the number of expirations
+ *   since the previous call (more than 1 means periods were missed).
+ *   Release it with orb_handle_deinit.
+ *
+ * Input Parameters:
+ *   handle     orb loop handle, need to be added to loop for use.
+ *   interval   Timer period in us, 0 creates a disarmed timer.
+ *   arg        Parameters passed in by the user.
+ *   timer_cb   Timer expiration callback function.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_handle_timer_init(FAR struct orb_handle_s *handle,
+                          unsigned int interval, FAR void *arg,
+                          orb_datain_cb_t timer_cb);
+
+/****************************************************************************
+ * Name: orb_handle_timer_set
+ *
+ * Description:
+ *   Re-arm a timer handle with a new period.
+ *
+ * Input Parameters:
+ *   handle     Timer handle from orb_handle_timer_init.
+ *   interval   Timer period in us, 0 disarms the timer.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_handle_timer_set(FAR struct orb_handle_s *handle,
+                         unsigned int interval);
+#endif
+
+/****************************************************************************
+ * Name: orb_handle_event_init
+ *
+ * Description:
+ *   Initialize a user event handle, to wake up the loop from any thread
+ *   with orb_handle_event_notify. The loop calls event_cb with
+ *   handle->count set to the number of notifications coalesced since the
+ *   previous call. Release it with orb_handle_deinit.
+ *
+ * Input Parameters:
+ *   handle     orb loop handle, need to be added to loop for use.
+ *   arg        Parameters passed in by the user.
+ *   event_cb   Event callback function.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_handle_event_init(FAR struct orb_handle_s *handle, FAR void *arg,
+                          orb_datain_cb_t event_cb);
+
+/****************************************************************************
+ * Name: orb_handle_event_notify
+ *
+ * Description:
+ *   Signal a user event handle. Safe to call from any thread.
+ *
+ * Input Parameters:
+ *   handle     Event handle from orb_handle_event_init.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_handle_event_notify(FAR struct orb_handle_s *handle);
+
+/****************************************************************************
+ * Name: orb_handle_deinit
+ *
+ * Description:
+ *   Release the resources owned by a timer or event handle. The handle
+ *   must be stopped first. Topic handles don't own their fd, this is a
+ *   no-op for them.
+ *
+ * Input Parameters:
+ *   handle     orb loop handle.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int orb_handle_deinit(FAR struct orb_handle_s *handle);
 #endif
 
 #ifdef __cplusplus
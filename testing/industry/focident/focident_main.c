@@ -0,0 +1,303 @@
+/****************************************************************************
+ * apps/testing/industry/focident/focident_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <errno.h>
+#include <math.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include <dsp.h>
+
+#include "industry/foc/float/foc_ident_online.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Simulated motor */
+
+#define FOCIDENT_POLES    (7)
+#define FOCIDENT_RES      (0.5f)      /* [ohm] */
+#define FOCIDENT_IND      (0.001f)    /* [H] */
+#define FOCIDENT_FLUX     (0.01f)     /* [Wb] */
+
+/* Estimator */
+
+#define FOCIDENT_PER      (0.0001f)   /* 10 kHz control loop */
+#define FOCIDENT_DECIM    (10)
+#define FOCIDENT_FORGET   (0.999f)
+#define FOCIDENT_VEL_MIN  (50.0f)     /* [rad/s] */
+
+/* Initial parameters are this far from the real ones */
+
+#define FOCIDENT_INIT_ERR (1.5f)
+
+/* Simulated time and the accepted relative error of the estimates */
+
+#define FOCIDENT_STEPS    (20000)
+#define FOCIDENT_TOL      (0.05f)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: focident_cfg
+ ****************************************************************************/
+
+static void focident_cfg(FAR struct foc_ident_online_cfg_f32_s *cfg)
+{
+  memset(cfg, 0, sizeof(struct foc_ident_online_cfg_f32_s));
+
+  motor_phy_params_init(&cfg->phy, FOCIDENT_POLES,
+                        FOCIDENT_RES * FOCIDENT_INIT_ERR,
+                        FOCIDENT_IND * FOCIDENT_INIT_ERR,
+                        FOCIDENT_FLUX * FOCIDENT_INIT_ERR);
+
+  cfg->per     = FOCIDENT_PER;
+  cfg->forget  = FOCIDENT_FORGET;
+  cfg->vel_min = FOCIDENT_VEL_MIN;
+  cfg->decim   = FOCIDENT_DECIM;
+}
+
+/****************************************************************************
+ * Name: focident_motor
+ *
+ * Description:
+ *   Get the DQ state of the simulated motor at control cycle n. Currents
+ *   and velocity follow slow sine waves, voltages come from the PMSM DQ
+ *   equations with the exact current derivatives.
+ *
+ ****************************************************************************/
+
+static void focident_motor(int n, FAR struct foc_state_f32_s *state,
+                           FAR float *vel)
+{
+  float t   = n * FOCIDENT_PER;
+  float w1  = 2.0f * M_PI_F * 7.0f;
+  float w2  = 2.0f * M_PI_F * 11.0f;
+  float w3  = 2.0f * M_PI_F * 3.0f;
+  float id  = 0.5f * sinf(w1 * t);
+  float iq  = 2.0f + sinf(w2 * t);
+  float did = 0.5f * w1 * cosf(w1 * t);
+  float diq = w2 * cosf(w2 * t);
+  float we  = 300.0f + 100.0f * sinf(w3 * t);
+
+  memset(state, 0, sizeof(struct foc_state_f32_s));
+
+  state->idq.d = id;
+  state->idq.q = iq;
+  state->vdq.d = FOCIDENT_RES * id + FOCIDENT_IND * (did - we * iq);
+  state->vdq.q = FOCIDENT_RES * iq + FOCIDENT_IND * (diq + we * id) +
+                 FOCIDENT_FLUX * we;
+
+  *vel = we;
+}
+
+/****************************************************************************
+ * Name: focident_test_init
+ ****************************************************************************/
+
+static void focident_test_init(FAR void **state)
+{
+  struct foc_ident_online_f32_s     id;
+  struct foc_ident_online_cfg_f32_s cfg;
+
+  UNUSED(state);
+
+  focident_cfg(&cfg);
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), OK);
+
+  focident_cfg(&cfg);
+  cfg.per = 0.0f;
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), -EINVAL);
+
+  focident_cfg(&cfg);
+  cfg.decim = 0;
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), -EINVAL);
+
+  focident_cfg(&cfg);
+  cfg.forget = 0.0f;
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), -EINVAL);
+
+  focident_cfg(&cfg);
+  cfg.forget = 1.5f;
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), -EINVAL);
+
+  focident_cfg(&cfg);
+  cfg.phy.ind = 0.0f;
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), -EINVAL);
+}
+
+/****************************************************************************
+ * Name: focident_test_converge
+ *
+ * Description:
+ *   Start 50% off and check that all three parameters are found
+ *
+ ****************************************************************************/
+
+static void focident_test_converge(FAR void **state)
+{
+  struct foc_ident_online_f32_s     id;
+  struct foc_ident_online_cfg_f32_s cfg;
+  struct motor_phy_params_f32_s     phy;
+  struct foc_state_f32_s            foc;
+  uint32_t                          updates = 0;
+  float                             vel     = 0.0f;
+  int                               i       = 0;
+
+  UNUSED(state);
+
+  focident_cfg(&cfg);
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), OK);
+
+  for (i = 0; i < FOCIDENT_STEPS; i++)
+    {
+      focident_motor(i, &foc, &vel);
+      if (foc_ident_online_run_f32(&id, &foc, vel))
+        {
+          updates++;
+        }
+    }
+
+  /* One window is used only for the first current derivative */
+
+  assert_int_equal(updates, FOCIDENT_STEPS / FOCIDENT_DECIM - 1);
+  assert_int_equal(id.updates, updates);
+
+  foc_ident_online_phy_get_f32(&id, &phy);
+
+  assert_int_equal(phy.p, FOCIDENT_POLES);
+  assert_true(fabsf(phy.res - FOCIDENT_RES) <
+              FOCIDENT_RES * FOCIDENT_TOL);
+  assert_true(fabsf(phy.ind - FOCIDENT_IND) <
+              FOCIDENT_IND * FOCIDENT_TOL);
+  assert_true(fabsf(phy.flux_link - FOCIDENT_FLUX) <
+              FOCIDENT_FLUX * FOCIDENT_TOL);
+}
+
+/****************************************************************************
+ * Name: focident_test_low_speed
+ *
+ * Description:
+ *   Below the minimum velocity nothing is estimated
+ *
+ ****************************************************************************/
+
+static void focident_test_low_speed(FAR void **state)
+{
+  struct foc_ident_online_f32_s     id;
+  struct foc_ident_online_cfg_f32_s cfg;
+  struct motor_phy_params_f32_s     phy;
+  struct foc_state_f32_s            foc;
+  float                             vel = 0.0f;
+  int                               i   = 0;
+
+  UNUSED(state);
+
+  focident_cfg(&cfg);
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), OK);
+
+  for (i = 0; i < FOCIDENT_STEPS; i++)
+    {
+      focident_motor(i, &foc, &vel);
+      assert_false(foc_ident_online_run_f32(&id, &foc,
+                                            FOCIDENT_VEL_MIN / 2.0f));
+    }
+
+  assert_int_equal(id.updates, 0);
+
+  foc_ident_online_phy_get_f32(&id, &phy);
+
+  assert_true(phy.res == cfg.phy.res);
+  assert_true(phy.ind == cfg.phy.ind);
+  assert_true(phy.flux_link == cfg.phy.flux_link);
+}
+
+/****************************************************************************
+ * Name: focident_test_phy
+ *
+ * Description:
+ *   Estimates that are not physical fall back to the initial values, and
+ *   reset restarts from them
+ *
+ ****************************************************************************/
+
+static void focident_test_phy(FAR void **state)
+{
+  struct foc_ident_online_f32_s     id;
+  struct foc_ident_online_cfg_f32_s cfg;
+  struct motor_phy_params_f32_s     phy;
+
+  UNUSED(state);
+
+  focident_cfg(&cfg);
+  assert_int_equal(foc_ident_online_init_f32(&id, &cfg), OK);
+
+  id.theta[0] = -1.0f;
+  id.theta[1] = 0.0f;
+  id.theta[2] = NAN;
+
+  foc_ident_online_phy_get_f32(&id, &phy);
+
+  assert_true(phy.res == cfg.phy.res);
+  assert_true(phy.ind == cfg.phy.ind);
+  assert_true(phy.flux_link == cfg.phy.flux_link);
+
+  id.theta[0] = 1.0f;
+  id.updates  = 10;
+
+  foc_ident_online_reset_f32(&id);
+
+  assert_true(id.theta[0] == cfg.phy.res);
+  assert_int_equal(id.updates, 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * focident_main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  const struct CMUnitTest tests[] =
+  {
+    cmocka_unit_test(focident_test_init),
+    cmocka_unit_test(focident_test_converge),
+    cmocka_unit_test(focident_test_low_speed),
+    cmocka_unit_test(focident_test_phy),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
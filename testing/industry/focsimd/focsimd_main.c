@@ -0,0 +1,329 @@
+/****************************************************************************
+ * apps/testing/industry/focsimd/focsimd_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include <dspb16.h>
+
+#include "industry/foc/fixed16/foc_simd.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FOCSIMD_ITER CONFIG_TESTING_FOC_SIMD_ITER
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Edge values, checked against each other before the random vectors */
+
+static const b16_t g_focsimd_edge[] =
+{
+  0, 1, -1, b16HALF, -b16HALF, b16HALF - 1, -b16HALF - 1,
+  b16ONE, -b16ONE, b16ONE - 1, -b16ONE + 1, b16MAX, b16MIN,
+  b16MAX - b16HALF, b16MIN + b16HALF
+};
+
+#define FOCSIMD_EDGE_N ((int)(sizeof(g_focsimd_edge) / sizeof(b16_t)))
+
+static uint32_t g_focsimd_seed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: focsimd_rand
+ *
+ * Description:
+ *   Deterministic xorshift32 generator, so a failure can be reproduced
+ *
+ ****************************************************************************/
+
+static b16_t focsimd_rand(void)
+{
+  g_focsimd_seed ^= g_focsimd_seed << 13;
+  g_focsimd_seed ^= g_focsimd_seed >> 17;
+  g_focsimd_seed ^= g_focsimd_seed << 5;
+
+  return (b16_t)g_focsimd_seed;
+}
+
+/****************************************************************************
+ * Name: focsimd_value
+ *
+ * Description:
+ *   Get test value number i: edge values first, then random values from
+ *   the full b16_t range or from a typical phase current range.
+ *
+ ****************************************************************************/
+
+static b16_t focsimd_value(int i)
+{
+  if (i < FOCSIMD_EDGE_N)
+    {
+      return g_focsimd_edge[i];
+    }
+
+  return (i & 1) ? focsimd_rand() : focsimd_rand() >> 8;
+}
+
+/****************************************************************************
+ * Name: focsimd_angle
+ *
+ * Description:
+ *   Get test phase angle number i: every other angle comes from libdsp,
+ *   the rest has arbitrary sin/cos values.
+ *
+ ****************************************************************************/
+
+static void focsimd_angle(int i, FAR phase_angle_b16_t *angle)
+{
+  if (i & 1)
+    {
+      phase_angle_update_b16(angle,
+                             (b16_t)((uint32_t)focsimd_rand() %
+                                     (uint32_t)b16TWOPI));
+    }
+  else
+    {
+      angle->angle = 0;
+      angle->sin   = focsimd_value(i / 2);
+      angle->cos   = focsimd_value(i / 2 + 1);
+    }
+}
+
+/****************************************************************************
+ * Name: setup
+ ****************************************************************************/
+
+static int setup(FAR void **state)
+{
+  g_focsimd_seed = 0x2545f491;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: test_case_mul
+ ****************************************************************************/
+
+static void test_case_mul(FAR void **state)
+{
+  b16_t x = 0;
+  b16_t c = 0;
+  int   i = 0;
+  int   j = 0;
+
+  for (i = 0; i < FOCSIMD_EDGE_N; i++)
+    {
+      for (j = 0; j < FOCSIMD_EDGE_N; j++)
+        {
+          x = g_focsimd_edge[i];
+          c = g_focsimd_edge[j];
+          assert_int_equal(foc_simd_mul_b16(x, c), b16mulb16(x, c));
+        }
+    }
+
+  for (i = 0; i < FOCSIMD_ITER; i++)
+    {
+      x = focsimd_value(i);
+      c = focsimd_value(i + 1);
+      assert_int_equal(foc_simd_mul_b16(x, c), b16mulb16(x, c));
+    }
+}
+
+/****************************************************************************
+ * Name: test_case_clarke
+ ****************************************************************************/
+
+static void test_case_clarke(FAR void **state)
+{
+  abc_frame_b16_t abc;
+  ab_frame_b16_t  ref;
+  ab_frame_b16_t  out;
+  int             i = 0;
+
+  for (i = 0; i < FOCSIMD_ITER; i++)
+    {
+      abc.a = focsimd_value(i);
+      abc.b = focsimd_value(i + 1);
+      abc.c = -abc.a - abc.b;
+
+      clarke_transform_b16(&abc, &ref);
+      foc_simd_clarke_b16(&abc, &out);
+
+      assert_int_equal(out.a, ref.a);
+      assert_int_equal(out.b, ref.b);
+    }
+}
+
+/****************************************************************************
+ * Name: test_case_park
+ ****************************************************************************/
+
+static void test_case_park(FAR void **state)
+{
+  phase_angle_b16_t angle;
+  ab_frame_b16_t    ab;
+  dq_frame_b16_t    ref;
+  dq_frame_b16_t    out;
+  int               i = 0;
+
+  for (i = 0; i < FOCSIMD_ITER; i++)
+    {
+      focsimd_angle(i, &angle);
+      ab.a = focsimd_value(i);
+      ab.b = focsimd_value(i + 2);
+
+      park_transform_b16(&angle, &ab, &ref);
+      foc_simd_park_b16(&angle, &ab, &out);
+
+      assert_int_equal(out.d, ref.d);
+      assert_int_equal(out.q, ref.q);
+    }
+}
+
+/****************************************************************************
+ * Name: test_case_inv_park
+ ****************************************************************************/
+
+static void test_case_inv_park(FAR void **state)
+{
+  phase_angle_b16_t angle;
+  dq_frame_b16_t    dq;
+  ab_frame_b16_t    ref;
+  ab_frame_b16_t    out;
+  int               i = 0;
+
+  for (i = 0; i < FOCSIMD_ITER; i++)
+    {
+      focsimd_angle(i, &angle);
+      dq.d = focsimd_value(i);
+      dq.q = focsimd_value(i + 2);
+
+      inv_park_transform_b16(&angle, &dq, &ref);
+      foc_simd_inv_park_b16(&angle, &dq, &out);
+
+      assert_int_equal(out.a, ref.a);
+      assert_int_equal(out.b, ref.b);
+    }
+}
+
+/****************************************************************************
+ * Name: test_case_foc
+ *
+ * Description:
+ *   Run the libdsp FOC controller and the SIMD replacements side by side
+ *   and compare the whole controller state.
+ *
+ ****************************************************************************/
+
+static void test_case_foc(FAR void **state)
+{
+  struct foc_initdata_b16_s cfg;
+  struct foc_data_b16_s     ref;
+  struct foc_data_b16_s     out;
+  phase_angle_b16_t         angle;
+  abc_frame_b16_t           i_abc;
+  dq_frame_b16_t            v_dq;
+  b16_t                     vbase = 0;
+  int                       i     = 0;
+
+  memset(&ref, 0, sizeof(ref));
+  memset(&out, 0, sizeof(out));
+
+  cfg.id_kp = ftob16(0.5f);
+  cfg.id_ki = ftob16(0.01f);
+  cfg.iq_kp = ftob16(0.5f);
+  cfg.iq_ki = ftob16(0.01f);
+
+  foc_init_b16(&ref, &cfg);
+  foc_init_b16(&out, &cfg);
+
+  for (i = 0; i < FOCSIMD_ITER; i++)
+    {
+      /* Same sequence as the PI controller: currents, base voltage, angle */
+
+      i_abc.a = focsimd_rand() >> 10;
+      i_abc.b = focsimd_rand() >> 10;
+      i_abc.c = -i_abc.a - i_abc.b;
+
+      foc_iabc_update_b16(&ref, &i_abc);
+      foc_simd_iabc_update_b16(&out, &i_abc);
+
+      if ((i & 0xff) == 0)
+        {
+          vbase = b16ONE + ((uint32_t)focsimd_rand() % itob16(48));
+          foc_vbase_update_b16(&ref, vbase);
+          foc_vbase_update_b16(&out, vbase);
+        }
+
+      phase_angle_update_b16(&angle,
+                             (b16_t)((uint32_t)focsimd_rand() %
+                                     (uint32_t)b16TWOPI));
+      foc_angle_update_b16(&ref, &angle);
+      foc_angle_update_b16(&out, &angle);
+
+      v_dq.d = focsimd_rand() >> 12;
+      v_dq.q = focsimd_rand() >> 12;
+
+      foc_voltage_control_b16(&ref, &v_dq);
+      foc_simd_voltage_control_b16(&out, &v_dq);
+
+      assert_memory_equal(&out, &ref, sizeof(struct foc_data_b16_s));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * focsimd_main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  const struct CMUnitTest tests[] =
+  {
+    cmocka_unit_test_setup(test_case_mul, setup),
+    cmocka_unit_test_setup(test_case_clarke, setup),
+    cmocka_unit_test_setup(test_case_park, setup),
+    cmocka_unit_test_setup(test_case_inv_park, setup),
+    cmocka_unit_test_setup(test_case_foc, setup),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,301 @@
+/****************************************************************************
+ * apps/testing/industry/mbcrc/mbcrc_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <setjmp.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "industry/mbcrc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MBCRC_ITER CONFIG_TESTING_MBCRC_ITER
+
+/* Random buffers are longer than a Modbus RTU frame, with room to move
+ * the start. The whole buffer is long enough to fold the LRC lanes twice.
+ */
+
+#define MBCRC_BUF_LEN 1024
+#define MBCRC_LEN_MAX 256
+#define MBCRC_OFF_MAX 8
+
+/* Fixed seed so that runs are reproducible, may be changed with argv[1] */
+
+#define MBCRC_SEED    0x2545f491
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Byte-wise CRC16 table the Modbus stacks used before the library */
+
+static const uint16_t g_mbcrc_ref_table[256] =
+{
+  0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241, 0xc601,
+  0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440, 0xcc01, 0x0cc0,
+  0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40, 0x0a00, 0xcac1, 0xcb81,
+  0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841, 0xd801, 0x18c0, 0x1980, 0xd941,
+  0x1b00, 0xdbc1, 0xda81, 0x1a40, 0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01,
+  0x1dc0, 0x1c80, 0xdc41, 0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0,
+  0x1680, 0xd641, 0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081,
+  0x1040, 0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
+  0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441, 0x3c00,
+  0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41, 0xfa01, 0x3ac0,
+  0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840, 0x2800, 0xe8c1, 0xe981,
+  0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41, 0xee01, 0x2ec0, 0x2f80, 0xef41,
+  0x2d00, 0xedc1, 0xec81, 0x2c40, 0xe401, 0x24c0, 0x2580, 0xe541, 0x2700,
+  0xe7c1, 0xe681, 0x2640, 0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0,
+  0x2080, 0xe041, 0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281,
+  0x6240, 0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
+  0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41, 0xaa01,
+  0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840, 0x7800, 0xb8c1,
+  0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41, 0xbe01, 0x7ec0, 0x7f80,
+  0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40, 0xb401, 0x74c0, 0x7580, 0xb541,
+  0x7700, 0xb7c1, 0xb681, 0x7640, 0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101,
+  0x71c0, 0x7080, 0xb041, 0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0,
+  0x5280, 0x9241, 0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481,
+  0x5440, 0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
+  0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841, 0x8801,
+  0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40, 0x4e00, 0x8ec1,
+  0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41, 0x4400, 0x84c1, 0x8581,
+  0x4540, 0x8701, 0x47c0, 0x4680, 0x8641, 0x8201, 0x42c0, 0x4380, 0x8341,
+  0x4100, 0x81c1, 0x8081, 0x4040
+};
+
+static uint8_t g_mbcrc_buf[MBCRC_BUF_LEN];
+static unsigned int g_mbcrc_seed = MBCRC_SEED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mbcrc_fill
+ ****************************************************************************/
+
+static void mbcrc_fill(void)
+{
+  int i = 0;
+
+  for (i = 0; i < MBCRC_BUF_LEN; i++)
+    {
+      g_mbcrc_buf[i] = (uint8_t)rand();
+    }
+}
+
+/****************************************************************************
+ * Name: mbcrc_ref_crc16
+ ****************************************************************************/
+
+static uint16_t mbcrc_ref_crc16(FAR const uint8_t *buf, size_t len)
+{
+  uint16_t crc = MBCRC_CRC16_INIT;
+
+  while (len-- > 0)
+    {
+      crc = (crc >> 8) ^ g_mbcrc_ref_table[(crc ^ *buf++) & 0xff];
+    }
+
+  return crc;
+}
+
+/****************************************************************************
+ * Name: mbcrc_ref_lrc
+ ****************************************************************************/
+
+static uint8_t mbcrc_ref_lrc(FAR const uint8_t *buf, size_t len)
+{
+  uint8_t lrc = 0;
+
+  while (len-- > 0)
+    {
+      lrc += *buf++;
+    }
+
+  return (uint8_t)(-((int8_t)lrc));
+}
+
+/****************************************************************************
+ * Name: mbcrc_test_setup
+ ****************************************************************************/
+
+static int mbcrc_test_setup(FAR void **state)
+{
+  printf("mbcrc: seed=%u\n", g_mbcrc_seed);
+  srand(g_mbcrc_seed);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mbcrc_test_frames
+ *
+ * Description:
+ *   Known Modbus frames and the CRC of a frame with its own CRC appended
+ *
+ ****************************************************************************/
+
+static void mbcrc_test_frames(FAR void **state)
+{
+  uint8_t  req[8] =
+  {
+    0x01, 0x03, 0x00, 0x00, 0x00, 0x0a
+  };
+
+  uint16_t crc = 0;
+
+  crc = mbcrc_crc16(req, 6);
+  assert_int_equal(crc, 0xcdc5);
+
+  req[6] = crc & 0xff;
+  req[7] = crc >> 8;
+  assert_int_equal(mbcrc_crc16(req, 8), 0);
+
+  assert_int_equal(mbcrc_lrc(req, 6), 0xf2);
+
+  assert_int_equal(mbcrc_crc16(NULL, 0), MBCRC_CRC16_INIT);
+  assert_int_equal(mbcrc_crc16(req, 0), MBCRC_CRC16_INIT);
+  assert_int_equal(mbcrc_lrc(req, 0), 0);
+}
+
+/****************************************************************************
+ * Name: mbcrc_test_crc16
+ *
+ * Description:
+ *   Random lengths at random alignments, so every tail length and both
+ *   table step sizes are covered
+ *
+ ****************************************************************************/
+
+static void mbcrc_test_crc16(FAR void **state)
+{
+  FAR const uint8_t *buf = NULL;
+  size_t             len = 0;
+  int                i   = 0;
+
+  for (i = 0; i < MBCRC_ITER; i++)
+    {
+      mbcrc_fill();
+
+      buf = &g_mbcrc_buf[rand() % MBCRC_OFF_MAX];
+      len = rand() % (MBCRC_LEN_MAX + 1);
+
+      assert_int_equal(mbcrc_crc16(buf, len), mbcrc_ref_crc16(buf, len));
+    }
+}
+
+/****************************************************************************
+ * Name: mbcrc_test_crc16_part
+ ****************************************************************************/
+
+static void mbcrc_test_crc16_part(FAR void **state)
+{
+  FAR const uint8_t *buf   = NULL;
+  size_t             len   = 0;
+  size_t             split = 0;
+  uint16_t           crc   = 0;
+  int                i     = 0;
+
+  for (i = 0; i < MBCRC_ITER; i++)
+    {
+      mbcrc_fill();
+
+      buf   = &g_mbcrc_buf[rand() % MBCRC_OFF_MAX];
+      len   = rand() % (MBCRC_LEN_MAX + 1);
+      split = rand() % (len + 1);
+
+      crc = mbcrc_crc16_part(buf, split, MBCRC_CRC16_INIT);
+      crc = mbcrc_crc16_part(buf + split, len - split, crc);
+
+      assert_int_equal(crc, mbcrc_ref_crc16(buf, len));
+    }
+}
+
+/****************************************************************************
+ * Name: mbcrc_test_lrc
+ *
+ * Description:
+ *   Random buffers and all lengths of a buffer of 0xff, which is the worst
+ *   case for the summation lanes
+ *
+ ****************************************************************************/
+
+static void mbcrc_test_lrc(FAR void **state)
+{
+  FAR const uint8_t *buf = NULL;
+  size_t             len = 0;
+  int                i   = 0;
+
+  for (i = 0; i < MBCRC_ITER; i++)
+    {
+      mbcrc_fill();
+
+      buf = &g_mbcrc_buf[rand() % MBCRC_OFF_MAX];
+      len = rand() % (MBCRC_LEN_MAX + 1);
+
+      assert_int_equal(mbcrc_lrc(buf, len), mbcrc_ref_lrc(buf, len));
+    }
+
+  memset(g_mbcrc_buf, 0xff, MBCRC_BUF_LEN);
+
+  for (len = 0; len <= MBCRC_BUF_LEN; len++)
+    {
+      assert_int_equal(mbcrc_lrc(g_mbcrc_buf, len),
+                       mbcrc_ref_lrc(g_mbcrc_buf, len));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * mbcrc_main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  const struct CMUnitTest tests[] =
+  {
+    cmocka_unit_test(mbcrc_test_frames),
+    cmocka_unit_test(mbcrc_test_crc16),
+    cmocka_unit_test(mbcrc_test_crc16_part),
+    cmocka_unit_test(mbcrc_test_lrc),
+  };
+
+  if (argc > 1)
+    {
+      g_mbcrc_seed = (unsigned int)strtoul(argv[1], NULL, 0);
+    }
+
+  return cmocka_run_group_tests(tests, mbcrc_test_setup, NULL);
+}